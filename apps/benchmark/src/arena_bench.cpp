@@ -0,0 +1,117 @@
+// Message allocation cost with and without the per-receive MessageArena.
+//
+// Runs the same message-heavy program — two number streams composed into a
+// VectorNumberData, projected, extracted and fed to a PeakDetector — twice:
+// with the default Message<T> pool and with "messageArena": true. Each
+// program is driven both one message per receive() and in receive_batch()
+// bursts. Outputs are checksummed so the two allocators can be compared for
+// equality.
+//
+// Usage: arena_bench [messages] [burst]
+// Output columns: allocator,mode,messages,total_ms,ns_per_msg,checksum.
+// Run with `bazel run -c opt //apps/benchmark:arena_bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtbot/Program.h"
+
+using namespace rtbot;
+
+namespace {
+
+std::string program_json(bool arena) {
+  return std::string(R"({
+    "messageArena": )") +
+         (arena ? "true" : "false") + R"(,
+    "entryOperator": "in",
+    "output": { "out": ["o1", "o2"] },
+    "operators": [
+      {"id": "in", "type": "Input", "portTypes": ["number", "number"]},
+      {"id": "vc", "type": "VectorCompose", "numPorts": 2},
+      {"id": "vp", "type": "VectorProject", "indices": [1, 0]},
+      {"id": "vx", "type": "VectorExtract", "index": 0},
+      {"id": "peak", "type": "PeakDetector", "window_size": 5},
+      {"id": "out", "type": "Output", "portTypes": ["vector_number", "number"]}
+    ],
+    "connections": [
+      {"from": "in", "to": "vc", "fromPort": "o1", "toPort": "i1"},
+      {"from": "in", "to": "vc", "fromPort": "o2", "toPort": "i2"},
+      {"from": "vc", "to": "vp", "fromPort": "o1", "toPort": "i1"},
+      {"from": "vp", "to": "vx", "fromPort": "o1", "toPort": "i1"},
+      {"from": "vx", "to": "peak", "fromPort": "o1", "toPort": "i1"},
+      {"from": "vp", "to": "out", "fromPort": "o1", "toPort": "i1"},
+      {"from": "peak", "to": "out", "fromPort": "o1", "toPort": "i2"}
+    ]
+  })";
+}
+
+double value_at(size_t i, int port) { return std::sin(0.05 * static_cast<double>(i) + port) * 100.0; }
+
+double digest(ProgramMsgBatch& batch, double acc) {
+  for (auto& msg : batch["out"]["o1"]) {
+    const auto& v = static_cast<const Message<VectorNumberData>*>(msg.get())->data;
+    for (size_t i = 0; i < v.size(); ++i) acc = acc * 1.0000001 + v[i];
+  }
+  for (auto& msg : batch["out"]["o2"]) {
+    acc = acc * 1.0000001 + static_cast<const Message<NumberData>*>(msg.get())->data.value;
+  }
+  return acc;
+}
+
+double run_single(bool arena, size_t messages, double& hash) {
+  Program program(program_json(arena));
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < messages; ++i) {
+    const auto t = static_cast<timestamp_t>(i + 1);
+    auto a = program.receive(create_message<NumberData>(t, NumberData{value_at(i, 0)}), "i1");
+    auto b = program.receive(create_message<NumberData>(t, NumberData{value_at(i, 1)}), "i2");
+    hash = digest(b, digest(a, hash));
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+double run_batch(bool arena, size_t messages, size_t burst, double& hash) {
+  Program program(program_json(arena));
+  double ms = 0.0;
+  for (size_t base = 0; base < messages; base += burst) {
+    std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>> batch;
+    const size_t end = std::min(messages, base + burst);
+    for (size_t i = base; i < end; ++i) {
+      const auto t = static_cast<timestamp_t>(i + 1);
+      batch["i1"].push_back(create_message<NumberData>(t, NumberData{value_at(i, 0)}));
+      batch["i2"].push_back(create_message<NumberData>(t, NumberData{value_at(i, 1)}));
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    auto out = program.receive_batch(batch);
+    hash = digest(out, hash);
+    ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  }
+  return ms;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  const size_t burst = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2048;
+
+  std::printf("allocator,mode,messages,total_ms,ns_per_msg,checksum\n");
+  for (bool arena : {false, true}) {
+    const char* name = arena ? "arena" : "pool";
+    double hash = 0;
+    double ms = run_single(arena, messages, hash);
+    std::printf("%s,receive,%zu,%.1f,%.1f,%.17g\n", name, messages, ms, ms * 1e6 / messages, hash);
+    hash = 0;
+    ms = run_batch(arena, messages, burst, hash);
+    std::printf("%s,receive_batch,%zu,%.1f,%.1f,%.17g\n", name, messages, ms, ms * 1e6 / messages, hash);
+  }
+  return 0;
+}
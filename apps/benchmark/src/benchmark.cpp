@@ -208,6 +208,21 @@ class BollingerBandsBenchmark {
     return {total_time_ns, messages_per_second};
   }
 
+  // Streams one message per receive() with the Program's latency histograms
+  // on and prints their percentiles. Per-operator timing adds two clock reads
+  // per execute, so it is a separate run from the receive-only one.
+  void print_latency(size_t data_size, bool per_operator) {
+    auto prices = SignalGenerator::generate_random_walk(data_size);
+    rtbot::Program program(program_json_);
+    program.set_receive_latency(true);
+    if (per_operator) program.set_profiling(true, true);
+
+    for (size_t i = 0; i < data_size; ++i) {
+      program.receive(Message<NumberData>(i, NumberData{prices[i]}));
+    }
+    program.print_latency(std::cout);
+  }
+
  private:
   std::string program_json_;
 };
@@ -383,6 +398,11 @@ int main() {
   results2.add_result("Bollinger Pure", kSize, std::move(pure_times));
   results2.add_result("PPG Pipeline", kSize, std::move(ppg_times));
   results2.print_results();
+
+  std::cout << "\n=== Per-message latency, Bollinger Program @ " << kSize << " messages ===\n\n";
+  bollinger_benchmark.print_latency(kSize, false);
+  std::cout << "\n--- with per-operator execute latency ---\n\n";
+  bollinger_benchmark.print_latency(kSize, true);
 #endif
 
 #ifdef RTBOT_PERF
@@ -0,0 +1,106 @@
+// Backfill throughput through the columnar (MessageBatch) operator paths.
+//
+// Pushes a long price series through Program::receive_batch in large bursts,
+// the historical-backfill pattern, over a chain of scalar std operators that
+// run columnar kernels: Scale -> Add -> MovingAverage -> Difference ->
+// CumulativeSum -> GreaterThan (filter) and Linear over two branches. Prints
+// rows/s and an order-sensitive checksum of the outputs so runs of different
+// builds can be compared for equality.
+//
+// Usage: columnar_bench [rows] [burst]
+// Output columns: rows,burst,total_ms,rows_per_s,outputs,checksum.
+// Run with `bazel run -c opt //apps/benchmark:columnar_bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rtbot/Program.h"
+
+using namespace rtbot;
+
+namespace {
+
+const char* kBackfillJson = R"({
+  "entryOperator": "in",
+  "output": { "out": ["o1", "o2"] },
+  "operators": [
+    {"id": "in", "type": "Input", "portTypes": ["number"]},
+    {"id": "scale", "type": "Scale", "value": 0.5},
+    {"id": "add", "type": "Add", "value": -50.0},
+    {"id": "ma", "type": "MovingAverage", "window_size": 32},
+    {"id": "diff", "type": "Difference"},
+    {"id": "cumsum", "type": "CumulativeSum"},
+    {"id": "gt", "type": "GreaterThan", "value": 0.0},
+    {"id": "lin", "type": "Linear", "coefficients": [0.25, 0.75]},
+    {"id": "out", "type": "Output", "portTypes": ["number", "number"]}
+  ],
+  "connections": [
+    {"from": "in", "to": "scale", "fromPort": "o1", "toPort": "i1"},
+    {"from": "scale", "to": "add", "fromPort": "o1", "toPort": "i1"},
+    {"from": "add", "to": "ma", "fromPort": "o1", "toPort": "i1"},
+    {"from": "ma", "to": "diff", "fromPort": "o1", "toPort": "i1"},
+    {"from": "diff", "to": "cumsum", "fromPort": "o1", "toPort": "i1"},
+    {"from": "cumsum", "to": "gt", "fromPort": "o1", "toPort": "i1"},
+    {"from": "ma", "to": "lin", "fromPort": "o1", "toPort": "i1"},
+    {"from": "add", "to": "lin", "fromPort": "o1", "toPort": "i2"},
+    {"from": "gt", "to": "out", "fromPort": "o1", "toPort": "i1"},
+    {"from": "lin", "to": "out", "fromPort": "o1", "toPort": "i2"}
+  ]
+})";
+
+std::vector<double> random_walk(size_t n) {
+  std::mt19937 gen(42);
+  std::normal_distribution<> d(0, 1);
+  std::vector<double> out(n);
+  double p = 100.0;
+  for (auto& v : out) {
+    p += d(gen);
+    v = p;
+  }
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+  const size_t burst = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+
+  const auto prices = random_walk(rows);
+  Program program(kBackfillJson);
+
+  size_t outputs = 0;
+  double checksum = 0.0;
+  double total_ms = 0.0;
+  for (size_t base = 0; base < rows; base += burst) {
+    std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>> batch;
+    auto& msgs = batch["i1"];
+    const size_t end = std::min(rows, base + burst);
+    msgs.reserve(end - base);
+    for (size_t i = base; i < end; ++i) {
+      msgs.push_back(create_message<NumberData>(static_cast<timestamp_t>(i + 1), NumberData{prices[i]}));
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto out = program.receive_batch(batch);
+    total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    for (const char* port : {"o1", "o2"}) {
+      for (auto& msg : out["out"][port]) {
+        checksum = checksum * 1.0000001 + static_cast<const Message<NumberData>*>(msg.get())->data.value;
+        ++outputs;
+      }
+    }
+  }
+
+  std::printf("rows,burst,total_ms,rows_per_s,outputs,checksum\n");
+  std::printf("%zu,%zu,%.1f,%.0f,%zu,%.17g\n", rows, burst, total_ms, rows / total_ms * 1e3, outputs, checksum);
+  return 0;
+}
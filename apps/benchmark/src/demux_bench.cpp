@@ -0,0 +1,89 @@
+// Emission cost versus output port count.
+//
+// Two operators with N output ports, every port wired to its own Collector:
+//   - Demultiplexer: one-hot controls route each message to a single port.
+//   - Input:         N number ports, messages arrive on port 0 only.
+// In both cases one edge out of N carries the message, so with per-port edge
+// lists emit_output should stay flat as N grows; any remaining growth comes
+// from the operator itself (the Demultiplexer syncs N control queues).
+//
+// Usage: demux_bench [messages]
+// Output columns: operator,ports,messages,total_ms,ns_per_msg.
+// Run with `bazel run -c opt //apps/benchmark:demux_bench`.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/Demultiplexer.h"
+#include "rtbot/Input.h"
+
+using namespace rtbot;
+
+namespace {
+
+constexpr size_t kChunk = 256;
+
+std::vector<std::shared_ptr<Collector>> attach_collectors(Operator& op, size_t ports) {
+  std::vector<std::shared_ptr<Collector>> cols;
+  for (size_t p = 0; p < ports; ++p) {
+    cols.push_back(std::make_shared<Collector>("c" + std::to_string(p), std::vector<std::string>{"number"}));
+    op.connect(cols.back(), p, 0);
+  }
+  return cols;
+}
+
+double run_demux(size_t ports, size_t messages) {
+  auto demux = std::make_shared<Demultiplexer<NumberData>>("demux", ports);
+  auto cols = attach_collectors(*demux, ports);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t base = 1; base <= messages; base += kChunk) {
+    for (size_t t = base; t < base + kChunk && t <= messages; ++t) {
+      const size_t hot = t % ports;
+      for (size_t p = 0; p < ports; ++p) {
+        demux->receive_control(create_message<BooleanData>(t, BooleanData{p == hot}), p);
+      }
+      demux->receive_data(create_message<NumberData>(t, NumberData{static_cast<double>(t)}), 0);
+    }
+    demux->execute();
+    for (auto& c : cols) c->reset();
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+double run_input(size_t ports, size_t messages) {
+  auto input = std::make_shared<Input>("in", std::vector<std::string>(ports, PortType::NUMBER));
+  auto cols = attach_collectors(*input, ports);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t base = 1; base <= messages; base += kChunk) {
+    for (size_t t = base; t < base + kChunk && t <= messages; ++t) {
+      input->receive_data(create_message<NumberData>(t, NumberData{static_cast<double>(t)}), 0);
+      input->execute();
+    }
+    cols[0]->reset();
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+  std::printf("operator,ports,messages,total_ms,ns_per_msg\n");
+  for (size_t ports : {2, 4, 8, 16, 32, 64}) {
+    const double ms = run_demux(ports, messages);
+    std::printf("Demultiplexer,%zu,%zu,%.1f,%.1f\n", ports, messages, ms, ms * 1e6 / messages);
+  }
+  for (size_t ports : {2, 4, 8, 16, 32, 64}) {
+    const double ms = run_input(ports, messages);
+    std::printf("Input,%zu,%zu,%.1f,%.1f\n", ports, messages, ms, ms * 1e6 / messages);
+  }
+  return 0;
+}
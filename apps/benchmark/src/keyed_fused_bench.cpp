@@ -0,0 +1,107 @@
+// Grouped moving aggregates: KeyedPipeline over a FusedExpressionVector
+// prototype against KeyedFusedExpression running the same bytecode.
+//
+// Every row updates its key's MA(16), moving std-dev(16) and running sum.
+// Both operators see the same rows and their outputs (times and values, in
+// order) must match. The KeyedFusedExpression run goes first, because freed
+// heap is not always returned to the OS; RSS is read from /proc/self/statm
+// (Linux) after each run, with the operator still alive.
+//
+// Usage: keyed_fused_bench [keys] [rows]
+// Output columns: operator,keys,rows,ms,rows_per_s,rss_mb.
+// Run with `bazel run -c opt //apps/benchmark:keyed_fused_bench`.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/OperatorJson.h"
+#include "rtbot/fuse/KeyedFusedExpression.h"
+
+using namespace rtbot;
+
+namespace {
+
+// [MA(x, 16), STD(x, 16), CUMSUM(x)] over column 1.
+const std::vector<double> kProgram = {0, 1, 35, 16, 20, 0, 1, 37, 16, 20, 0, 1, 21, 0, 20};
+
+const char* kKeyedPipelineJson = R"({
+  "type": "KeyedPipeline", "id": "keyed", "key_index": 0,
+  "prototype": {
+    "operators": [
+      {"type": "FusedExpressionVector", "id": "fev", "numOutputs": 3,
+       "bytecode": [0, 1, 35, 16, 20, 0, 1, 37, 16, 20, 0, 1, 21, 0, 20]}
+    ],
+    "connections": [],
+    "entry": {"operator": "fev"},
+    "output": {"operator": "fev"}
+  }
+})";
+
+double rss_mb() {
+  std::ifstream statm("/proc/self/statm");
+  size_t pages = 0, resident = 0;
+  statm >> pages >> resident;
+  return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+std::vector<double> make_keys(size_t keys, size_t rows) {
+  std::mt19937_64 rng(5);
+  std::uniform_int_distribution<size_t> key(0, keys - 1);
+  std::vector<double> out(rows);
+  for (auto& k : out) k = static_cast<double>(key(rng));
+  return out;
+}
+
+// Returns the emitted (time, values...) rows.
+std::vector<double> run(const char* name, std::shared_ptr<Operator> op, size_t keys,
+                        const std::vector<double>& key_stream) {
+  auto sink = std::make_shared<Collector>("sink", std::vector<std::string>{"vector_number"});
+  op->connect(sink, 0, 0);
+
+  std::vector<double> out;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < key_stream.size(); ++i) {
+    const double key = key_stream[i];
+    op->receive_data(create_message<VectorNumberData>(static_cast<timestamp_t>(i + 1),
+                                                      VectorNumberData({key, static_cast<double>(i % 97) * 0.5})),
+                     0);
+    op->execute();
+    auto& queue = sink->get_data_queue(0);
+    for (const auto& msg : queue) {
+      const auto* vec = static_cast<const Message<VectorNumberData>*>(msg.get());
+      out.push_back(static_cast<double>(vec->time));
+      for (size_t j = 0; j < vec->data.size(); ++j) out.push_back(vec->data[j]);
+    }
+    queue.clear();
+  }
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  const double rows = static_cast<double>(key_stream.size());
+  std::printf("%s,%zu,%.0f,%.1f,%.0f,%.1f\n", name, keys, rows, ms, rows / ms * 1e3, rss_mb());
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  const size_t rows = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000000;
+  const auto key_stream = make_keys(keys, rows);
+
+  std::printf("operator,keys,rows,ms,rows_per_s,rss_mb\n");
+  const auto fused = run("KeyedFusedExpression", make_keyed_fused_expression("keyed", 0, 3, kProgram, {}), keys,
+                         key_stream);
+  const auto pipeline = run("KeyedPipeline", OperatorJson::read_op(kKeyedPipelineJson), keys, key_stream);
+  if (fused != pipeline) {
+    std::fprintf(stderr, "KeyedFusedExpression diverges from KeyedPipeline\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,126 @@
+// New-key creation throughput in KeyedPipeline: a storm of rows that each
+// carry a key never seen before, so every row builds a sub-graph.
+//
+// "compiled" is the KeyedPipeline read from JSON, whose factory clones the
+// compiled prototype. "json" rebuilds the previous factory, which re-read
+// every prototype operator from its JSON text for each new key. Both see the
+// same rows and their outputs are checked against each other.
+//
+// Usage: keyed_key_bench [keys] [reps]
+// Output columns: factory,keys,ms,ns_per_key,keys_per_s.
+// Run with `bazel run -c opt //apps/benchmark:keyed_key_bench`.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "rtbot/Collector.h"
+#include "rtbot/OperatorJson.h"
+
+using namespace rtbot;
+
+namespace {
+
+const char* kKeyedJson = R"({
+  "type": "KeyedPipeline", "id": "keyed", "key_index": 0,
+  "prototype": {
+    "operators": [
+      {"type": "VectorExtract", "id": "ext", "index": 1},
+      {"type": "MovingAverage", "id": "ma", "window_size": 20},
+      {"type": "StandardDeviation", "id": "sd", "window_size": 20},
+      {"type": "Subtraction", "id": "sub"},
+      {"type": "Scale", "id": "scale", "value": 0.5},
+      {"type": "VectorCompose", "id": "out", "numPorts": 2}
+    ],
+    "connections": [
+      {"from": "ext", "to": "ma", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ext", "to": "sd", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ma", "to": "sub", "fromPort": "o1", "toPort": "i1"},
+      {"from": "sd", "to": "sub", "fromPort": "o1", "toPort": "i2"},
+      {"from": "sub", "to": "scale", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ext", "to": "out", "fromPort": "o1", "toPort": "i1"},
+      {"from": "scale", "to": "out", "fromPort": "o1", "toPort": "i2"}
+    ],
+    "entry": {"operator": "ext"},
+    "output": {"operator": "out"}
+  }
+})";
+
+// The factory OperatorJson used to build: JSON text in, operators out, for
+// every new key.
+std::shared_ptr<KeyedPipeline> json_factory_pipeline() {
+  const auto parsed = json::parse(kKeyedJson);
+  const auto& proto = parsed["prototype"];
+  json ops = proto["operators"];
+  json conns = proto["connections"];
+  std::string entry = proto["entry"]["operator"].get<std::string>();
+  std::string output = proto["output"]["operator"].get<std::string>();
+  auto factory = [ops, conns, entry, output]() -> SubGraph {
+    SubGraph sg;
+    for (const auto& op_json : ops) {
+      auto op = OperatorJson::read_op(op_json.dump());
+      sg.operators[op->id()] = op;
+    }
+    for (const auto& conn : conns) {
+      auto from = OperatorJson::parse_port_name(conn["fromPort"].get<std::string>());
+      auto to = OperatorJson::parse_port_name(conn["toPort"].get<std::string>());
+      sg.operators[conn["from"].get<std::string>()]->connect(sg.operators[conn["to"].get<std::string>()], from.index,
+                                                             to.index, to.kind);
+    }
+    sg.entry = sg.operators[entry];
+    sg.output = sg.operators[output];
+    return sg;
+  };
+  return make_keyed_pipeline("keyed", 0, factory);
+}
+
+// Feeds `keys` rows with distinct keys; returns the elapsed ms and the sum of
+// the emitted values as a checksum.
+double run(const std::shared_ptr<Operator>& keyed, size_t keys, double& checksum) {
+  auto sink = std::make_shared<Collector>("sink", std::vector<std::string>{"vector_number"});
+  keyed->connect(sink, 0, 0);
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < keys; ++k) {
+    const double key = static_cast<double>(k);
+    keyed->receive_data(
+        create_message<VectorNumberData>(static_cast<timestamp_t>(k + 1), VectorNumberData({key, 0.25 * key})), 0);
+    keyed->execute();
+    auto& out = sink->get_data_queue(0);
+    while (!out.empty()) {
+      const auto* msg = static_cast<const Message<VectorNumberData>*>(out.front().get());
+      for (size_t i = 0; i < msg->data.size(); ++i) checksum += msg->data[i];
+      out.pop_front();
+    }
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  const int reps = argc > 2 ? std::atoi(argv[2]) : 3;
+
+  std::printf("factory,keys,ms,ns_per_key,keys_per_s\n");
+  double checksums[2] = {0.0, 0.0};
+  const char* names[2] = {"json", "compiled"};
+  for (int mode = 0; mode < 2; ++mode) {
+    double best = 0.0;
+    for (int i = 0; i < reps; ++i) {
+      std::shared_ptr<Operator> keyed =
+          mode == 0 ? std::static_pointer_cast<Operator>(json_factory_pipeline()) : OperatorJson::read_op(kKeyedJson);
+      double checksum = 0.0;
+      const double ms = run(keyed, keys, checksum);
+      if (i == 0 || ms < best) best = ms;
+      checksums[mode] = checksum;
+    }
+    std::printf("%s,%zu,%.2f,%.1f,%.0f\n", names[mode], keys, best, best * 1e6 / keys, keys / (best / 1000.0));
+  }
+  if (checksums[0] != checksums[1]) {
+    std::fprintf(stderr, "compiled prototype diverges from the json factory\n");
+    return 1;
+  }
+  return 0;
+}
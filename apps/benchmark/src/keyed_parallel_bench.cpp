@@ -0,0 +1,127 @@
+// Parallel per-key execution in KeyedPipeline: bursts of rows spread over
+// many symbols, run serially and with set_threads(t) for t = 2..N.
+//
+// Every row goes through a rolling mean / standard deviation z-score
+// sub-graph of its symbol. Each run sees the same bursts, and the parallel
+// outputs (times and values, in order) are checked against the serial ones.
+//
+// Usage: keyed_parallel_bench [max_threads] [symbols] [bursts] [burst_rows]
+// Output columns: threads,symbols,rows,ms,rows_per_s,speedup.
+// Run with `bazel run -c opt //apps/benchmark:keyed_parallel_bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/OperatorJson.h"
+
+using namespace rtbot;
+
+namespace {
+
+const char* kKeyedJson = R"({
+  "type": "KeyedPipeline", "id": "keyed", "key_index": 0,
+  "prototype": {
+    "operators": [
+      {"type": "VectorExtract", "id": "ext", "index": 1},
+      {"type": "MovingAverage", "id": "ma", "window_size": 64},
+      {"type": "StandardDeviation", "id": "sd", "window_size": 64},
+      {"type": "Subtraction", "id": "dev"},
+      {"type": "Division", "id": "z"}
+    ],
+    "connections": [
+      {"from": "ext", "to": "ma", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ext", "to": "sd", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ext", "to": "dev", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ma", "to": "dev", "fromPort": "o1", "toPort": "i2"},
+      {"from": "dev", "to": "z", "fromPort": "o1", "toPort": "i1"},
+      {"from": "sd", "to": "z", "fromPort": "o1", "toPort": "i2"}
+    ],
+    "entry": {"operator": "ext"},
+    "output": {"operator": "z"}
+  }
+})";
+
+struct Row {
+  timestamp_t time;
+  double symbol;
+  double price;
+};
+
+std::vector<std::vector<Row>> make_bursts(size_t symbols, size_t bursts, size_t burst_rows) {
+  std::mt19937_64 rng(3);
+  std::uniform_int_distribution<size_t> symbol(0, symbols - 1);
+  std::normal_distribution<double> step(0.0, 0.01);
+  std::vector<double> price(symbols, 100.0);
+  std::vector<std::vector<Row>> out(bursts);
+  timestamp_t t = 0;
+  for (auto& burst : out) {
+    for (size_t i = 0; i < burst_rows; ++i) {
+      const size_t s = symbol(rng);
+      price[s] += step(rng);
+      burst.push_back({++t, static_cast<double>(s), price[s]});
+    }
+  }
+  return out;
+}
+
+// Feeds every burst, one execute() per burst; returns the elapsed ms and
+// appends the emitted (time, value...) rows to `out`.
+double run(size_t threads, const std::vector<std::vector<Row>>& bursts, std::vector<double>& out) {
+  auto keyed = std::dynamic_pointer_cast<KeyedPipeline>(OperatorJson::read_op(kKeyedJson));
+  keyed->set_threads(threads);
+  auto sink = std::make_shared<Collector>("sink", std::vector<std::string>{"vector_number"});
+  keyed->connect(sink, 0, 0);
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (const auto& burst : bursts) {
+    for (const auto& row : burst) {
+      keyed->receive_data(create_message<VectorNumberData>(row.time, VectorNumberData({row.symbol, row.price})), 0);
+    }
+    keyed->execute();
+    auto& queue = sink->get_data_queue(0);
+    for (const auto& msg : queue) {
+      const auto* vec = static_cast<const Message<VectorNumberData>*>(msg.get());
+      out.push_back(static_cast<double>(vec->time));
+      for (size_t i = 0; i < vec->data.size(); ++i) out.push_back(vec->data[i]);
+    }
+    queue.clear();
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  const size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : hw;
+  const size_t symbols = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5000;
+  const size_t num_bursts = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 200;
+  const size_t burst_rows = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 20000;
+
+  const auto bursts = make_bursts(symbols, num_bursts, burst_rows);
+  const double rows = static_cast<double>(num_bursts * burst_rows);
+
+  std::printf("threads,symbols,rows,ms,rows_per_s,speedup\n");
+  std::vector<double> serial_out;
+  const double serial_ms = run(1, bursts, serial_out);
+  std::printf("1,%zu,%.0f,%.1f,%.0f,1.00\n", symbols, rows, serial_ms, rows / serial_ms * 1e3);
+
+  for (size_t t = 2; t <= max_threads; t = (t < 4 ? t + 1 : t * 2)) {
+    std::vector<double> out;
+    const double ms = run(t, bursts, out);
+    std::printf("%zu,%zu,%.0f,%.1f,%.0f,%.2f\n", t, symbols, rows, ms, rows / ms * 1e3, serial_ms / ms);
+    if (out != serial_out) {
+      std::fprintf(stderr, "threads=%zu diverges from serial mode\n", t);
+      return 1;
+    }
+  }
+  return 0;
+}
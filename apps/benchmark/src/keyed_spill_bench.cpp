@@ -0,0 +1,124 @@
+// Cold-key tier in KeyedPipeline: throughput and resident memory with a
+// skewed key stream over many keys, for several hot-set sizes against
+// keeping every key in memory.
+//
+// Keys are drawn as floor(keys * u^3), so a small set of keys takes most of
+// the rows, as with per-user state. Every configuration sees the same rows
+// and its outputs are checked against the all-in-memory run. Configurations
+// run smallest hot set first, because freed heap is not always returned to
+// the OS; RSS is read from /proc/self/statm (Linux) after each run, with the
+// pipeline still alive.
+//
+// Usage: keyed_spill_bench [keys] [rows] [spill_dir]
+// Output columns: hot_keys,keys,rows,ms,rows_per_s,hit_rate,spilled_mb,rss_mb.
+// Run with `bazel run -c opt //apps/benchmark:keyed_spill_bench`.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/OperatorJson.h"
+
+using namespace rtbot;
+
+namespace {
+
+const char* kKeyedJson = R"({
+  "type": "KeyedPipeline", "id": "keyed", "key_index": 0,
+  "prototype": {
+    "operators": [
+      {"type": "VectorExtract", "id": "ext", "index": 1},
+      {"type": "MovingAverage", "id": "ma", "window_size": 16},
+      {"type": "CumulativeSum", "id": "sum"},
+      {"type": "VectorCompose", "id": "out", "numPorts": 2}
+    ],
+    "connections": [
+      {"from": "ext", "to": "ma", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ext", "to": "sum", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ma", "to": "out", "fromPort": "o1", "toPort": "i1"},
+      {"from": "sum", "to": "out", "fromPort": "o1", "toPort": "i2"}
+    ],
+    "entry": {"operator": "ext"},
+    "output": {"operator": "out"}
+  }
+})";
+
+double rss_mb() {
+  std::ifstream statm("/proc/self/statm");
+  size_t pages = 0, resident = 0;
+  statm >> pages >> resident;
+  return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+std::vector<double> make_keys(size_t keys, size_t rows) {
+  std::mt19937_64 rng(9);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<double> out(rows);
+  for (auto& k : out) k = std::floor(static_cast<double>(keys) * std::pow(u(rng), 3.0));
+  return out;
+}
+
+// Returns the checksum of the emitted values.
+double run(size_t hot_keys, size_t keys, const std::vector<double>& key_stream, const std::string& dir) {
+  auto keyed = std::dynamic_pointer_cast<KeyedPipeline>(OperatorJson::read_op(kKeyedJson));
+  if (hot_keys > 0) keyed->set_spill(hot_keys, dir);
+  auto sink = std::make_shared<Collector>("sink", std::vector<std::string>{"vector_number"});
+  keyed->connect(sink, 0, 0);
+
+  double checksum = 0.0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < key_stream.size(); ++i) {
+    const double key = key_stream[i];
+    keyed->receive_data(create_message<VectorNumberData>(static_cast<timestamp_t>(i + 1),
+                                                         VectorNumberData({key, std::fmod(key * 0.37 + i, 10.0)})),
+                        0);
+    keyed->execute();
+    auto& queue = sink->get_data_queue(0);
+    for (const auto& msg : queue) {
+      const auto& data = static_cast<const Message<VectorNumberData>*>(msg.get())->data;
+      for (size_t j = 0; j < data.size(); ++j) checksum += data[j];
+    }
+    queue.clear();
+  }
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+  const auto& stats = keyed->spill_stats();
+  const double lookups = static_cast<double>(stats.hits + stats.misses);
+  const double hit_rate = hot_keys > 0 && lookups > 0 ? static_cast<double>(stats.hits) / lookups : 1.0;
+  const double spilled_mb =
+      keyed->spill_store() ? static_cast<double>(keyed->spill_store()->live_bytes()) / (1024.0 * 1024.0) : 0.0;
+  const double rows = static_cast<double>(key_stream.size());
+  std::printf("%zu,%zu,%.0f,%.1f,%.0f,%.3f,%.1f,%.1f\n", hot_keys, keys, rows, ms, rows / ms * 1e3, hit_rate,
+              spilled_mb, rss_mb());
+  return checksum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+  const size_t rows = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 3000000;
+  const std::string dir = argc > 3 ? argv[3] : "/tmp";
+
+  const auto key_stream = make_keys(keys, rows);
+  std::printf("hot_keys,keys,rows,ms,rows_per_s,hit_rate,spilled_mb,rss_mb\n");
+  const size_t hot_sets[] = {keys / 100, keys / 10, 0};
+  std::vector<double> checksums;
+  for (size_t hot : hot_sets) checksums.push_back(run(hot, keys, key_stream, dir));
+  const double reference = checksums.back();
+  for (double c : checksums) {
+    if (c != reference) {
+      std::fprintf(stderr, "spilled run diverges from the in-memory run\n");
+      return 1;
+    }
+  }
+  return 0;
+}
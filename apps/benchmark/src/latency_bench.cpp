@@ -0,0 +1,131 @@
+// Per-call latency distribution for a Program, with and without port queue
+// preallocation ("queueCapacity" in the program JSON).
+//
+// Throughput numbers in benchmark.cpp hide tail behaviour: a queue that grows
+// (or, with std::deque, frees and re-acquires a block) on one call in a
+// thousand barely moves the mean but dominates p99.9. This harness times every
+// receive() / receive_batch() call individually and prints percentiles.
+//
+// Two ingestion patterns are measured on the Bollinger Bands program:
+//   - chunk=1: one message per receive() (the streaming pattern)
+//   - burst:   kBurst messages per receive_batch() (upstream backlog)
+//
+// Output columns: mode,queue_capacity,calls,p50_ns,p99_ns,p999_ns,max_ns.
+// Run with `bazel run -c opt //apps/benchmark:latency_bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rtbot/Program.h"
+
+using namespace rtbot;
+
+namespace {
+
+constexpr size_t kMessages = 1000000;
+constexpr size_t kBurst = 256;
+
+const char* kBollingerJson = R"({
+  "title": "Bollinger Bands",
+  "apiVersion": "v1",
+  "entryOperator": "754",
+  "output": { "37": ["o2", "o1", "o3"] },
+  "operators": [
+      { "id": "37", "type": "Output", "portTypes": ["number", "number", "number"] },
+      { "id": "495", "type": "Subtraction" },
+      { "id": "861", "type": "Addition" },
+      { "id": "996", "type": "Scale", "value": 2 },
+      { "id": "865", "type": "StandardDeviation", "window_size": 14 },
+      { "id": "510", "type": "MovingAverage", "window_size": 14 },
+      { "id": "262", "type": "ResamplerHermite", "interval": 1 },
+      { "id": "754", "type": "Input", "portTypes": ["number"] }
+  ],
+  "connections": [
+      { "from": "510", "to": "37", "fromPort": "o1", "toPort": "i3" },
+      { "from": "495", "to": "37", "fromPort": "o1", "toPort": "i1" },
+      { "from": "861", "to": "37", "fromPort": "o1", "toPort": "i2" },
+      { "from": "996", "to": "495", "fromPort": "o1", "toPort": "i2" },
+      { "from": "510", "to": "495", "fromPort": "o1", "toPort": "i1" },
+      { "from": "996", "to": "861", "fromPort": "o1", "toPort": "i2" },
+      { "from": "510", "to": "861", "fromPort": "o1", "toPort": "i1" },
+      { "from": "865", "to": "996", "fromPort": "o1", "toPort": "i1" },
+      { "from": "262", "to": "865", "fromPort": "o1", "toPort": "i1" },
+      { "from": "262", "to": "510", "fromPort": "o1", "toPort": "i1" },
+      { "from": "754", "to": "262", "fromPort": "o1", "toPort": "i1" }
+  ]
+})";
+
+std::string with_queue_capacity(size_t capacity) {
+  auto j = json::parse(kBollingerJson);
+  if (capacity > 0) j["queueCapacity"] = capacity;
+  return j.dump();
+}
+
+std::vector<double> random_walk(size_t n) {
+  std::mt19937 gen(42);
+  std::normal_distribution<> d(0, 1);
+  std::vector<double> out(n);
+  double p = 100.0;
+  for (auto& v : out) {
+    p += d(gen);
+    v = p;
+  }
+  return out;
+}
+
+void report(const char* mode, size_t capacity, std::vector<double>& samples) {
+  std::sort(samples.begin(), samples.end());
+  auto pct = [&](double q) { return samples[static_cast<size_t>(q * (samples.size() - 1))]; };
+  std::printf("%s,%zu,%zu,%.0f,%.0f,%.0f,%.0f\n", mode, capacity, samples.size(), pct(0.5), pct(0.99), pct(0.999),
+              samples.back());
+}
+
+void run_chunk1(const std::vector<double>& prices, size_t capacity) {
+  Program program(with_queue_capacity(capacity));
+  std::vector<double> samples;
+  samples.reserve(prices.size());
+  for (size_t i = 0; i < prices.size(); ++i) {
+    auto t0 = std::chrono::steady_clock::now();
+    program.receive(Message<NumberData>(static_cast<timestamp_t>(i), NumberData{prices[i]}));
+    auto t1 = std::chrono::steady_clock::now();
+    samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+  }
+  report("chunk1", capacity, samples);
+}
+
+void run_burst(const std::vector<double>& prices, size_t capacity) {
+  Program program(with_queue_capacity(capacity));
+  std::vector<double> samples;
+  samples.reserve(prices.size() / kBurst + 1);
+  for (size_t base = 0; base < prices.size(); base += kBurst) {
+    std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>> batch;
+    auto& msgs = batch["i1"];
+    const size_t end = std::min(prices.size(), base + kBurst);
+    for (size_t i = base; i < end; ++i) {
+      msgs.push_back(create_message<NumberData>(static_cast<timestamp_t>(i), NumberData{prices[i]}));
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    program.receive_batch(batch);
+    auto t1 = std::chrono::steady_clock::now();
+    samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+  }
+  report("burst", capacity, samples);
+}
+
+}  // namespace
+
+int main() {
+  auto prices = random_walk(kMessages);
+  std::printf("mode,queue_capacity,calls,p50_ns,p99_ns,p999_ns,max_ns\n");
+  for (size_t capacity : {size_t{0}, size_t{1024}}) {
+    run_chunk1(prices, capacity);
+    run_burst(prices, capacity);
+  }
+  return 0;
+}
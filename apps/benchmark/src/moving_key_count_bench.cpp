@@ -0,0 +1,91 @@
+// High-cardinality pre-filter: MovingKeyCount in exact mode against
+// count_min mode over a long window.
+//
+// Keys are Zipf-like over `keys` distinct values, so the window holds many
+// distinct keys next to a few heavy hitters. The count_min run goes first,
+// because freed heap is not always returned to the OS; RSS is read from
+// /proc/self/statm (Linux) after each run, with the operator still alive.
+// The last line is the largest overestimate of count_min against exact.
+//
+// Usage: moving_key_count_bench [window] [keys] [rows]
+// Output columns: mode,window,rows,ms,rows_per_s,rss_mb.
+// Run with `bazel run -c opt //apps/benchmark:moving_key_count_bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/std/MovingKeyCount.h"
+
+using namespace rtbot;
+
+namespace {
+
+double rss_mb() {
+  std::ifstream statm("/proc/self/statm");
+  size_t pages = 0, resident = 0;
+  statm >> pages >> resident;
+  return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+std::vector<double> make_keys(size_t keys, size_t rows) {
+  std::mt19937_64 rng(13);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<double> out(rows);
+  // Inverse-CDF sample of a power law with exponent ~1 over [1, keys].
+  for (auto& k : out) k = std::floor(std::pow(static_cast<double>(keys), u(rng)));
+  return out;
+}
+
+// Returns the emitted counts.
+std::vector<double> run(const char* mode, std::shared_ptr<MovingKeyCount> op, const std::vector<double>& keys) {
+  auto sink = std::make_shared<Collector>("sink", std::vector<std::string>{"number"});
+  op->connect(sink, 0, 0);
+
+  std::vector<double> counts;
+  counts.reserve(keys.size());
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    op->receive_data(create_message<NumberData>(static_cast<timestamp_t>(i + 1), NumberData{keys[i]}), 0);
+    op->execute();
+    auto& queue = sink->get_data_queue(0);
+    for (const auto& msg : queue) counts.push_back(static_cast<const Message<NumberData>*>(msg.get())->data.value);
+    queue.clear();
+  }
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  const double rows = static_cast<double>(keys.size());
+  std::printf("%s,%zu,%.0f,%.1f,%.0f,%.1f\n", mode, op->get_window_size(), rows, ms, rows / ms * 1e3, rss_mb());
+  return counts;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t window = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  const size_t keys = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+  const size_t rows = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 3000000;
+  const auto key_stream = make_keys(keys, rows);
+
+  std::printf("mode,window,rows,ms,rows_per_s,rss_mb\n");
+  const auto approx = run("count_min", make_moving_key_count("mkc", window, 0.001, 0.01, 8), key_stream);
+  const auto exact = run("exact", make_moving_key_count("mkc", window), key_stream);
+  double max_over = 0.0;
+  for (size_t i = 0; i < exact.size(); ++i) {
+    if (approx[i] < exact[i]) {
+      std::fprintf(stderr, "count_min undercounts at row %zu\n", i);
+      return 1;
+    }
+    max_over = std::max(max_over, approx[i] - exact[i]);
+  }
+  std::printf("max_over,%.0f\n", max_over);
+  return 0;
+}
@@ -0,0 +1,156 @@
+// Scaling benchmark for PipelinedProgram.
+//
+// Streams one long series through a single heavy program — a chain of
+// large-window FiniteImpulseResponse filters feeding MovingAverage /
+// StandardDeviation — first serially through Program::receive_batch, then
+// through PipelinedProgram with 1..N stages. Every stage count is checked
+// against the serial output before its timing is reported.
+//
+// Usage: pipeline_bench [max_stages] [messages] [fir_taps]
+// Output columns: driver,stages,messages,total_ms,msgs_per_s,speedup,layout.
+// Run with `bazel run -c opt //apps/benchmark:pipeline_bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rtbot/PipelinedProgram.h"
+
+using namespace rtbot;
+
+namespace {
+
+constexpr size_t kBurst = 256;
+
+std::string heavy_program(size_t taps) {
+  std::string coeff = "[";
+  for (size_t i = 0; i < taps; ++i) coeff += (i ? "," : "") + std::to_string(1.0 / static_cast<double>(taps));
+  coeff += "]";
+  return R"({
+    "entryOperator": "in",
+    "output": { "out": ["o1", "o2"] },
+    "operators": [
+      {"id": "in", "type": "Input", "portTypes": ["number"]},
+      {"id": "fir1", "type": "FiniteImpulseResponse", "coeff": )" +
+         coeff + R"(},
+      {"id": "fir2", "type": "FiniteImpulseResponse", "coeff": )" +
+         coeff + R"(},
+      {"id": "fir3", "type": "FiniteImpulseResponse", "coeff": )" +
+         coeff + R"(},
+      {"id": "fir4", "type": "FiniteImpulseResponse", "coeff": )" +
+         coeff + R"(},
+      {"id": "ma", "type": "MovingAverage", "window_size": 500},
+      {"id": "sd", "type": "StandardDeviation", "window_size": 500},
+      {"id": "out", "type": "Output", "portTypes": ["number", "number"]}
+    ],
+    "connections": [
+      {"from": "in", "to": "fir1", "fromPort": "o1", "toPort": "i1"},
+      {"from": "fir1", "to": "fir2", "fromPort": "o1", "toPort": "i1"},
+      {"from": "fir2", "to": "fir3", "fromPort": "o1", "toPort": "i1"},
+      {"from": "fir3", "to": "fir4", "fromPort": "o1", "toPort": "i1"},
+      {"from": "fir4", "to": "ma", "fromPort": "o1", "toPort": "i1"},
+      {"from": "fir4", "to": "sd", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ma", "to": "out", "fromPort": "o1", "toPort": "i1"},
+      {"from": "sd", "to": "out", "fromPort": "o1", "toPort": "i2"}
+    ]
+  })";
+}
+
+std::vector<double> random_walk(size_t n) {
+  std::mt19937 gen(42);
+  std::normal_distribution<> d(0, 1);
+  std::vector<double> out(n);
+  double p = 100.0;
+  for (auto& v : out) {
+    p += d(gen);
+    v = p;
+  }
+  return out;
+}
+
+PipelinedProgram::PortBatch make_burst(const std::vector<double>& prices, size_t base) {
+  PipelinedProgram::PortBatch batch;
+  auto& msgs = batch["i1"];
+  const size_t end = std::min(prices.size(), base + kBurst);
+  msgs.reserve(end - base);
+  for (size_t i = base; i < end; ++i) {
+    msgs.push_back(create_message<NumberData>(static_cast<timestamp_t>(i + 1), NumberData{prices[i]}));
+  }
+  return batch;
+}
+
+// Order-sensitive digest of the "out" operator's outputs.
+double digest(ProgramMsgBatch& batch, double acc) {
+  for (const char* port : {"o1", "o2"}) {
+    for (auto& msg : batch["out"][port]) {
+      acc = acc * 1.000001 + static_cast<const Message<NumberData>*>(msg.get())->data.value;
+    }
+  }
+  return acc;
+}
+
+double run_serial(const std::string& json, const std::vector<double>& prices, double& hash) {
+  Program program(json);
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t base = 0; base < prices.size(); base += kBurst) {
+    auto out = program.receive_batch(make_burst(prices, base));
+    hash = digest(out, hash);
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+double run_pipelined(const std::string& json, size_t stages, const std::vector<double>& prices, double& hash,
+                     std::string& layout) {
+  PipelinedProgram program(json, stages);
+  for (const auto& ids : program.stage_layout()) {
+    layout += layout.empty() ? "" : "|";
+    for (size_t i = 0; i < ids.size(); ++i) layout += (i ? " " : "") + ids[i];
+  }
+  std::vector<PipelinedProgram::Result> results;
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t base = 0; base < prices.size(); base += kBurst) {
+    program.submit(make_burst(prices, base));
+    program.poll_results(results);
+  }
+  program.drain_results(results);
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  for (auto& r : results) hash = digest(r.batch, hash);
+  return ms;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  const size_t max_stages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::min<size_t>(hw, 4);
+  const size_t messages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+  const size_t taps = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 256;
+
+  const auto json = heavy_program(taps);
+  const auto prices = random_walk(messages);
+  const double total = static_cast<double>(messages);
+
+  std::printf("driver,stages,messages,total_ms,msgs_per_s,speedup,layout\n");
+  double serial_hash = 0;
+  const double serial_ms = run_serial(json, prices, serial_hash);
+  std::printf("Serial,1,%.0f,%.1f,%.0f,1.00,\n", total, serial_ms, total / serial_ms * 1e3);
+
+  int rc = 0;
+  for (size_t s = 1; s <= max_stages; ++s) {
+    double hash = 0;
+    std::string layout;
+    const double ms = run_pipelined(json, s, prices, hash, layout);
+    std::printf("Pipelined,%zu,%.0f,%.1f,%.0f,%.2f,%s\n", s, total, ms, total / ms * 1e3, serial_ms / ms,
+                layout.c_str());
+    if (hash != serial_hash) {
+      std::fprintf(stderr, "output mismatch with %zu stages\n", s);
+      rc = 1;
+    }
+  }
+  return rc;
+}
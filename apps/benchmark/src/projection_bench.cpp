@@ -0,0 +1,99 @@
+// Wide-row projection chain, the shape SQL-generated graphs produce.
+//
+// Rows of `cols` doubles go through three column-range VectorProjects
+// (each keeping a contiguous slice of the previous one), a strided one and a
+// VectorExtract. With VectorNumberData views every projection shares the
+// input row's buffer; without them each stage copies its slice. Prints
+// ns/row and a checksum of the outputs.
+//
+// Usage: projection_bench [rows] [cols] [burst]
+// Output columns: rows,cols,burst,total_ms,ns_per_row,checksum.
+// Run with `bazel run -c opt //apps/benchmark:projection_bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtbot/Program.h"
+
+using namespace rtbot;
+
+namespace {
+
+std::string index_range(size_t first, size_t last, size_t step = 1) {
+  std::string out = "[";
+  for (size_t i = first; i < last; i += step) out += (i == first ? "" : ",") + std::to_string(i);
+  return out + "]";
+}
+
+std::string program_json(size_t cols) {
+  return R"({
+    "entryOperator": "in",
+    "output": { "out": ["o1", "o2"] },
+    "operators": [
+      {"id": "in", "type": "Input", "portTypes": ["vector_number"]},
+      {"id": "p1", "type": "VectorProject", "indices": )" +
+         index_range(0, cols - 8) + R"(},
+      {"id": "p2", "type": "VectorProject", "indices": )" +
+         index_range(4, cols - 12) + R"(},
+      {"id": "p3", "type": "VectorProject", "indices": )" +
+         index_range(0, (cols - 16) / 2) + R"(},
+      {"id": "p4", "type": "VectorProject", "indices": )" +
+         index_range(0, (cols - 16) / 2, 2) + R"(},
+      {"id": "x", "type": "VectorExtract", "index": 3},
+      {"id": "out", "type": "Output", "portTypes": ["vector_number", "number"]}
+    ],
+    "connections": [
+      {"from": "in", "to": "p1", "fromPort": "o1", "toPort": "i1"},
+      {"from": "p1", "to": "p2", "fromPort": "o1", "toPort": "i1"},
+      {"from": "p2", "to": "p3", "fromPort": "o1", "toPort": "i1"},
+      {"from": "p3", "to": "p4", "fromPort": "o1", "toPort": "i1"},
+      {"from": "p4", "to": "x", "fromPort": "o1", "toPort": "i1"},
+      {"from": "p4", "to": "out", "fromPort": "o1", "toPort": "i1"},
+      {"from": "x", "to": "out", "fromPort": "o1", "toPort": "i2"}
+    ]
+  })";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  const size_t cols = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+  const size_t burst = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 256;
+
+  Program program(program_json(cols));
+  double checksum = 0.0;
+  double total_ms = 0.0;
+  for (size_t base = 0; base < rows; base += burst) {
+    std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>> batch;
+    const size_t end = std::min(rows, base + burst);
+    for (size_t r = base; r < end; ++r) {
+      auto row = make_pooled_vector_double(cols);
+      for (size_t c = 0; c < cols; ++c) (*row)[c] = static_cast<double>(r % 97) + 0.001 * static_cast<double>(c);
+      batch["i1"].push_back(create_message<VectorNumberData>(static_cast<timestamp_t>(r + 1),
+                                                             VectorNumberData(std::move(row))));
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto out = program.receive_batch(batch);
+    total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    for (auto& msg : out["out"]["o1"]) {
+      const auto& v = static_cast<const Message<VectorNumberData>*>(msg.get())->data;
+      checksum = checksum * 1.0000001 + v[0] + v[v.size() - 1];
+    }
+    for (auto& msg : out["out"]["o2"]) {
+      checksum = checksum * 1.0000001 + static_cast<const Message<NumberData>*>(msg.get())->data.value;
+    }
+  }
+
+  std::printf("rows,cols,burst,total_ms,ns_per_row,checksum\n");
+  std::printf("%zu,%zu,%zu,%.1f,%.1f,%.17g\n", rows, cols, burst, total_ms, total_ms * 1e6 / rows, checksum);
+  return 0;
+}
@@ -0,0 +1,139 @@
+// Scaling benchmark for ShardedProgramManager.
+//
+// Hosts many independent Bollinger Bands programs and streams bursts of
+// messages into all of them from one client thread, for 1..N shard threads.
+// Reports aggregate throughput (messages/s across all programs) and speedup
+// relative to one shard. A single-threaded loop over plain Program objects
+// runs the same workload inline for comparison.
+//
+// Usage: sharded_bench [max_threads] [programs] [messages_per_program]
+// Output columns: driver,threads,programs,messages,total_ms,msgs_per_s,speedup.
+// Run with `bazel run -c opt //apps/benchmark:sharded_bench`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rtbot/Program.h"
+#include "rtbot/ShardedProgramManager.h"
+
+using namespace rtbot;
+
+namespace {
+
+constexpr size_t kBurst = 64;
+
+const char* kBollingerJson = R"({
+  "apiVersion": "v1",
+  "entryOperator": "754",
+  "output": { "37": ["o2", "o1", "o3"] },
+  "operators": [
+      { "id": "37", "type": "Output", "portTypes": ["number", "number", "number"] },
+      { "id": "495", "type": "Subtraction" },
+      { "id": "861", "type": "Addition" },
+      { "id": "996", "type": "Scale", "value": 2 },
+      { "id": "865", "type": "StandardDeviation", "window_size": 14 },
+      { "id": "510", "type": "MovingAverage", "window_size": 14 },
+      { "id": "262", "type": "ResamplerHermite", "interval": 1 },
+      { "id": "754", "type": "Input", "portTypes": ["number"] }
+  ],
+  "connections": [
+      { "from": "510", "to": "37", "fromPort": "o1", "toPort": "i3" },
+      { "from": "495", "to": "37", "fromPort": "o1", "toPort": "i1" },
+      { "from": "861", "to": "37", "fromPort": "o1", "toPort": "i2" },
+      { "from": "996", "to": "495", "fromPort": "o1", "toPort": "i2" },
+      { "from": "510", "to": "495", "fromPort": "o1", "toPort": "i1" },
+      { "from": "996", "to": "861", "fromPort": "o1", "toPort": "i2" },
+      { "from": "510", "to": "861", "fromPort": "o1", "toPort": "i1" },
+      { "from": "865", "to": "996", "fromPort": "o1", "toPort": "i1" },
+      { "from": "262", "to": "865", "fromPort": "o1", "toPort": "i1" },
+      { "from": "262", "to": "510", "fromPort": "o1", "toPort": "i1" },
+      { "from": "754", "to": "262", "fromPort": "o1", "toPort": "i1" }
+  ]
+})";
+
+std::vector<double> random_walk(size_t n) {
+  std::mt19937 gen(42);
+  std::normal_distribution<> d(0, 1);
+  std::vector<double> out(n);
+  double p = 100.0;
+  for (auto& v : out) {
+    p += d(gen);
+    v = p;
+  }
+  return out;
+}
+
+ShardedProgramManager::PortBatch make_burst(const std::vector<double>& prices, size_t base) {
+  ShardedProgramManager::PortBatch batch;
+  auto& msgs = batch["i1"];
+  const size_t end = std::min(prices.size(), base + kBurst);
+  msgs.reserve(end - base);
+  for (size_t i = base; i < end; ++i) {
+    msgs.push_back(create_message<NumberData>(static_cast<timestamp_t>(i), NumberData{prices[i]}));
+  }
+  return batch;
+}
+
+std::string program_id(size_t p) { return "prog" + std::to_string(p); }
+
+double run_inline(size_t programs, const std::vector<double>& prices) {
+  std::vector<Program> progs;
+  progs.reserve(programs);
+  for (size_t p = 0; p < programs; ++p) progs.emplace_back(kBollingerJson);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t base = 0; base < prices.size(); base += kBurst) {
+    for (auto& prog : progs) prog.receive_batch(make_burst(prices, base));
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+double run_sharded(size_t threads, size_t programs, const std::vector<double>& prices) {
+  ShardedProgramManager manager(threads);
+  std::vector<ShardedProgramManager::Result> results;
+  for (size_t p = 0; p < programs; ++p) manager.create_program(program_id(p), kBollingerJson);
+  manager.drain_results(results);
+  results.clear();
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t base = 0; base < prices.size(); base += kBurst) {
+    for (size_t p = 0; p < programs; ++p) manager.process_batch(program_id(p), make_burst(prices, base));
+    // Keep completion rings from backing up into the overflow lists.
+    manager.poll_results(results);
+    results.clear();
+  }
+  manager.drain_results(results);
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  const size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : hw;
+  const size_t programs = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+  const size_t per_program = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2048;
+
+  auto prices = random_walk(per_program);
+  const double total = static_cast<double>(programs * per_program);
+
+  std::printf("driver,threads,programs,messages,total_ms,msgs_per_s,speedup\n");
+  const double inline_ms = run_inline(programs, prices);
+  std::printf("Inline,1,%zu,%.0f,%.1f,%.0f,1.00\n", programs, total, inline_ms, total / inline_ms * 1e3);
+
+  double one_shard_ms = 0;
+  for (size_t t = 1; t <= max_threads; t = (t < 4 ? t + 1 : t * 2)) {
+    const double ms = run_sharded(t, programs, prices);
+    if (t == 1) one_shard_ms = ms;
+    std::printf("Sharded,%zu,%zu,%.0f,%.1f,%.0f,%.2f\n", t, programs, total, ms, total / ms * 1e3, one_shard_ms / ms);
+  }
+  return 0;
+}
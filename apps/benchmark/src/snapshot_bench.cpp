@@ -0,0 +1,161 @@
+// State snapshot size and speed: JSON (serialize_data, base64 operator
+// bytes) against the binary format (serialize_binary).
+//
+// The program keys rows into a KeyedPipeline whose sub-graphs each keep a
+// MovingAverage window, next to one large top-level window, so most of the
+// state is buffered values. Each format is serialized and restored `reps`
+// times into a fresh program, and the binary restore is checked against a
+// JSON restore of the same state. The "delta" row is a checkpoint_delta()
+// after 1% of the keys received one more row, applied on top of a full
+// checkpoint.
+//
+// Usage: snapshot_bench [keys] [window] [reps]
+// Output columns: format,keys,window,bytes,serialize_ms,restore_ms.
+// Run with `bazel run -c opt //apps/benchmark:snapshot_bench`.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "rtbot/Program.h"
+
+using namespace rtbot;
+
+namespace {
+
+std::string program_json(size_t window) {
+  const std::string w = std::to_string(window);
+  return R"({
+    "entryOperator": "in",
+    "output": { "out": ["o1", "o2"] },
+    "operators": [
+      {"id": "in", "type": "Input", "portTypes": ["vector_number"]},
+      {"id": "keyed", "type": "KeyedPipeline", "key_index": 0,
+       "prototype": {
+         "operators": [
+           {"type": "VectorExtract", "id": "ext", "index": 1},
+           {"type": "MovingAverage", "id": "ma", "window_size": )" +
+         w + R"(}
+         ],
+         "connections": [{"from": "ext", "to": "ma", "fromPort": "o1", "toPort": "i1"}],
+         "entry": {"operator": "ext"},
+         "output": {"operator": "ma"}
+       }},
+      {"id": "x", "type": "VectorExtract", "index": 1},
+      {"id": "big", "type": "MovingAverage", "window_size": )" +
+         std::to_string(window * 64) + R"(},
+      {"id": "out", "type": "Output", "portTypes": ["vector_number", "number"]}
+    ],
+    "connections": [
+      {"from": "in", "to": "keyed", "fromPort": "o1", "toPort": "i1"},
+      {"from": "in", "to": "x", "fromPort": "o1", "toPort": "i1"},
+      {"from": "x", "to": "big", "fromPort": "o1", "toPort": "i1"},
+      {"from": "keyed", "to": "out", "fromPort": "o1", "toPort": "i1"},
+      {"from": "big", "to": "out", "fromPort": "o1", "toPort": "i2"}
+    ]
+  })";
+}
+
+std::unique_ptr<BaseMessage> row(timestamp_t t, double key, double value) {
+  return create_message<VectorNumberData>(t, VectorNumberData(std::vector<double>{key, value}));
+}
+
+double probe(Program& program, timestamp_t t) {
+  double sum = 0.0;
+  auto out = program.receive(row(t, 1.0, 0.5));
+  for (auto& msg : out["out"]["o2"]) sum += static_cast<const Message<NumberData>*>(msg.get())->data.value;
+  return sum;
+}
+
+double ms_since(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+  const size_t window = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 32;
+  const int reps = argc > 3 ? std::atoi(argv[3]) : 5;
+
+  const std::string json = program_json(window);
+  Program program(json);
+  timestamp_t t = 1;
+  for (size_t round = 0; round < window; ++round) {
+    for (size_t k = 0; k < keys; ++k, ++t) {
+      program.receive(row(t, static_cast<double>(k), static_cast<double>((t * 7919) % 1000) * 0.01));
+    }
+  }
+
+  std::printf("format,keys,window,bytes,serialize_ms,restore_ms\n");
+
+  {
+    std::string state;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; ++i) state = program.serialize_data();
+    const double ser = ms_since(t0) / reps;
+    double res = 0.0;
+    for (int i = 0; i < reps; ++i) {
+      Program restored(json);
+      t0 = std::chrono::steady_clock::now();
+      restored.restore_data_from_json(state);
+      res += ms_since(t0);
+    }
+    std::printf("json,%zu,%zu,%zu,%.2f,%.2f\n", keys, window, state.size(), ser, res / reps);
+  }
+
+  {
+    Bytes state;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; ++i) state = program.serialize_binary();
+    const double ser = ms_since(t0) / reps;
+    double res = 0.0;
+    for (int i = 0; i < reps; ++i) {
+      Program restored(json);
+      t0 = std::chrono::steady_clock::now();
+      restored.restore_binary(state);
+      res += ms_since(t0);
+      if (i == 0) {
+        Program reference(json);
+        reference.restore_data_from_json(program.serialize_data());
+        if (probe(restored, t) != probe(reference, t)) {
+          std::fprintf(stderr, "binary restore diverges from json restore\n");
+          return 1;
+        }
+      }
+    }
+    std::printf("binary,%zu,%zu,%zu,%.2f,%.2f\n", keys, window, state.size(), ser, res / reps);
+  }
+
+  {
+    const size_t touched = keys / 100 > 0 ? keys / 100 : 1;
+    Bytes delta;
+    double ser = 0.0;
+    double res = 0.0;
+    for (int i = 0; i < reps; ++i) {
+      const Bytes base = program.checkpoint();
+      for (size_t k = 0; k < touched; ++k, ++t) program.receive(row(t, static_cast<double>(k * 97 % keys), 1.0));
+      auto t0 = std::chrono::steady_clock::now();
+      delta = program.checkpoint_delta();
+      ser += ms_since(t0);
+
+      Program restored(json);
+      restored.apply_checkpoint(base);
+      t0 = std::chrono::steady_clock::now();
+      restored.apply_checkpoint(delta);
+      res += ms_since(t0);
+      if (i == 0) {
+        Program reference(json);
+        reference.restore_binary(program.serialize_binary());
+        if (probe(restored, t) != probe(reference, t)) {
+          std::fprintf(stderr, "delta restore diverges from full restore\n");
+          return 1;
+        }
+      }
+    }
+    std::printf("delta,%zu,%zu,%zu,%.2f,%.2f\n", keys, window, delta.size(), ser / reps, res / reps);
+  }
+  return 0;
+}
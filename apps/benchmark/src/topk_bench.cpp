@@ -0,0 +1,72 @@
+// Leaderboard from a trade stream: TopK in full, delta and snapshot emission
+// modes, and WindowTopK over the last `window` trades, for a large K.
+//
+// Rows are [trader, notional]; every mode sees the same rows. Throughput
+// counts input rows; `out_msgs` is the number of messages emitted.
+//
+// Usage: topk_bench [k] [rows] [window]
+// Output columns: operator,emit,k,rows,ms,rows_per_s,out_msgs.
+// Run with `bazel run -c opt //apps/benchmark:topk_bench`.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/std/TopK.h"
+#include "rtbot/std/WindowTopK.h"
+
+using namespace rtbot;
+
+namespace {
+
+std::vector<double> make_notionals(size_t rows) {
+  std::mt19937_64 rng(17);
+  std::lognormal_distribution<double> notional(10.0, 1.5);
+  std::vector<double> out(rows);
+  for (auto& n : out) n = notional(rng);
+  return out;
+}
+
+void run(const char* name, TopKEmit emit, int k, std::shared_ptr<Operator> op, const std::vector<double>& notionals) {
+  auto sink = std::make_shared<Collector>("sink", std::vector<std::string>{"vector_number"});
+  op->connect(sink, 0, 0);
+
+  size_t out_msgs = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < notionals.size(); ++i) {
+    op->receive_data(create_message<VectorNumberData>(static_cast<timestamp_t>(i + 1),
+                                                      VectorNumberData({static_cast<double>(i % 5000), notionals[i]})),
+                     0);
+    op->execute();
+    auto& queue = sink->get_data_queue(0);
+    out_msgs += queue.size();
+    queue.clear();
+  }
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  const double rows = static_cast<double>(notionals.size());
+  std::printf("%s,%s,%d,%.0f,%.1f,%.0f,%zu\n", name, topk_emit_to_string(emit).c_str(), k, rows, ms,
+              rows / ms * 1e3, out_msgs);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int k = argc > 1 ? std::atoi(argv[1]) : 100;
+  const size_t rows = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+  const size_t window = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10000;
+  const auto notionals = make_notionals(rows);
+
+  std::printf("operator,emit,k,rows,ms,rows_per_s,out_msgs\n");
+  for (TopKEmit emit : {TopKEmit::Full, TopKEmit::Snapshot, TopKEmit::Delta}) {
+    run("TopK", emit, k, make_topk("topk", k, 1, true, emit), notionals);
+  }
+  for (TopKEmit emit : {TopKEmit::Full, TopKEmit::Snapshot, TopKEmit::Delta}) {
+    run("WindowTopK", emit, k, make_window_topk("wtopk", k, 1, window, true, emit), notionals);
+  }
+  return 0;
+}
@@ -51,11 +51,13 @@
 #include "rtbot/std/BooleanToNumber.h"
 #include "rtbot/std/MinMaxTracker.h"
 #include "rtbot/std/TopK.h"
+#include "rtbot/std/WindowTopK.h"
 #include "rtbot/std/TimestampExtract.h"
 #include "rtbot/std/WindowMinMax.h"
 #include "rtbot/fuse/FusedExpression.h"
 #include "rtbot/fuse/BurstAggregate.h"
 #include "rtbot/fuse/FusedExpressionVector.h"
+#include "rtbot/fuse/KeyedFusedExpression.h"
 
 using json = nlohmann::json;
 
@@ -234,6 +236,17 @@ class OperatorJson {
           parsed["bytecode"].get<std::vector<double>>(),
           parsed.value("constants", std::vector<double>{}),
           parsed.value("coefficients", std::vector<double>{}));
+    } else if (type == "KeyedFusedExpression") {
+      auto kfe = make_keyed_fused_expression(
+          id, parsed["key_index"].get<int>(),
+          parsed["numOutputs"].get<size_t>(),
+          parsed["bytecode"].get<std::vector<double>>(),
+          parsed.value("constants", std::vector<double>{}),
+          parsed.value("coefficients", std::vector<double>{}));
+      if (parsed.contains("maxKeys") || parsed.contains("idleTtl")) {
+        kfe->set_eviction(parsed.value("maxKeys", size_t{0}), parsed.value("idleTtl", timestamp_t{0}));
+      }
+      return kfe;
     } else if (type == "BurstAggregate") {
       auto key_cols_int = parsed.value("keyColumns", std::vector<int>{});
       std::vector<std::size_t> key_cols;
@@ -273,6 +286,16 @@ class OperatorJson {
     } else if (type == "CompareSyncNEQ") {
       return make_compare_sync_neq(id, parsed.value("tolerance", 0.0));
     } else if (type == "MovingKeyCount") {
+      const std::string mode = parsed.value("mode", "exact");
+      if (mode == "count_min") {
+        return make_moving_key_count(id, parsed["window_size"].get<size_t>(),
+                                     parsed.value("epsilon", 0.001),
+                                     parsed.value("delta", 0.01),
+                                     parsed.value("panes", static_cast<size_t>(8)));
+      }
+      if (mode != "exact") {
+        throw std::runtime_error("MovingKeyCount: unknown mode '" + mode + "'");
+      }
       return make_moving_key_count(id, parsed["window_size"].get<size_t>());
     } else if (type == "MinTracker") {
       return make_min_tracker(id);
@@ -281,7 +304,14 @@ class OperatorJson {
     } else if (type == "TopK") {
       return make_topk(id, parsed["k"].get<int>(),
                        parsed["score_index"].get<int>(),
-                       parsed.value("descending", "true") == "true");
+                       parsed.value("descending", "true") == "true",
+                       topk_emit_from_string(parsed.value("emit", "full")));
+    } else if (type == "WindowTopK") {
+      return make_window_topk(id, parsed["k"].get<int>(),
+                              parsed["score_index"].get<int>(),
+                              parsed["window_size"].get<size_t>(),
+                              parsed.value("descending", "true") == "true",
+                              topk_emit_from_string(parsed.value("emit", "full")));
     } else if (type == "WindowMinMax") {
       return make_window_min_max(id, parsed["window_size"].get<size_t>(),
                                  parsed.value("mode", "min"));
@@ -299,36 +329,34 @@ class OperatorJson {
         key_index = parsed["key_index"].get<int>();
       }
 
-      // Build factory from embedded prototype definition
+      // Compile the embedded prototype once; new keys clone it (see
+      // SubGraphPrototype) instead of re-reading the operator JSON.
       const auto& proto = parsed["prototype"];
-      json proto_operators = proto["operators"];
-      json proto_connections = proto["connections"];
-      std::string proto_entry = proto["entry"]["operator"].get<std::string>();
-      std::string proto_output = proto["output"]["operator"].get<std::string>();
-
-      auto factory = [proto_operators, proto_connections, proto_entry, proto_output]() -> SubGraph {
-        SubGraph sg;
-        for (const auto& op_json : proto_operators) {
-          auto op = OperatorJson::read_op(op_json.dump());
-          sg.operators[op->id()] = op;
-        }
-        for (const auto& conn : proto_connections) {
-          std::string from = conn["from"].get<std::string>();
-          std::string to = conn["to"].get<std::string>();
-          auto from_parsed = conn.contains("fromPort") ? parse_port_name(conn["fromPort"].get<std::string>()) : ParsedPort{0, PortKind::DATA};
-          auto to_parsed = conn.contains("toPort") ? parse_port_name(conn["toPort"].get<std::string>()) : ParsedPort{0, PortKind::DATA};
-          sg.operators[from]->connect(sg.operators[to], from_parsed.index, to_parsed.index, to_parsed.kind);
-        }
-        sg.entry = sg.operators[proto_entry];
-        sg.output = sg.operators[proto_output];
-        return sg;
-      };
-
-      if (!key_column_indices.empty()) {
-        return make_keyed_pipeline(id, std::move(key_column_indices), factory);
-      } else {
-        return make_keyed_pipeline(id, key_index, factory);
-      }
+      auto prototype = std::make_shared<SubGraphPrototype>();
+      for (const auto& op_json : proto["operators"]) {
+        std::string op_string = op_json.dump();
+        auto op = OperatorJson::read_op(op_string);
+        prototype->add_operator(std::move(op), [op_string]() { return OperatorJson::read_op(op_string); });
+      }
+      for (const auto& conn : proto["connections"]) {
+        auto from_parsed = conn.contains("fromPort") ? parse_port_name(conn["fromPort"].get<std::string>()) : ParsedPort{0, PortKind::DATA};
+        auto to_parsed = conn.contains("toPort") ? parse_port_name(conn["toPort"].get<std::string>()) : ParsedPort{0, PortKind::DATA};
+        prototype->add_connection(conn["from"].get<std::string>(), conn["to"].get<std::string>(), from_parsed.index,
+                                  to_parsed.index, to_parsed.kind);
+      }
+      prototype->set_entry(proto["entry"]["operator"].get<std::string>());
+      prototype->set_output(proto["output"]["operator"].get<std::string>());
+
+      auto factory = [prototype]() -> SubGraph { return prototype->instantiate(); };
+
+      auto kp = !key_column_indices.empty() ? make_keyed_pipeline(id, std::move(key_column_indices), factory)
+                                            : make_keyed_pipeline(id, key_index, factory);
+      if (parsed.contains("maxKeys") || parsed.contains("idleTtl")) {
+        kp->set_eviction(parsed.value("maxKeys", size_t{0}), parsed.value("idleTtl", timestamp_t{0}));
+      }
+      if (parsed.contains("threads")) kp->set_threads(parsed["threads"].get<size_t>());
+      if (parsed.contains("hotKeys")) kp->set_spill(parsed["hotKeys"].get<size_t>(), parsed.value("spillDir", ""));
+      return kp;
     } else if (type == "Pipeline") {
       // Validate port types
       auto input_types = parsed["input_port_types"].get<std::vector<std::string>>();
@@ -621,6 +649,17 @@ class OperatorJson {
       if (!fev->get_coefficients().empty()) {
         j["coefficients"] = fev->get_coefficients();
       }
+    } else if (type == "KeyedFusedExpression") {
+      auto kfe = std::dynamic_pointer_cast<KeyedFusedExpression>(op);
+      j["key_index"] = kfe->get_key_index();
+      j["numOutputs"] = kfe->get_num_outputs();
+      j["bytecode"] = kfe->get_bytecode();
+      j["constants"] = kfe->get_constants();
+      if (!kfe->get_coefficients().empty()) {
+        j["coefficients"] = kfe->get_coefficients();
+      }
+      if (kfe->get_max_keys() > 0) j["maxKeys"] = kfe->get_max_keys();
+      if (kfe->get_idle_ttl() > 0) j["idleTtl"] = kfe->get_idle_ttl();
     } else if (type == "CompareGT") {
       j["value"] = std::dynamic_pointer_cast<CompareGT>(op)->get_value();
     } else if (type == "CompareLT") {
@@ -643,7 +682,14 @@ class OperatorJson {
     } else if (type == "CompareSyncNEQ") {
       j["tolerance"] = std::dynamic_pointer_cast<CompareSyncNEQ>(op)->get_tolerance();
     } else if (type == "MovingKeyCount") {
-      j["window_size"] = std::dynamic_pointer_cast<MovingKeyCount>(op)->get_window_size();
+      auto mkc = std::dynamic_pointer_cast<MovingKeyCount>(op);
+      j["window_size"] = mkc->get_window_size();
+      if (const SlidingCountMin* sketch = mkc->get_sketch()) {
+        j["mode"] = "count_min";
+        j["epsilon"] = sketch->epsilon();
+        j["delta"] = sketch->delta();
+        j["panes"] = sketch->panes();
+      }
     } else if (type == "MinTracker" || type == "MaxTracker") {
       // No parameters — stateful but no configuration
     } else if (type == "TopK") {
@@ -651,6 +697,14 @@ class OperatorJson {
       j["k"] = tk->k();
       j["score_index"] = tk->score_index();
       j["descending"] = tk->descending() ? "true" : "false";
+      if (tk->emit() != TopKEmit::Full) j["emit"] = topk_emit_to_string(tk->emit());
+    } else if (type == "WindowTopK") {
+      auto wtk = std::dynamic_pointer_cast<WindowTopK>(op);
+      j["k"] = wtk->k();
+      j["score_index"] = wtk->score_index();
+      j["window_size"] = wtk->window_size();
+      j["descending"] = wtk->descending() ? "true" : "false";
+      if (wtk->emit() != TopKEmit::Full) j["emit"] = topk_emit_to_string(wtk->emit());
     } else if (type == "WindowMinMax") {
       auto wmm = std::dynamic_pointer_cast<WindowMinMax>(op);
       j["window_size"] = wmm->window_size();
@@ -668,6 +722,13 @@ class OperatorJson {
       } else {
         j["key_index"] = kp->get_key_index();
       }
+      if (kp->get_max_keys() > 0) j["maxKeys"] = kp->get_max_keys();
+      if (kp->get_idle_ttl() > 0) j["idleTtl"] = kp->get_idle_ttl();
+      if (kp->get_threads() > 1) j["threads"] = kp->get_threads();
+      if (kp->get_hot_keys() > 0) {
+        j["hotKeys"] = kp->get_hot_keys();
+        if (!kp->get_spill_dir().empty()) j["spillDir"] = kp->get_spill_dir();
+      }
     } else if (type == "Pipeline") {
       auto pipeline = std::dynamic_pointer_cast<Pipeline>(op);
       j["type"] = "Pipeline";
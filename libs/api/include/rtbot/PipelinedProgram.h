@@ -0,0 +1,364 @@
+#ifndef PIPELINED_PROGRAM_H
+#define PIPELINED_PROGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rtbot/ExecutionSchedule.h"
+#include "rtbot/MpmcRing.h"
+#include "rtbot/Program.h"
+
+namespace rtbot {
+
+// Opt-in pipeline-parallel execution of one Program.
+//
+// The program's compiled schedule (topological order) is cut into contiguous
+// stages, each run by its own thread. A cut never falls inside a cycle: every
+// recurrent edge (l1 -> ts11 -> l1) stays within one stage. Connections that
+// cross a cut are rerouted into stage-owned outlet queues; after a stage has
+// processed input batch n, its outlets are packed into the packet for batch n
+// and pushed through a bounded lock-free ring to the next stage, which
+// delivers them to the target ports and runs its own part of the schedule.
+// Messages bound for stages further down ride along in the same packet.
+//
+// Because stage boundaries follow the serial execution order and back edges
+// never cross them, every operator sees the same input queue contents in the
+// same order as under Program::receive_batch, so Result n equals what the
+// serial program returns for batch n. Batches are accepted from a single
+// producer thread and results come back in submission order.
+class PipelinedProgram {
+ public:
+  using PortBatch = std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>>;
+
+  struct Result {
+    uint64_t seq{0};
+    ProgramMsgBatch batch;
+    std::string error;  // non-empty when a stage threw on this batch
+  };
+
+  PipelinedProgram(const std::string& json_program, size_t num_stages, size_t ring_capacity = 64)
+      : program_(json_program) {
+    if (num_stages == 0) {
+      throw std::runtime_error("PipelinedProgram requires at least one stage");
+    }
+    partition(num_stages);
+    wire();
+    for (size_t s = 0; s < stages_.size(); ++s) {
+      stages_[s]->inbox = std::make_unique<MpmcRing<Packet>>(ring_capacity);
+    }
+    completions_ = std::make_unique<MpmcRing<Result>>(ring_capacity);
+    for (size_t s = 0; s < stages_.size(); ++s) {
+      stages_[s]->worker = std::thread([this, s] { run_stage(s); });
+    }
+  }
+
+  PipelinedProgram(const PipelinedProgram&) = delete;
+  PipelinedProgram& operator=(const PipelinedProgram&) = delete;
+
+  // Stops stages front to back so in-flight batches drain through the
+  // pipeline; undelivered results are dropped.
+  ~PipelinedProgram() {
+    for (auto& stage : stages_) {
+      stage->stop.store(true, std::memory_order_release);
+      if (stage->worker.joinable()) stage->worker.join();
+    }
+  }
+
+  size_t num_stages() const { return stages_.size(); }
+
+  // Operator ids per stage, in execution order.
+  std::vector<std::vector<std::string>> stage_layout() const {
+    std::unordered_map<const Operator*, std::string> names;
+    for (const auto& [id, op] : program_.operators_) names[op.get()] = id;
+    if (program_.sink_) names[program_.sink_.get()] = program_.sink_->id();
+
+    std::vector<std::vector<std::string>> layout;
+    for (const auto& stage : stages_) {
+      layout.emplace_back();
+      for (const Operator* op : stage->schedule.order()) layout.back().push_back(names[op]);
+    }
+    return layout;
+  }
+
+  // Enqueue one batch (the argument of Program::receive_batch). Blocks only
+  // while the first stage's ring is full. Returns the batch sequence number.
+  uint64_t submit(PortBatch batch) {
+    Packet pkt;
+    pkt.seq = next_seq_++;
+    pkt.input = std::move(batch);
+    submitted_.fetch_add(1, std::memory_order_release);
+    while (!stages_.front()->inbox->try_push(pkt)) {
+      std::this_thread::yield();
+    }
+    return pkt.seq;
+  }
+
+  // Non-blocking: move every published result into `out`, in sequence order.
+  size_t poll_results(std::vector<Result>& out) {
+    size_t n = 0;
+    Result r;
+    while (completions_->try_pop(r)) {
+      out.push_back(std::move(r));
+      ++n;
+    }
+    return n;
+  }
+
+  // Block until every submitted batch has come out of the last stage.
+  void drain_results(std::vector<Result>& out) {
+    for (;;) {
+      poll_results(out);
+      if (published_.load(std::memory_order_acquire) == submitted_.load(std::memory_order_acquire)) {
+        poll_results(out);
+        return;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  // Messages produced on one cross-stage connection during one batch.
+  struct Delivery {
+    uint32_t route{0};
+    std::vector<std::unique_ptr<BaseMessage>> msgs;
+  };
+
+  struct Packet {
+    uint64_t seq{0};
+    PortBatch input;  // consumed by stage 0
+    std::vector<Delivery> deliveries;
+    std::string error;
+  };
+
+  // Target of a cross-stage connection.
+  struct Route {
+    Operator* target{nullptr};
+    size_t port{0};
+    PortKind kind{PortKind::DATA};
+    size_t stage{0};
+    size_t position{0};  // in the target stage's schedule
+  };
+
+  struct Outlet {
+    MessageQueue queue;
+    timestamp_t last_ts{std::numeric_limits<timestamp_t>::min()};
+    uint32_t route{0};
+  };
+
+  struct Stage {
+    ExecutionSchedule schedule;
+    std::vector<std::unique_ptr<Outlet>> outlets;
+    std::unique_ptr<MpmcRing<Packet>> inbox;
+    std::deque<Result> overflow;  // last stage only
+    std::atomic<bool> stop{false};
+    std::thread worker;
+  };
+
+  // Split the serial order into at most `requested` contiguous stages of
+  // roughly equal operator count, moving each cut forward past any cycle it
+  // would split. The program sink always belongs to the last stage.
+  void partition(size_t requested) {
+    Operator* sink = program_.sink_.get();
+    std::vector<Operator*> order;
+    for (Operator* op : program_.schedule_.order()) {
+      if (op != sink) order.push_back(op);
+    }
+    const size_t n = order.size();
+
+    std::unordered_map<const Operator*, size_t> pos;
+    for (size_t i = 0; i < n; ++i) pos[order[i]] = i;
+
+    // blocked[c]: a cut before position c would separate a back edge's ends.
+    std::vector<bool> blocked(n + 1, false);
+    for (size_t j = 0; j < n; ++j) {
+      for (size_t c = 0; c < order[j]->num_connections(); ++c) {
+        auto it = pos.find(order[j]->get_connection(c).child);
+        if (it == pos.end() || it->second > j) continue;
+        for (size_t k = it->second + 1; k <= j; ++k) blocked[k] = true;
+      }
+    }
+
+    std::vector<size_t> cuts;
+    for (size_t k = 1; k < requested; ++k) {
+      size_t c = std::max(k * n / requested, cuts.empty() ? size_t{1} : cuts.back() + 1);
+      while (c < n && blocked[c]) ++c;
+      if (c >= n) break;
+      cuts.push_back(c);
+    }
+
+    std::vector<std::vector<Operator*>> stage_ops(cuts.size() + 1);
+    size_t stage = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (stage < cuts.size() && i == cuts[stage]) ++stage;
+      stage_ops[stage].push_back(order[i]);
+    }
+    if (sink) stage_ops.back().push_back(sink);
+
+    for (auto& ops : stage_ops) {
+      auto st = std::make_unique<Stage>();
+      for (Operator* op : ops) stage_of_[op] = stages_.size();
+      st->schedule.compile_order(std::move(ops));
+      stages_.push_back(std::move(st));
+    }
+  }
+
+  // Reroute every connection whose child lives in a later stage into an
+  // outlet owned by the producing stage.
+  void wire() {
+    for (size_t s = 0; s < stages_.size(); ++s) {
+      for (Operator* op : stages_[s]->schedule.order()) {
+        for (size_t c = 0; c < op->num_connections(); ++c) {
+          const auto& conn = op->get_connection(c);
+          auto it = stage_of_.find(conn.child);
+          if (it == stage_of_.end() || it->second == s) continue;
+          const size_t t = it->second;
+          routes_.push_back({conn.child, conn.child_input_port, conn.child_port_kind, t,
+                             stages_[t]->schedule.position(conn.child)});
+          auto outlet = std::make_unique<Outlet>();
+          outlet->route = static_cast<uint32_t>(routes_.size() - 1);
+          op->reroute_connection(c, &outlet->queue, &outlet->last_ts);
+          stages_[s]->outlets.push_back(std::move(outlet));
+        }
+      }
+    }
+  }
+
+  void run_stage(size_t s) {
+    Stage& stage = *stages_[s];
+    Packet pkt;
+    unsigned idle = 0;
+    for (;;) {
+      flush_overflow(stage);
+      if (stage.inbox->try_pop(pkt)) {
+        idle = 0;
+        handle(s, pkt);
+        continue;
+      }
+      // stop is raised only after the upstream stage has exited, so once it
+      // is visible an empty ring really is empty.
+      if (stage.stop.load(std::memory_order_acquire)) {
+        if (stage.inbox->try_pop(pkt)) {
+          handle(s, pkt);
+          continue;
+        }
+        return;
+      }
+      if (++idle < 64) continue;
+      if (idle < 1024) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+      }
+    }
+  }
+
+  // Run one batch through stage `s` and hand it to the next stage, or publish
+  // it as a Result from the last one.
+  void handle(size_t s, Packet& pkt) {
+    process(s, pkt);
+    if (s + 1 < stages_.size()) {
+      while (!stages_[s + 1]->inbox->try_push(pkt)) {
+        std::this_thread::yield();
+      }
+      return;
+    }
+    Result result;
+    result.seq = pkt.seq;
+    result.error = std::move(pkt.error);
+    result.batch = program_.collect_outputs(false);
+    if (!result.error.empty()) result.batch.clear();
+    publish(*stages_[s], std::move(result));
+    pkt = Packet{};
+  }
+
+  void process(size_t s, Packet& pkt) {
+    Stage& stage = *stages_[s];
+    if (!pkt.error.empty()) return;
+    // Messages forwarded to the next stage are freed on its thread; the
+    // arena handles cross-thread frees.
+    MessageArena::Scope arena(program_.message_arena_);
+    try {
+      std::vector<Delivery> forward;
+      for (auto& d : pkt.deliveries) {
+        const Route& r = routes_[d.route];
+        if (r.stage != s) {
+          forward.push_back(std::move(d));
+          continue;
+        }
+        for (auto& m : d.msgs) {
+          if (r.kind == PortKind::DATA) {
+            r.target->receive_data(std::move(m), r.port);
+          } else {
+            r.target->receive_control(std::move(m), r.port);
+          }
+        }
+        stage.schedule.mark_dirty(r.position);
+      }
+
+      if (s == 0) {
+        auto& entry = program_.operators_[program_.entry_operator_id_];
+        for (auto& [port_id, msgs] : pkt.input) {
+          if (msgs.empty()) continue;
+          entry->receive_data_batch(msgs, OperatorJson::parse_port_name(port_id).index, false);
+        }
+        pkt.input.clear();
+        stage.schedule.mark_dirty(0);
+      }
+
+      stage.schedule.drain(false);
+
+      for (auto& outlet : stage.outlets) {
+        if (outlet->queue.empty()) continue;
+        Delivery d;
+        d.route = outlet->route;
+        d.msgs.reserve(outlet->queue.size());
+        for (auto& m : outlet->queue) d.msgs.push_back(std::move(m));
+        outlet->queue.clear();
+        forward.push_back(std::move(d));
+      }
+      pkt.deliveries = std::move(forward);
+    } catch (const std::exception& e) {
+      pkt.error = e.what();
+      pkt.deliveries.clear();
+      for (auto& outlet : stage.outlets) outlet->queue.clear();
+    }
+  }
+
+  void publish(Stage& stage, Result result) {
+    if (stage.overflow.empty() && completions_->try_push(result)) {
+      published_.fetch_add(1, std::memory_order_release);
+      return;
+    }
+    stage.overflow.push_back(std::move(result));
+  }
+
+  void flush_overflow(Stage& stage) {
+    while (!stage.overflow.empty() && completions_->try_push(stage.overflow.front())) {
+      stage.overflow.pop_front();
+      published_.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  Program program_;
+  std::vector<std::unique_ptr<Stage>> stages_;
+  std::unordered_map<const Operator*, size_t> stage_of_;
+  std::vector<Route> routes_;
+  std::unique_ptr<MpmcRing<Result>> completions_;
+  uint64_t next_seq_{1};
+  std::atomic<uint64_t> submitted_{0};
+  std::atomic<uint64_t> published_{0};
+};
+
+}  // namespace rtbot
+
+#endif  // PIPELINED_PROGRAM_H
@@ -1,6 +1,7 @@
 #ifndef PROGRAM_H
 #define PROGRAM_H
 
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -15,6 +16,8 @@
 #include "OperatorJson.h"
 #include "Prototype.h"
 #include "rtbot/Collector.h"
+#include "rtbot/ExecutionSchedule.h"
+#include "rtbot/LatencyHistogram.h"
 #include "rtbot/Logger.h"
 #include "rtbot/OperatorJson.h"
 #include "rtbot/PortType.h"
@@ -26,7 +29,12 @@ using json = nlohmann::json;
 
 using namespace std;
 
+class PipelinedProgram;
+
 class Program {
+  // Partitions the compiled schedule and drives operators from stage threads.
+  friend class PipelinedProgram;
+
  public:
   // Constructor from JSON string
   explicit Program(const std::string& json_string) : program_json_(json_string) {
@@ -58,11 +66,210 @@ class Program {
     auto j = json::parse(json_state);
     for (auto& [name, op] : operators_) {
       op->restore_data_from_json(j.at(name));
+      op->mark_state_dirty();
+    }
+  }
+
+  // Binary counterpart of serialize_data(): a "RTBS" magic and format
+  // version, then each operator's id and write_state() output. No base64 or
+  // JSON on either side, and buffered windows are written as value columns.
+  Bytes serialize_binary() {
+    Bytes bytes;
+    ByteWriter w(bytes);
+    w.write_bytes(kBinarySnapshotMagic, sizeof(kBinarySnapshotMagic));
+    w.write(kBinarySnapshotVersion);
+    w.write_size(operators_.size());
+    for (auto& [name, op] : operators_) {
+      w.write_string(name);
+      op->write_state(w);
+    }
+    return bytes;
+  }
+
+  void restore_binary(const uint8_t* data, size_t size) {
+    ByteReader r(data, size);
+    char magic[sizeof(kBinarySnapshotMagic)];
+    r.read_bytes(magic, sizeof(magic));
+    if (std::memcmp(magic, kBinarySnapshotMagic, sizeof(magic)) != 0) {
+      throw runtime_error("Not a binary program snapshot");
+    }
+    const auto version = r.read<uint8_t>();
+    if (version != kBinarySnapshotVersion) {
+      throw runtime_error("Unsupported binary snapshot version " + std::to_string(version));
+    }
+    const size_t count = r.read_size();
+    if (count != operators_.size()) {
+      throw runtime_error("Binary snapshot has " + std::to_string(count) + " operators, program has " +
+                          std::to_string(operators_.size()));
     }
+    for (size_t i = 0; i < count; ++i) {
+      const string name = r.read_string();
+      auto it = operators_.find(name);
+      if (it == operators_.end()) {
+        throw runtime_error("Binary snapshot has unknown operator " + name);
+      }
+      it->second->read_state(r);
+      it->second->mark_state_dirty();
+    }
+    if (!r.at_end()) {
+      throw runtime_error("Trailing bytes after binary snapshot");
+    }
+  }
+
+  void restore_binary(const Bytes& bytes) { restore_binary(bytes.data(), bytes.size()); }
+
+  // Incremental checkpoints. checkpoint() is a full snapshot that starts a
+  // chain; each checkpoint_delta() carries only the operators changed since
+  // an earlier checkpoint (the previous one by default), and within them
+  // only the changed KeyedPipeline keys and the Buffer messages appended or
+  // evicted. Every call closes a new epoch. A blob is "RTBC", a version, a
+  // kind byte (0 full, 1 delta), the base epoch, its own epoch, then the
+  // operator entries.
+  //
+  // apply_checkpoint() replays a chain on a program built from the same
+  // JSON: the full checkpoint, then each delta whose base epoch is at or
+  // before the state already applied. restore_checkpoints() does the whole
+  // chain in one call.
+  Bytes checkpoint() { return write_checkpoint(false, 0); }
+
+  Bytes checkpoint_delta() { return checkpoint_delta(checkpoint_epoch_); }
+
+  Bytes checkpoint_delta(uint64_t since_epoch) {
+    if (checkpoint_epoch_ == 0) {
+      throw runtime_error("checkpoint_delta needs a full checkpoint() first");
+    }
+    if (since_epoch == 0 || since_epoch > checkpoint_epoch_) {
+      throw runtime_error("No checkpoint at epoch " + std::to_string(since_epoch) + " (current epoch is " +
+                          std::to_string(checkpoint_epoch_) + ")");
+    }
+    return write_checkpoint(true, since_epoch);
+  }
+
+  void apply_checkpoint(const uint8_t* data, size_t size) {
+    ByteReader r(data, size);
+    char magic[sizeof(kCheckpointMagic)];
+    r.read_bytes(magic, sizeof(magic));
+    if (std::memcmp(magic, kCheckpointMagic, sizeof(magic)) != 0) {
+      throw runtime_error("Not a program checkpoint");
+    }
+    const auto version = r.read<uint8_t>();
+    if (version != kCheckpointVersion) {
+      throw runtime_error("Unsupported checkpoint version " + std::to_string(version));
+    }
+    const bool delta = r.read<uint8_t>() != 0;
+    const uint64_t since_epoch = r.read_varint();
+    const uint64_t epoch = r.read_varint();
+    if (delta && (since_epoch > checkpoint_epoch_ || epoch <= checkpoint_epoch_ || checkpoint_epoch_ == 0)) {
+      throw runtime_error("Checkpoint delta " + std::to_string(since_epoch) + "->" + std::to_string(epoch) +
+                          " does not apply at epoch " + std::to_string(checkpoint_epoch_));
+    }
+    const size_t count = r.read_size();
+    if (!delta && count != operators_.size()) {
+      throw runtime_error("Checkpoint has " + std::to_string(count) + " operators, program has " +
+                          std::to_string(operators_.size()));
+    }
+    for (size_t i = 0; i < count; ++i) {
+      const string name = r.read_string();
+      auto it = operators_.find(name);
+      if (it == operators_.end()) {
+        throw runtime_error("Checkpoint has unknown operator " + name);
+      }
+      if (delta) {
+        it->second->read_delta(r);
+      } else {
+        it->second->read_state(r);
+      }
+      it->second->mark_state_dirty();
+    }
+    if (!r.at_end()) {
+      throw runtime_error("Trailing bytes after checkpoint");
+    }
+    close_checkpoint_epoch(epoch);
+  }
+
+  void apply_checkpoint(const Bytes& bytes) { apply_checkpoint(bytes.data(), bytes.size()); }
+
+  void restore_checkpoints(const vector<Bytes>& chain) {
+    for (const auto& bytes : chain) apply_checkpoint(bytes);
+  }
+
+  uint64_t checkpoint_epoch() const { return checkpoint_epoch_; }
+
+  // Runtime profiling: switch per-operator counters (OperatorProfile) on or
+  // off for every operator, composite children included. `latency` adds a
+  // per-execute LatencyHistogram to each. Enabling resets the counters.
+  void set_profiling(bool enabled, bool latency = false) {
+    for_each_operator_([&](const std::string&, const std::shared_ptr<Operator>& op) {
+      op->enable_profiling(enabled, latency);
+    });
+    profiling_ = enabled;
+  }
+
+  bool profiling() const { return profiling_; }
+
+  // Per-call latency histogram of receive / receive_batch / receive_buffer.
+  void set_receive_latency(bool enabled) {
+    receive_latency_ = enabled ? std::make_unique<LatencyHistogram>() : nullptr;
+  }
+
+  const LatencyHistogram* receive_latency() const { return receive_latency_.get(); }
+
+  void reset_profile() {
+    for_each_operator_([](const std::string&, const std::shared_ptr<Operator>& op) { op->reset_profile(); });
+    if (receive_latency_) receive_latency_->reset();
+  }
+
+  // {"enabled": bool, "operators": {id: {type, counters...}}}, composite
+  // children keyed by their "parent::child" qualified id. Empty operators
+  // object while profiling is off.
+  json profile_json() const {
+    json ops = json::object();
+    for_each_operator_([&](const std::string& qualified_id, const std::shared_ptr<Operator>& op) {
+      const OperatorProfile* p = op->profile();
+      if (!p) return;
+      ops[qualified_id] = {{"type", op->type_name()},
+                           {"messages_in", p->messages_in},
+                           {"messages_out", p->messages_out},
+                           {"executions", p->executions},
+                           {"process_ns", p->process_ns},
+                           {"clones", p->clones},
+                           {"queue_high_water", p->queue_high_water}};
+    });
+    return {{"enabled", profiling_}, {"operators", ops}};
+  }
+
+  // {"receive": summary | null, "operators": {id: summary}} with summary =
+  // {count, min, max, mean, p50, p90, p99, p999} in nanoseconds. Operators
+  // appear only while profiling with latency histograms.
+  json latency_json() const {
+    auto summary = [](const LatencyHistogram& h) {
+      return json{{"count", h.count()},          {"min", h.min()},
+                  {"max", h.max()},              {"mean", h.mean()},
+                  {"p50", h.percentile(50)},     {"p90", h.percentile(90)},
+                  {"p99", h.percentile(99)},     {"p999", h.percentile(99.9)}};
+    };
+    json ops = json::object();
+    for_each_operator_([&](const std::string& qualified_id, const std::shared_ptr<Operator>& op) {
+      const OperatorProfile* p = op->profile();
+      if (p && p->execute_latency) ops[qualified_id] = summary(*p->execute_latency);
+    });
+    return {{"receive", receive_latency_ ? summary(*receive_latency_) : json(nullptr)}, {"operators", ops}};
+  }
+
+  // Text table of the same histograms, one row each, for CLI tools.
+  void print_latency(std::ostream& os) const {
+    LatencyHistogram::dump_header(os);
+    if (receive_latency_) receive_latency_->dump(os, "receive");
+    for_each_operator_([&](const std::string& qualified_id, const std::shared_ptr<Operator>& op) {
+      const OperatorProfile* p = op->profile();
+      if (p && p->execute_latency) p->execute_latency->dump(os, qualified_id + " (" + op->type_name() + ")");
+    });
   }
 
   // Message processing
   ProgramMsgBatch receive(std::unique_ptr<BaseMessage> msg, const std::string& port_id = "i1") {
+    ScopedLatency latency(receive_latency_.get());
+    MessageArena::Scope arena(message_arena_);
     send_to_entry(std::move(msg), port_id, false);
     return collect_outputs(false);
   }
@@ -75,6 +282,7 @@ class Program {
     for (auto& [_, op] : operators_) {
       op->clear_debug_output_queues();
     }
+    MessageArena::Scope arena(message_arena_);
     send_to_entry(std::move(msg), port_id, true);
     return collect_outputs(true);
   }
@@ -93,6 +301,8 @@ class Program {
   // how many messages are queued on each port.
   ProgramMsgBatch receive_batch(
       const std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>>& port_messages) {
+    ScopedLatency latency(receive_latency_.get());
+    MessageArena::Scope arena(message_arena_);
     send_batch_to_entry(port_messages, false);
     return collect_outputs(false);
   }
@@ -110,9 +320,11 @@ class Program {
                                    const timestamp_t* times) {
     auto port_info = OperatorJson::parse_port_name(port_id);
     auto& entry = operators_[entry_operator_id_];
+    ScopedLatency latency(receive_latency_.get());
+    MessageArena::Scope arena(message_arena_);
     entry->receive_data_buffer(data, num_rows, num_cols, times,
                                  port_info.index, /*debug=*/false);
-    entry->execute(false);
+    schedule_.run(false);
     return collect_outputs(false);
   }
 
@@ -121,6 +333,7 @@ class Program {
     for (auto& [_, op] : operators_) {
       op->clear_debug_output_queues();
     }
+    MessageArena::Scope arena(message_arena_);
     send_batch_to_entry(port_messages, true);
     return collect_outputs(true);
   }
@@ -133,6 +346,43 @@ class Program {
   // Static factory methods
 
  private:
+  static constexpr char kBinarySnapshotMagic[4] = {'R', 'T', 'B', 'S'};
+  static constexpr uint8_t kBinarySnapshotVersion = 1;
+  static constexpr char kCheckpointMagic[4] = {'R', 'T', 'B', 'C'};
+  static constexpr uint8_t kCheckpointVersion = 1;
+
+  Bytes write_checkpoint(bool delta, uint64_t since_epoch) {
+    const uint64_t epoch = checkpoint_epoch_ + 1;
+    Bytes bytes;
+    ByteWriter w(bytes);
+    w.write_bytes(kCheckpointMagic, sizeof(kCheckpointMagic));
+    w.write(kCheckpointVersion);
+    w.write<uint8_t>(delta ? 1 : 0);
+    w.write_varint(since_epoch);
+    w.write_varint(epoch);
+    size_t count = 0;
+    for (auto& [name, op] : operators_) {
+      if (!delta || op->modified_since(since_epoch)) ++count;
+    }
+    w.write_size(count);
+    for (auto& [name, op] : operators_) {
+      if (delta && !op->modified_since(since_epoch)) continue;
+      w.write_string(name);
+      if (delta) {
+        op->write_delta(w, since_epoch);
+      } else {
+        op->write_state(w);
+      }
+    }
+    close_checkpoint_epoch(epoch);
+    return bytes;
+  }
+
+  void close_checkpoint_epoch(uint64_t epoch) {
+    checkpoint_epoch_ = epoch;
+    for (auto& [name, op] : operators_) op->mark_checkpoint(epoch);
+  }
+
   string program_json_;
   map<string, shared_ptr<Operator>> operators_;
   string entry_operator_id_;
@@ -143,6 +393,19 @@ class Program {
   // receive_data). Provenance (source operator + output port) is read from
   // each port's inbound connection ref — no separate index needed.
   std::shared_ptr<Collector> sink_;
+  // Flat topological execution order of everything reachable from the entry
+  // operator (sink included), compiled once the graph is wired. Replaces the
+  // recursive entry->execute() walk on every receive path.
+  ExecutionSchedule schedule_;
+  // Opt-in ("messageArena": true): run each receive call inside a
+  // MessageArena::Scope so its transient messages are bump-allocated.
+  bool message_arena_{false};
+  // Last epoch closed by checkpoint() / checkpoint_delta() / apply_checkpoint().
+  uint64_t checkpoint_epoch_{0};
+  // Opt-in ("profile": true) or set_profiling(): per-operator counters.
+  bool profiling_{false};
+  // Opt-in ("receiveLatency": true) or set_receive_latency().
+  std::unique_ptr<LatencyHistogram> receive_latency_;
 
   void init_from_json() {
     RTBOT_LOG_DEBUG("Initializing program from JSON");
@@ -179,6 +442,45 @@ class Program {
 
     // Attach Program-owned sinks to output-mapped operators.
     setup_output_sinks_();
+
+    schedule_.compile(operators_[entry_operator_id_].get());
+
+    // Optional per-port queue preallocation, so the first bursts after
+    // construction do not pay for queue growth on the hot path.
+    if (j.contains("queueCapacity")) {
+      reserve_queues_(j["queueCapacity"].get<size_t>());
+    }
+
+    message_arena_ = j.value("messageArena", false);
+
+    // "operatorLatency" implies profiling, which carries the histograms.
+    const bool operator_latency = j.value("operatorLatency", false);
+    if (j.value("profile", false) || operator_latency) set_profiling(true, operator_latency);
+    if (j.value("receiveLatency", false)) set_receive_latency(true);
+  }
+
+  // Visits every operator, descending into composite children, with its
+  // qualified ("parent::child") id.
+  void for_each_operator_(const std::function<void(const string&, const shared_ptr<Operator>&)>& fn) const {
+    std::function<void(const string&, const shared_ptr<Operator>&)> visit = [&](const string& qualified_id,
+                                                                                const shared_ptr<Operator>& op) {
+      fn(qualified_id, op);
+      if (const auto* kids = op->children_ops()) {
+        for (const auto& [kid_id, kid] : *kids) visit(qualified_id + "::" + kid_id, kid);
+      }
+    };
+    for (const auto& [op_id, op] : operators_) visit(op_id, op);
+  }
+
+  void reserve_queues_(size_t capacity) {
+    std::function<void(const std::shared_ptr<Operator>&)> reserve = [&](const std::shared_ptr<Operator>& op) {
+      op->reserve_queues(capacity);
+      if (const auto* kids = op->children_ops()) {
+        for (const auto& [_, kid] : *kids) reserve(kid);
+      }
+    };
+    for (const auto& [_, op] : operators_) reserve(op);
+    if (sink_) sink_->reserve_queues(capacity);
   }
 
   void setup_output_sinks_() {
@@ -268,7 +570,7 @@ class Program {
   void send_to_entry(std::unique_ptr<BaseMessage> msg, const std::string& port_id, bool debug = false) {
     auto port_info = OperatorJson::parse_port_name(port_id);
     operators_[entry_operator_id_]->receive_data(std::move(msg), port_info.index);
-    operators_[entry_operator_id_]->execute(debug);
+    schedule_.run(debug);
   }
 
   void send_batch_to_entry(
@@ -287,7 +589,7 @@ class Program {
       }
       entry->receive_data_batch(cloned, port_info.index, debug);
     }
-    entry->execute(debug);
+    schedule_.run(debug);
   }
 
   ProgramMsgBatch collect_outputs(bool debug_mode = false) {
@@ -481,10 +783,48 @@ class ProgramManager {
 
   string serialize_program_data(const string& program_id) { return get_program(program_id).serialize_data(); }
 
+  string get_program_profile(const string& program_id) { return get_program(program_id).profile_json().dump(); }
+
+  void set_program_profiling(const string& program_id, bool enabled) {
+    get_program(program_id).set_profiling(enabled);
+  }
+
+  void reset_program_profile(const string& program_id) { get_program(program_id).reset_profile(); }
+
+  string get_program_latency(const string& program_id) { return get_program(program_id).latency_json().dump(); }
+
+  void set_program_latency(const string& program_id, bool receive, bool operators) {
+    auto& program = get_program(program_id);
+    program.set_receive_latency(receive);
+    if (operators) {
+      program.set_profiling(true, true);
+    } else if (program.profiling()) {
+      program.set_profiling(true, false);
+    }
+  }
+
   void restore_program_data_from_json(const string& program_id, const string& json_state) {
     get_program(program_id).restore_data_from_json(json_state);
   }
 
+  Bytes serialize_program_binary(const string& program_id) { return get_program(program_id).serialize_binary(); }
+
+  void restore_program_binary(const string& program_id, const uint8_t* data, size_t size) {
+    get_program(program_id).restore_binary(data, size);
+  }
+
+  Bytes checkpoint_program(const string& program_id) { return get_program(program_id).checkpoint(); }
+
+  Bytes checkpoint_program_delta(const string& program_id) { return get_program(program_id).checkpoint_delta(); }
+
+  void apply_program_checkpoint(const string& program_id, const uint8_t* data, size_t size) {
+    get_program(program_id).apply_checkpoint(data, size);
+  }
+
+  uint64_t get_program_checkpoint_epoch(const string& program_id) {
+    return get_program(program_id).checkpoint_epoch();
+  }
+
   bool delete_program(const string& program_id) {
     vector_builders_.erase(program_id);
     return programs_.erase(program_id) > 0;
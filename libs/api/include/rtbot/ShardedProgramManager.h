@@ -0,0 +1,266 @@
+#ifndef SHARDED_PROGRAM_MANAGER_H
+#define SHARDED_PROGRAM_MANAGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rtbot/MpmcRing.h"
+#include "rtbot/Program.h"
+
+namespace rtbot {
+
+// Multi-threaded counterpart of ProgramManager for processes hosting many
+// independent programs.
+//
+// Every program is pinned to one shard (hash of its id) and each shard owns a
+// worker thread, the Program objects assigned to it, a lock-free ingress ring
+// and a completion ring. Clients never touch a Program directly: every call
+// enqueues a request and returns a ticket; the worker executes requests in
+// ring order and publishes one Result per ticket on the shard's completion
+// ring. Because a program lives on exactly one shard and a shard drains its
+// ring in FIFO order, the batches a client submits to a program are executed
+// in submission order — output is the same as feeding them to a single
+// Program sequentially.
+//
+// Submitting blocks (spins, then yields) only while the target shard's
+// ingress ring is full. Workers never block: when the completion ring is full
+// results wait in a worker-local overflow list until the client polls.
+class ShardedProgramManager {
+ public:
+  using PortBatch = std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>>;
+
+  struct Result {
+    uint64_t ticket{0};
+    std::string program_id;
+    ProgramMsgBatch batch;  // outputs of process_batch
+    std::string payload;    // serialize_program_data state
+    std::string error;      // non-empty when the request failed
+  };
+
+  explicit ShardedProgramManager(size_t num_shards, size_t ring_capacity = 4096) {
+    if (num_shards == 0) {
+      throw std::runtime_error("ShardedProgramManager requires at least one shard");
+    }
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.push_back(std::make_unique<Shard>(ring_capacity));
+    }
+    for (auto& shard : shards_) {
+      Shard* s = shard.get();
+      s->worker = std::thread([this, s] { run_worker(*s); });
+    }
+  }
+
+  ShardedProgramManager(const ShardedProgramManager&) = delete;
+  ShardedProgramManager& operator=(const ShardedProgramManager&) = delete;
+
+  // Pending requests are executed before the workers exit; undelivered
+  // results are dropped.
+  ~ShardedProgramManager() {
+    running_.store(false, std::memory_order_release);
+    for (auto& shard : shards_) {
+      if (shard->worker.joinable()) shard->worker.join();
+    }
+  }
+
+  size_t num_shards() const { return shards_.size(); }
+
+  size_t shard_of(const std::string& program_id) const { return std::hash<std::string>{}(program_id) % shards_.size(); }
+
+  uint64_t create_program(const std::string& program_id, const std::string& json_program) {
+    return submit(RequestKind::CREATE, program_id, json_program, {});
+  }
+
+  uint64_t delete_program(const std::string& program_id) { return submit(RequestKind::DELETE, program_id, {}, {}); }
+
+  // Equivalent of ProgramManager::process_message_buffer for a pre-built
+  // buffer: all messages are ingested by one receive_batch() call.
+  uint64_t process_batch(const std::string& program_id, PortBatch batch, bool debug = false) {
+    return submit(debug ? RequestKind::BATCH_DEBUG : RequestKind::BATCH, program_id, {}, std::move(batch));
+  }
+
+  uint64_t serialize_program_data(const std::string& program_id) {
+    return submit(RequestKind::SERIALIZE, program_id, {}, {});
+  }
+
+  uint64_t restore_program_data_from_json(const std::string& program_id, const std::string& json_state) {
+    return submit(RequestKind::RESTORE, program_id, json_state, {});
+  }
+
+  // Non-blocking: move every result currently published by any shard into
+  // `out`. Results of one program appear in ticket order.
+  size_t poll_results(std::vector<Result>& out) {
+    size_t n = 0;
+    Result r;
+    for (auto& shard : shards_) {
+      while (shard->completions.try_pop(r)) {
+        out.push_back(std::move(r));
+        ++n;
+      }
+    }
+    return n;
+  }
+
+  // Block until every request submitted so far has completed, collecting the
+  // results into `out` while waiting.
+  void drain_results(std::vector<Result>& out) {
+    for (;;) {
+      poll_results(out);
+      bool done = true;
+      for (auto& shard : shards_) {
+        if (shard->published.load(std::memory_order_acquire) != shard->submitted.load(std::memory_order_acquire)) {
+          done = false;
+          break;
+        }
+      }
+      if (done) {
+        poll_results(out);
+        return;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  enum class RequestKind : uint8_t { CREATE, DELETE, BATCH, BATCH_DEBUG, SERIALIZE, RESTORE };
+
+  struct Request {
+    RequestKind kind{RequestKind::BATCH};
+    uint64_t ticket{0};
+    std::string program_id;
+    std::string payload;
+    PortBatch batch;
+  };
+
+  struct Shard {
+    explicit Shard(size_t capacity) : ingress(capacity), completions(capacity) {}
+
+    MpmcRing<Request> ingress;
+    MpmcRing<Result> completions;
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> published{0};
+    // Worker-thread only.
+    std::unordered_map<std::string, Program> programs;
+    std::deque<Result> overflow;
+    std::thread worker;
+  };
+
+  uint64_t submit(RequestKind kind, const std::string& program_id, std::string payload, PortBatch batch) {
+    Shard& shard = *shards_[shard_of(program_id)];
+    Request req;
+    req.kind = kind;
+    req.ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+    req.program_id = program_id;
+    req.payload = std::move(payload);
+    req.batch = std::move(batch);
+    const uint64_t ticket = req.ticket;
+    shard.submitted.fetch_add(1, std::memory_order_release);
+    while (!shard.ingress.try_push(req)) {
+      std::this_thread::yield();
+    }
+    return ticket;
+  }
+
+  void run_worker(Shard& shard) {
+    Request req;
+    unsigned idle = 0;
+    for (;;) {
+      flush_overflow(shard);
+      if (shard.ingress.try_pop(req)) {
+        idle = 0;
+        publish(shard, execute(shard, req));
+        continue;
+      }
+      if (!running_.load(std::memory_order_acquire)) return;
+      // Back off: spin briefly for latency, then yield, then sleep so idle
+      // shards do not burn a core.
+      if (++idle < 64) continue;
+      if (idle < 1024) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+  }
+
+  Result execute(Shard& shard, Request& req) {
+    Result result;
+    result.ticket = req.ticket;
+    result.program_id = std::move(req.program_id);
+    try {
+      if (req.kind == RequestKind::CREATE) {
+        if (shard.programs.count(result.program_id) > 0) {
+          result.error = "Program " + result.program_id + " already exists";
+        } else {
+          shard.programs.emplace(result.program_id, Program(req.payload));
+        }
+        return result;
+      }
+      if (req.kind == RequestKind::DELETE) {
+        if (shard.programs.erase(result.program_id) == 0) {
+          result.error = "Program " + result.program_id + " not found";
+        }
+        return result;
+      }
+      auto it = shard.programs.find(result.program_id);
+      if (it == shard.programs.end()) {
+        result.error = "Program " + result.program_id + " not found";
+        return result;
+      }
+      switch (req.kind) {
+        case RequestKind::BATCH:
+          result.batch = it->second.receive_batch(req.batch);
+          break;
+        case RequestKind::BATCH_DEBUG:
+          result.batch = it->second.receive_batch_debug(req.batch);
+          break;
+        case RequestKind::SERIALIZE:
+          result.payload = it->second.serialize_data();
+          break;
+        case RequestKind::RESTORE:
+          it->second.restore_data_from_json(req.payload);
+          break;
+        default:
+          break;
+      }
+    } catch (const std::exception& e) {
+      result.error = e.what();
+    }
+    req.batch.clear();
+    req.payload.clear();
+    return result;
+  }
+
+  void publish(Shard& shard, Result result) {
+    if (shard.overflow.empty() && shard.completions.try_push(result)) {
+      shard.published.fetch_add(1, std::memory_order_release);
+      return;
+    }
+    shard.overflow.push_back(std::move(result));
+  }
+
+  void flush_overflow(Shard& shard) {
+    while (!shard.overflow.empty() && shard.completions.try_push(shard.overflow.front())) {
+      shard.overflow.pop_front();
+      shard.published.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<bool> running_{true};
+  std::atomic<uint64_t> next_ticket_{1};
+};
+
+}  // namespace rtbot
+
+#endif  // SHARDED_PROGRAM_MANAGER_H
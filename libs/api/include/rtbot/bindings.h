@@ -25,10 +25,30 @@ void to_json(json& j, const ProgramMsgBatch& batch);
 // Program serialization and lifecycle
 std::string serialize_program_data(const std::string& program_id);
 void restore_program_data_from_json(const std::string& program_id, const std::string& json_state);
+// Compact binary snapshot (see Program::serialize_binary); raw bytes, not base64.
+std::vector<uint8_t> serialize_program_binary(const std::string& program_id);
+void restore_program_binary(const std::string& program_id, const std::vector<uint8_t>& snapshot);
+// Incremental checkpoints (see Program::checkpoint_delta): a full checkpoint
+// starts a chain, each delta carries only what changed since the previous one.
+std::vector<uint8_t> checkpoint_program(const std::string& program_id);
+std::vector<uint8_t> checkpoint_program_delta(const std::string& program_id);
+void apply_program_checkpoint(const std::string& program_id, const std::vector<uint8_t>& checkpoint);
+uint64_t get_program_checkpoint_epoch(const std::string& program_id);
 std::string create_program(const std::string& program_id, const std::string& json_program);
 std::string delete_program(const std::string& program_id);
 std::string get_program_entry_operator_id(const std::string& program_id);
 
+// Runtime profiling: per-operator counters as JSON (see Program::profile_json)
+std::string get_program_profile(const std::string& program_id);
+void set_program_profiling(const std::string& program_id, bool enabled);
+void reset_program_profile(const std::string& program_id);
+
+// Latency histograms: per-call receive latency and per-operator execute
+// latency as p50/p90/p99/p999 JSON (see Program::latency_json). Turning the
+// operator histograms on or off restarts the profiling counters.
+std::string get_program_latency(const std::string& program_id);
+void set_program_latency(const std::string& program_id, bool receive, bool operators);
+
 // Validation functions
 std::string validate_program(const std::string& json_program);
 std::string validate_operator(const std::string& type, const std::string& json_op);
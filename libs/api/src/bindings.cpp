@@ -29,7 +29,7 @@ void to_json(json& j, const ProgramMsgBatch& batch) {
         if (auto* num_msg = dynamic_cast<const Message<NumberData>*>(msg.get())) {
           j[op_id][port_name].push_back({{"time", num_msg->time}, {"value", num_msg->data.value}});
         } else if (auto* vec_num_msg = dynamic_cast<const Message<VectorNumberData>*>(msg.get())) {
-          j[op_id][port_name].push_back({{"time", vec_num_msg->time}, {"value", *vec_num_msg->data.values}});
+          j[op_id][port_name].push_back({{"time", vec_num_msg->time}, {"value", *vec_num_msg->data.materialize()}});
         } else if (auto* bool_msg = dynamic_cast<const Message<BooleanData>*>(msg.get())) {
           j[op_id][port_name].push_back({{"time", bool_msg->time}, {"value", bool_msg->data.value}});
         } else if (auto* vec_bool_msg = dynamic_cast<const Message<VectorBooleanData>*>(msg.get())) {
@@ -48,6 +48,50 @@ void restore_program_data_from_json(const std::string& program_id, const std::st
   ProgramManager::instance().restore_program_data_from_json(program_id, json_state);
 }
 
+std::vector<uint8_t> serialize_program_binary(const std::string& program_id) {
+  return ProgramManager::instance().serialize_program_binary(program_id);
+}
+
+void restore_program_binary(const std::string& program_id, const std::vector<uint8_t>& snapshot) {
+  ProgramManager::instance().restore_program_binary(program_id, snapshot.data(), snapshot.size());
+}
+
+std::vector<uint8_t> checkpoint_program(const std::string& program_id) {
+  return ProgramManager::instance().checkpoint_program(program_id);
+}
+
+std::vector<uint8_t> checkpoint_program_delta(const std::string& program_id) {
+  return ProgramManager::instance().checkpoint_program_delta(program_id);
+}
+
+void apply_program_checkpoint(const std::string& program_id, const std::vector<uint8_t>& checkpoint) {
+  ProgramManager::instance().apply_program_checkpoint(program_id, checkpoint.data(), checkpoint.size());
+}
+
+uint64_t get_program_checkpoint_epoch(const std::string& program_id) {
+  return ProgramManager::instance().get_program_checkpoint_epoch(program_id);
+}
+
+std::string get_program_profile(const std::string& program_id) {
+  return ProgramManager::instance().get_program_profile(program_id);
+}
+
+void set_program_profiling(const std::string& program_id, bool enabled) {
+  ProgramManager::instance().set_program_profiling(program_id, enabled);
+}
+
+void reset_program_profile(const std::string& program_id) {
+  ProgramManager::instance().reset_program_profile(program_id);
+}
+
+std::string get_program_latency(const std::string& program_id) {
+  return ProgramManager::instance().get_program_latency(program_id);
+}
+
+void set_program_latency(const std::string& program_id, bool receive, bool operators) {
+  ProgramManager::instance().set_program_latency(program_id, receive, operators);
+}
+
 std::string validate_program(const std::string& json_program) {
   nlohmann::json_schema::json_validator validator(nullptr, nlohmann::json_schema::default_string_format_check);
 
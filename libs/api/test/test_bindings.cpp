@@ -115,6 +115,197 @@ SCENARIO("Bindings handle program creation and message processing", "[bindings]"
   }
 }
 
+SCENARIO("Bindings expose per-operator profiling", "[bindings][profile]") {
+  std::string program_json = R"({
+          "profile": true,
+          "operators": [
+              {"type": "Input", "id": "input1", "portTypes": ["number"]},
+              {"type": "MovingAverage", "id": "ma1", "window_size": 3},
+              {"type": "Output", "id": "output1", "portTypes": ["number"]}
+          ],
+          "connections": [
+              {"from": "input1", "to": "ma1", "fromPort": "o1", "toPort": "i1"},
+              {"from": "ma1", "to": "output1", "fromPort": "o1", "toPort": "i1"}
+          ],
+          "entryOperator": "input1",
+          "output": { "output1": ["o1"] }
+      })";
+  REQUIRE(create_program("test_prog_profile", program_json).empty());
+  process_batch("test_prog_profile", {1, 2, 3, 4}, {3.0, 6.0, 9.0, 12.0}, {"i1", "i1", "i1", "i1"});
+
+  WHEN("The program was created with \"profile\": true") {
+    auto profile = json::parse(get_program_profile("test_prog_profile"));
+
+    THEN("Every operator reports its counters") {
+      REQUIRE(profile["enabled"].get<bool>());
+      const auto& ops = profile["operators"];
+      REQUIRE(ops["input1"]["type"] == "Input");
+      REQUIRE(ops["input1"]["messages_in"] == 4);
+      REQUIRE(ops["input1"]["messages_out"] == 4);
+      REQUIRE(ops["input1"]["queue_high_water"] == 4);
+      REQUIRE(ops["ma1"]["messages_in"] == 4);
+      REQUIRE(ops["ma1"]["messages_out"] == 2);
+      REQUIRE(ops["output1"]["messages_in"] == 2);
+      REQUIRE(ops["ma1"]["executions"].get<uint64_t>() >= 1);
+      REQUIRE(ops["ma1"].contains("process_ns"));
+      REQUIRE(ops["ma1"]["clones"] == 0);
+    }
+  }
+
+  WHEN("Profiling is switched off and on again") {
+    set_program_profiling("test_prog_profile", false);
+    auto off = json::parse(get_program_profile("test_prog_profile"));
+    set_program_profiling("test_prog_profile", true);
+    process_batch("test_prog_profile", {5}, {15.0}, {"i1"});
+    auto on = json::parse(get_program_profile("test_prog_profile"));
+
+    THEN("Counters are dropped, then restart from zero") {
+      REQUIRE_FALSE(off["enabled"].get<bool>());
+      REQUIRE(off["operators"].empty());
+      REQUIRE(on["operators"]["input1"]["messages_in"] == 1);
+      REQUIRE(on["operators"]["ma1"]["messages_out"] == 1);
+    }
+  }
+
+  WHEN("The counters are reset") {
+    reset_program_profile("test_prog_profile");
+    auto profile = json::parse(get_program_profile("test_prog_profile"));
+    THEN("They read zero") {
+      REQUIRE(profile["operators"]["input1"]["messages_in"] == 0);
+      REQUIRE(profile["operators"]["ma1"]["process_ns"] == 0);
+    }
+  }
+
+  delete_program("test_prog_profile");
+  REQUIRE_THROWS_AS(get_program_profile("test_prog_profile"), std::runtime_error);
+}
+
+SCENARIO("Bindings expose latency histograms", "[bindings][latency]") {
+  std::string program_json = R"({
+          "receiveLatency": true,
+          "operators": [
+              {"type": "Input", "id": "input1", "portTypes": ["number"]},
+              {"type": "MovingAverage", "id": "ma1", "window_size": 3},
+              {"type": "Output", "id": "output1", "portTypes": ["number"]}
+          ],
+          "connections": [
+              {"from": "input1", "to": "ma1", "fromPort": "o1", "toPort": "i1"},
+              {"from": "ma1", "to": "output1", "fromPort": "o1", "toPort": "i1"}
+          ],
+          "entryOperator": "input1",
+          "output": { "output1": ["o1"] }
+      })";
+  REQUIRE(create_program("test_prog_latency", program_json).empty());
+
+  WHEN("Only receive latency is on") {
+    for (uint64_t t = 1; t <= 10; ++t) process_batch("test_prog_latency", {t}, {1.0 * t}, {"i1"});
+    auto latency = json::parse(get_program_latency("test_prog_latency"));
+
+    THEN("Every call is recorded and operators are absent") {
+      REQUIRE(latency["receive"]["count"] == 10);
+      REQUIRE(latency["receive"]["p50"].get<uint64_t>() <= latency["receive"]["p99"].get<uint64_t>());
+      REQUIRE(latency["receive"]["p999"].get<uint64_t>() <= latency["receive"]["max"].get<uint64_t>());
+      REQUIRE(latency["operators"].empty());
+    }
+  }
+
+  WHEN("Operator latency is switched on") {
+    set_program_latency("test_prog_latency", true, true);
+    process_batch("test_prog_latency", {1, 2, 3}, {1.0, 2.0, 3.0}, {"i1", "i1", "i1"});
+    auto latency = json::parse(get_program_latency("test_prog_latency"));
+    auto profile = json::parse(get_program_profile("test_prog_latency"));
+
+    THEN("Each operator reports one sample per execute") {
+      REQUIRE(latency["receive"]["count"] == 1);
+      REQUIRE(latency["operators"]["ma1"]["count"] == profile["operators"]["ma1"]["executions"]);
+      REQUIRE(latency["operators"].contains("input1"));
+    }
+  }
+
+  WHEN("Latency tracking is switched off") {
+    set_program_latency("test_prog_latency", false, false);
+    auto latency = json::parse(get_program_latency("test_prog_latency"));
+    THEN("Nothing is reported") {
+      REQUIRE(latency["receive"].is_null());
+      REQUIRE(latency["operators"].empty());
+    }
+  }
+
+  delete_program("test_prog_latency");
+}
+
+SCENARIO("Bindings copy program state through binary snapshots", "[bindings][State]") {
+  std::string program_json = R"({
+          "operators": [
+              {"type": "Input", "id": "input1", "portTypes": ["number"]},
+              {"type": "MovingAverage", "id": "ma1", "window_size": 3},
+              {"type": "Output", "id": "output1", "portTypes": ["number"]}
+          ],
+          "connections": [
+              {"from": "input1", "to": "ma1", "fromPort": "o1", "toPort": "i1"},
+              {"from": "ma1", "to": "output1", "fromPort": "o1", "toPort": "i1"}
+          ],
+          "entryOperator": "input1",
+          "output": { "output1": ["o1"] }
+      })";
+  REQUIRE(create_program("test_prog_snap_a", program_json).empty());
+  REQUIRE(create_program("test_prog_snap_b", program_json).empty());
+  process_batch("test_prog_snap_a", {1, 2}, {3.0, 6.0}, {"i1", "i1"});
+
+  const auto snapshot = serialize_program_binary("test_prog_snap_a");
+  restore_program_binary("test_prog_snap_b", snapshot);
+
+  THEN("The restored program continues from the same window") {
+    auto a = json::parse(process_batch("test_prog_snap_a", {3}, {9.0}, {"i1"}));
+    auto b = json::parse(process_batch("test_prog_snap_b", {3}, {9.0}, {"i1"}));
+    REQUIRE(b == a);
+    REQUIRE(b["output1"]["o1"][0]["value"] == Approx(6.0));
+  }
+
+  THEN("Garbage is rejected") {
+    REQUIRE_THROWS_AS(restore_program_binary("test_prog_snap_b", std::vector<uint8_t>{1, 2, 3}), std::runtime_error);
+  }
+
+  delete_program("test_prog_snap_a");
+  delete_program("test_prog_snap_b");
+}
+
+SCENARIO("Bindings replay a checkpoint chain", "[bindings][State]") {
+  std::string program_json = R"({
+          "operators": [
+              {"type": "Input", "id": "input1", "portTypes": ["number"]},
+              {"type": "MovingAverage", "id": "ma1", "window_size": 3},
+              {"type": "Output", "id": "output1", "portTypes": ["number"]}
+          ],
+          "connections": [
+              {"from": "input1", "to": "ma1", "fromPort": "o1", "toPort": "i1"},
+              {"from": "ma1", "to": "output1", "fromPort": "o1", "toPort": "i1"}
+          ],
+          "entryOperator": "input1",
+          "output": { "output1": ["o1"] }
+      })";
+  REQUIRE(create_program("test_prog_ckpt_a", program_json).empty());
+  REQUIRE(create_program("test_prog_ckpt_b", program_json).empty());
+
+  process_batch("test_prog_ckpt_a", {1, 2}, {3.0, 6.0}, {"i1", "i1"});
+  const auto base = checkpoint_program("test_prog_ckpt_a");
+  process_batch("test_prog_ckpt_a", {3, 4}, {9.0, 12.0}, {"i1", "i1"});
+  const auto delta = checkpoint_program_delta("test_prog_ckpt_a");
+  REQUIRE(get_program_checkpoint_epoch("test_prog_ckpt_a") == 2);
+
+  apply_program_checkpoint("test_prog_ckpt_b", base);
+  apply_program_checkpoint("test_prog_ckpt_b", delta);
+  REQUIRE(get_program_checkpoint_epoch("test_prog_ckpt_b") == 2);
+
+  auto a = json::parse(process_batch("test_prog_ckpt_a", {5}, {15.0}, {"i1"}));
+  auto b = json::parse(process_batch("test_prog_ckpt_b", {5}, {15.0}, {"i1"}));
+  REQUIRE(b == a);
+  REQUIRE(b["output1"]["o1"][0]["value"] == Approx(12.0));
+
+  delete_program("test_prog_ckpt_a");
+  delete_program("test_prog_ckpt_b");
+}
+
 SCENARIO("Bindings support staged vector messages", "[bindings][vector]") {
   auto& manager = ProgramManager::instance();
   manager.clear_all_programs();
@@ -0,0 +1,164 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rtbot/PipelinedProgram.h"
+#include "tools.h"
+
+using namespace rtbot;
+
+// Defined in integration_test_rsi_program.cpp.
+std::string create_rsi_program(size_t n);
+
+namespace {
+
+// Same topology as the std integration_test_ppg pipeline.
+std::string ppg_program(int short_window, int long_window) {
+  return R"({
+    "entryOperator": "i1",
+    "output": { "o1": ["o1"] },
+    "operators": [
+      {"id": "i1", "type": "Input", "portTypes": ["number"]},
+      {"id": "ma1", "type": "MovingAverage", "window_size": )" +
+         std::to_string(short_window) + R"(},
+      {"id": "ma2", "type": "MovingAverage", "window_size": )" +
+         std::to_string(long_window) + R"(},
+      {"id": "diff", "type": "Subtraction"},
+      {"id": "peak", "type": "PeakDetector", "window_size": )" +
+         std::to_string(2 * short_window + 1) + R"(},
+      {"id": "join", "type": "Join", "portTypes": ["number", "number"]},
+      {"id": "o1", "type": "Output", "portTypes": ["number"]}
+    ],
+    "connections": [
+      {"from": "i1", "to": "ma1", "fromPort": "o1", "toPort": "i1"},
+      {"from": "i1", "to": "ma2", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ma1", "to": "diff", "fromPort": "o1", "toPort": "i1"},
+      {"from": "ma2", "to": "diff", "fromPort": "o1", "toPort": "i2"},
+      {"from": "diff", "to": "peak", "fromPort": "o1", "toPort": "i1"},
+      {"from": "peak", "to": "join", "fromPort": "o1", "toPort": "i1"},
+      {"from": "i1", "to": "join", "fromPort": "o1", "toPort": "i2"},
+      {"from": "join", "to": "o1", "fromPort": "o1", "toPort": "i1"}
+    ]
+  })";
+}
+
+using Samples = std::vector<std::pair<timestamp_t, double>>;
+
+PipelinedProgram::PortBatch make_batch(const Samples& samples, size_t first, size_t count) {
+  PipelinedProgram::PortBatch batch;
+  for (size_t i = first; i < std::min(samples.size(), first + count); ++i) {
+    batch["i1"].push_back(create_message<NumberData>(samples[i].first, NumberData{samples[i].second}));
+  }
+  return batch;
+}
+
+Samples flatten(ProgramMsgBatch& batch, const std::string& op, const std::string& port) {
+  Samples out;
+  for (auto& msg : batch[op][port]) {
+    out.emplace_back(msg->time, static_cast<const Message<NumberData>*>(msg.get())->data.value);
+  }
+  return out;
+}
+
+// Feed `samples` in bursts of `burst` to a serial Program and to a
+// PipelinedProgram with `stages` stages and compare the outputs per batch.
+void require_parity(const std::string& json, const Samples& samples, size_t burst, size_t stages,
+                    const std::string& op, const std::string& port) {
+  Program serial(json);
+  std::vector<Samples> expected;
+  for (size_t base = 0; base < samples.size(); base += burst) {
+    auto out = serial.receive_batch(make_batch(samples, base, burst));
+    expected.push_back(flatten(out, op, port));
+  }
+
+  PipelinedProgram pipelined(json, stages, 4);
+  REQUIRE(pipelined.num_stages() <= stages);
+  std::vector<PipelinedProgram::Result> results;
+  for (size_t base = 0; base < samples.size(); base += burst) {
+    pipelined.submit(make_batch(samples, base, burst));
+    pipelined.poll_results(results);
+  }
+  pipelined.drain_results(results);
+
+  REQUIRE(results.size() == expected.size());
+  size_t emitted = 0;
+  for (size_t b = 0; b < results.size(); ++b) {
+    REQUIRE(results[b].seq == b + 1);
+    REQUIRE(results[b].error.empty());
+    REQUIRE(flatten(results[b].batch, op, port) == expected[b]);
+    emitted += expected[b].size();
+  }
+  REQUIRE(emitted > 0);
+}
+
+}  // namespace
+
+SCENARIO("PipelinedProgram reproduces the serial PPG output stream", "[pipelined_program]") {
+  auto s = SamplePPG("examples/data/ppg.csv");
+  const double dt = s.dt();
+  const int short_window = static_cast<int>(std::round(50 / dt));
+  const int long_window = static_cast<int>(std::round(2000 / dt));
+  const auto json = ppg_program(short_window, long_window);
+
+  Samples samples;
+  for (size_t i = 0; i < s.ti.size(); ++i) samples.emplace_back(s.ti[i], s.ppg[i]);
+
+  for (size_t stages = 1; stages <= 4; ++stages) {
+    WHEN("the program is split into " + std::to_string(stages) + " stage(s)") {
+      PipelinedProgram probe(json, stages);
+      THEN("the layout covers every operator once, in serial order") {
+        auto layout = probe.stage_layout();
+        REQUIRE(layout.size() == std::min<size_t>(stages, 7));
+        size_t total = 0;
+        for (const auto& ids : layout) total += ids.size();
+        REQUIRE(total == 8);  // seven operators plus the program sink
+        REQUIRE(layout.front().front() == "i1");
+      }
+      THEN("every batch yields the same outputs as Program::receive_batch") {
+        require_parity(json, samples, 37, stages, "o1", "o1");
+      }
+    }
+  }
+}
+
+SCENARIO("PipelinedProgram keeps recurrent edges inside one stage", "[pipelined_program]") {
+  const auto json = create_rsi_program(14);
+
+  std::mt19937 gen(7);
+  std::normal_distribution<> step(0.0, 1.0);
+  Samples samples;
+  double price = 100.0;
+  for (timestamp_t t = 1; t <= 600; ++t) {
+    price += step(gen);
+    samples.emplace_back(t, price);
+  }
+
+  for (size_t stages : {2, 3, 4}) {
+    WHEN("the RSI program is split into " + std::to_string(stages) + " stages") {
+      THEN("the outputs still match serial execution") {
+        require_parity(json, samples, 25, stages, "output", "o1");
+      }
+    }
+  }
+}
+
+SCENARIO("PipelinedProgram reports stage errors in the batch result", "[pipelined_program]") {
+  const auto json = ppg_program(3, 10);
+  PipelinedProgram pipelined(json, 2);
+  std::vector<PipelinedProgram::Result> results;
+
+  Samples samples{{10, 1.0}, {11, 2.0}};
+  auto bad = make_batch(samples, 0, 1);
+  bad["iX"] = std::move(bad["i1"]);  // malformed port name throws
+  bad.erase("i1");
+  pipelined.submit(make_batch(samples, 0, 2));
+  pipelined.submit(std::move(bad));
+  pipelined.drain_results(results);
+
+  REQUIRE(results.size() == 2);
+  REQUIRE(results[0].error.empty());
+  REQUIRE_FALSE(results[1].error.empty());
+  REQUIRE(results[1].batch.empty());
+}
@@ -1,4 +1,5 @@
 #include <catch2/catch.hpp>
+#include <cmath>
 #include <iostream>
 
 #include "rtbot/Program.h"
@@ -84,6 +85,113 @@ SCENARIO("Program handles basic operator configurations", "[program]") {
   }
 }
 
+SCENARIO("Program preallocates port queues from queueCapacity", "[program]") {
+  GIVEN("A program with a small queueCapacity") {
+    std::string program_json = R"({
+      "queueCapacity": 4,
+      "operators": [
+        {"type": "Input", "id": "input1", "portTypes": ["number"]},
+        {"type": "MovingAverage", "id": "ma1", "window_size": 2},
+        {"type": "Output", "id": "output1", "portTypes": ["number"]}
+      ],
+      "connections": [
+        {"from": "input1", "to": "ma1", "fromPort": "o1", "toPort": "i1"},
+        {"from": "ma1", "to": "output1", "fromPort": "o1", "toPort": "i1"}
+      ],
+      "entryOperator": "input1",
+      "output": {
+        "output1": ["o1"]
+      }
+    })";
+
+    Program program(program_json);
+
+    WHEN("A burst larger than the preallocated capacity arrives") {
+      std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>> burst;
+      for (int i = 1; i <= 20; ++i) {
+        burst["i1"].push_back(create_message<NumberData>(i, NumberData{static_cast<double>(i)}));
+      }
+      auto batch = program.receive_batch(burst);
+
+      THEN("Queues grow past the reservation and every output is delivered") {
+        const auto& msgs = batch["output1"]["o1"];
+        REQUIRE(msgs.size() == 19);
+        for (size_t k = 0; k < msgs.size(); ++k) {
+          const auto* m = dynamic_cast<const Message<NumberData>*>(msgs[k].get());
+          REQUIRE(m->time == static_cast<timestamp_t>(k + 2));
+          REQUIRE(m->data.value == Approx(k + 1.5));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Program with messageArena matches the default allocator", "[program]") {
+  // PeakDetector keeps a message window and Join holds messages across
+  // calls, so both retained state and per-call transients are exercised.
+  auto make_json = [](bool arena) {
+    return std::string(R"({
+      "messageArena": )") +
+           (arena ? "true" : "false") + R"(,
+      "operators": [
+        {"type": "Input", "id": "in", "portTypes": ["number"]},
+        {"type": "MovingAverage", "id": "ma", "window_size": 4},
+        {"type": "PeakDetector", "id": "peak", "window_size": 5},
+        {"type": "Join", "id": "join", "portTypes": ["number", "number"]},
+        {"type": "Output", "id": "out", "portTypes": ["number", "number"]}
+      ],
+      "connections": [
+        {"from": "in", "to": "ma", "fromPort": "o1", "toPort": "i1"},
+        {"from": "ma", "to": "peak", "fromPort": "o1", "toPort": "i1"},
+        {"from": "peak", "to": "join", "fromPort": "o1", "toPort": "i1"},
+        {"from": "in", "to": "join", "fromPort": "o1", "toPort": "i2"},
+        {"from": "join", "to": "out", "fromPort": "o1", "toPort": "i1"},
+        {"from": "join", "to": "out", "fromPort": "o2", "toPort": "i2"}
+      ],
+      "entryOperator": "in",
+      "output": {"out": ["o1", "o2"]}
+    })";
+  };
+
+  auto flatten = [](ProgramMsgBatch& batch, std::vector<std::pair<timestamp_t, double>>& rows) {
+    for (const char* port : {"o1", "o2"}) {
+      for (const auto& msg : batch["out"][port]) {
+        rows.emplace_back(msg->time, static_cast<const Message<NumberData>*>(msg.get())->data.value);
+      }
+    }
+  };
+
+  Program plain(make_json(false));
+  Program arena(make_json(true));
+  std::vector<std::pair<timestamp_t, double>> expected, actual;
+
+  WHEN("messages arrive one at a time and in bursts") {
+    timestamp_t t = 1;
+    for (; t <= 200; ++t) {
+      const double v = std::sin(0.3 * t) * 10.0;
+      auto a = plain.receive(create_message<NumberData>(t, NumberData{v}));
+      auto b = arena.receive(create_message<NumberData>(t, NumberData{v}));
+      flatten(a, expected);
+      flatten(b, actual);
+    }
+    for (int burst = 0; burst < 5; ++burst) {
+      std::map<std::string, std::vector<std::unique_ptr<BaseMessage>>> batch;
+      for (int i = 0; i < 500; ++i, ++t) {
+        batch["i1"].push_back(create_message<NumberData>(t, NumberData{std::sin(0.3 * t) * 10.0}));
+      }
+      auto a = plain.receive_batch(batch);
+      auto b = arena.receive_batch(batch);
+      flatten(a, expected);
+      flatten(b, actual);
+    }
+
+    THEN("both programs emit the same messages") {
+      REQUIRE(!expected.empty());
+      REQUIRE(actual == expected);
+    }
+  }
+}
+
 SCENARIO("Program handles serialization and deserialization", "[program]") {
   GIVEN("A program with state") {
     std::string program_json = R"({
@@ -857,6 +965,226 @@ SCENARIO("Program handles Pipeline serialization", "[program][pipeline]") {
   }
 }
 
+SCENARIO("Program binary snapshots match the JSON round trip", "[program][State]") {
+  GIVEN("A program with buffered windows and a keyed Pipeline") {
+    std::string program_json = R"({
+            "operators": [
+                {"type": "Input", "id": "input1", "portTypes": ["number", "number"]},
+                {
+                    "type": "Pipeline",
+                    "id": "pipeline1",
+                    "input_port_types": ["number"],
+                    "output_port_types": ["number"],
+                    "operators": [
+                        {"type": "MovingAverage", "id": "ma1", "window_size": 3},
+                        {"type": "MovingAverage", "id": "ma2", "window_size": 2}
+                    ],
+                    "connections": [
+                        {"from": "ma1", "to": "ma2", "fromPort": "o1", "toPort": "i1"}
+                    ],
+                    "entryOperator": "ma1",
+                    "outputMappings": {
+                        "ma2": {"o1": "o1"}
+                    }
+                },
+                {"type": "StandardDeviation", "id": "sd1", "window_size": 4},
+                {"type": "CumulativeSum", "id": "cs1"},
+                {"type": "Output", "id": "output1", "portTypes": ["number", "number", "number"]}
+            ],
+            "connections": [
+                {"from": "input1", "to": "pipeline1", "fromPort": "o1", "toPort": "i1"},
+                {"from": "input1", "to": "pipeline1", "fromPort": "o2", "toPort": "c1"},
+                {"from": "input1", "to": "sd1", "fromPort": "o1", "toPort": "i1"},
+                {"from": "input1", "to": "cs1", "fromPort": "o1", "toPort": "i1"},
+                {"from": "pipeline1", "to": "output1", "fromPort": "o1", "toPort": "i1"},
+                {"from": "sd1", "to": "output1", "fromPort": "o1", "toPort": "i2"},
+                {"from": "cs1", "to": "output1", "fromPort": "o1", "toPort": "i3"}
+            ],
+            "entryOperator": "input1",
+            "output": {
+                "output1": ["o1", "o2", "o3"]
+            }
+        })";
+
+    Program original(program_json);
+    for (timestamp_t t = 1; t <= 6; ++t) {
+      original.receive({t, NumberData{10.0 * t + (t % 3)}}, "i1");
+      original.receive({t, NumberData{1.0}}, "i2");
+    }
+
+    WHEN("The state is snapshotted in both formats and restored") {
+      const auto binary = original.serialize_binary();
+      const auto json_state = original.serialize_data();
+
+      Program from_binary(program_json);
+      from_binary.restore_binary(binary);
+      Program from_json(program_json);
+      from_json.restore_data_from_json(json_state);
+
+      THEN("The binary snapshot is much smaller than the JSON one") { REQUIRE(binary.size() * 2 < json_state.size()); }
+
+      THEN("All three programs produce the same outputs afterwards") {
+        for (timestamp_t t = 7; t <= 10; ++t) {
+          const double value = 10.0 * t + (t % 3);
+          const double key = t < 9 ? 1.0 : 2.0;
+          ProgramMsgBatch outputs[3];
+          Program* programs[3] = {&original, &from_binary, &from_json};
+          for (int p = 0; p < 3; ++p) {
+            programs[p]->receive({t, NumberData{value}}, "i1");
+            outputs[p] = programs[p]->receive({t, NumberData{key}}, "i2");
+          }
+          for (int p = 1; p < 3; ++p) {
+            REQUIRE(outputs[p].count("output1") == outputs[0].count("output1"));
+            if (outputs[0].count("output1") == 0) continue;
+            for (auto& [port, msgs] : outputs[0]["output1"]) {
+              REQUIRE(outputs[p]["output1"][port].size() == msgs.size());
+              for (size_t i = 0; i < msgs.size(); ++i) {
+                const auto* expected = dynamic_cast<const Message<NumberData>*>(msgs[i].get());
+                const auto* actual = dynamic_cast<const Message<NumberData>*>(outputs[p]["output1"][port][i].get());
+                REQUIRE(actual->time == expected->time);
+                REQUIRE(actual->data.value == Approx(expected->data.value));
+              }
+            }
+          }
+        }
+      }
+    }
+
+    WHEN("The binary snapshot is damaged") {
+      auto binary = original.serialize_binary();
+      Program restored(program_json);
+
+      THEN("A truncated snapshot is rejected") {
+        Bytes truncated(binary.begin(), binary.begin() + binary.size() / 2);
+        REQUIRE_THROWS_AS(restored.restore_binary(truncated), std::runtime_error);
+      }
+
+      THEN("A snapshot without the magic is rejected") {
+        binary[0] = 'X';
+        REQUIRE_THROWS_AS(restored.restore_binary(binary), std::runtime_error);
+      }
+    }
+  }
+}
+
+SCENARIO("Program delta checkpoints replay to the same state", "[program][State]") {
+  GIVEN("A program keying rows into moving averages next to a top-level window") {
+    std::string program_json = R"({
+            "entryOperator": "in",
+            "output": { "out": ["o1", "o2"] },
+            "operators": [
+                {"id": "in", "type": "Input", "portTypes": ["vector_number"]},
+                {"id": "keyed", "type": "KeyedPipeline", "key_index": 0,
+                 "prototype": {
+                     "operators": [
+                         {"type": "VectorExtract", "id": "ext", "index": 1},
+                         {"type": "MovingAverage", "id": "ma", "window_size": 4}
+                     ],
+                     "connections": [{"from": "ext", "to": "ma", "fromPort": "o1", "toPort": "i1"}],
+                     "entry": {"operator": "ext"},
+                     "output": {"operator": "ma"}
+                 }},
+                {"id": "x", "type": "VectorExtract", "index": 1},
+                {"id": "big", "type": "MovingAverage", "window_size": 16},
+                {"id": "out", "type": "Output", "portTypes": ["vector_number", "number"]}
+            ],
+            "connections": [
+                {"from": "in", "to": "keyed", "fromPort": "o1", "toPort": "i1"},
+                {"from": "in", "to": "x", "fromPort": "o1", "toPort": "i1"},
+                {"from": "x", "to": "big", "fromPort": "o1", "toPort": "i1"},
+                {"from": "keyed", "to": "out", "fromPort": "o1", "toPort": "i1"},
+                {"from": "big", "to": "out", "fromPort": "o1", "toPort": "i2"}
+            ]
+        })";
+
+    auto row = [](timestamp_t t, double key) {
+      return create_message<VectorNumberData>(t, VectorNumberData(std::vector<double>{key, 0.5 * t + key}));
+    };
+    auto same_outputs = [](ProgramMsgBatch& a, ProgramMsgBatch& b) {
+      REQUIRE(a.count("out") == b.count("out"));
+      if (a.count("out") == 0) return;
+      for (auto& [port, msgs] : a["out"]) {
+        REQUIRE(b["out"][port].size() == msgs.size());
+        for (size_t i = 0; i < msgs.size(); ++i) {
+          REQUIRE(b["out"][port][i]->time == msgs[i]->time);
+          if (const auto* expected = dynamic_cast<const Message<NumberData>*>(msgs[i].get())) {
+            const auto* actual = dynamic_cast<const Message<NumberData>*>(b["out"][port][i].get());
+            REQUIRE(actual->data.value == Approx(expected->data.value));
+          } else {
+            const auto* expected_vec = dynamic_cast<const Message<VectorNumberData>*>(msgs[i].get());
+            const auto* actual = dynamic_cast<const Message<VectorNumberData>*>(b["out"][port][i].get());
+            REQUIRE(actual->data.size() == expected_vec->data.size());
+            for (size_t j = 0; j < actual->data.size(); ++j) {
+              REQUIRE(actual->data[j] == Approx(expected_vec->data[j]));
+            }
+          }
+        }
+      }
+    };
+
+    Program original(program_json);
+    timestamp_t t = 1;
+    for (; t <= 200; ++t) original.receive(row(t, static_cast<double>(t % 40)), "i1");
+
+    std::vector<Bytes> chain{original.checkpoint()};
+    for (int round = 0; round < 3; ++round) {
+      for (int i = 0; i < 5; ++i, ++t) original.receive(row(t, static_cast<double>(i + round)), "i1");
+      chain.push_back(original.checkpoint_delta());
+    }
+
+    WHEN("The full checkpoint and every delta are applied in order") {
+      Program restored(program_json);
+      restored.restore_checkpoints(chain);
+
+      THEN("Each delta is much smaller than the full checkpoint") {
+        for (size_t i = 1; i < chain.size(); ++i) REQUIRE(chain[i].size() * 4 < chain[0].size());
+        REQUIRE(restored.checkpoint_epoch() == original.checkpoint_epoch());
+      }
+
+      THEN("Both programs produce the same outputs afterwards") {
+        for (timestamp_t u = t; u < t + 60; ++u) {
+          auto expected = original.receive(row(u, static_cast<double>(u % 45)), "i1");
+          auto actual = restored.receive(row(u, static_cast<double>(u % 45)), "i1");
+          same_outputs(expected, actual);
+        }
+      }
+    }
+
+    WHEN("A delta is taken against an older epoch") {
+      for (int i = 0; i < 5; ++i, ++t) original.receive(row(t, 50.0 + i), "i1");
+      const auto cumulative = original.checkpoint_delta(1);
+
+      Program restored(program_json);
+      restored.apply_checkpoint(chain[0]);
+      restored.apply_checkpoint(cumulative);
+
+      THEN("The base plus the cumulative delta matches") {
+        for (timestamp_t u = t; u < t + 60; ++u) {
+          auto expected = original.receive(row(u, static_cast<double>(u % 55)), "i1");
+          auto actual = restored.receive(row(u, static_cast<double>(u % 55)), "i1");
+          same_outputs(expected, actual);
+        }
+      }
+    }
+
+    WHEN("The chain is broken") {
+      Program restored(program_json);
+
+      THEN("A delta without its base is rejected") { REQUIRE_THROWS_AS(restored.apply_checkpoint(chain[1]), std::runtime_error); }
+
+      THEN("Skipping a delta is rejected") {
+        restored.apply_checkpoint(chain[0]);
+        restored.apply_checkpoint(chain[1]);
+        REQUIRE_THROWS_AS(restored.apply_checkpoint(chain[3]), std::runtime_error);
+      }
+
+      THEN("A delta cannot be taken before a full checkpoint") {
+        REQUIRE_THROWS_AS(restored.checkpoint_delta(), std::runtime_error);
+      }
+    }
+  }
+}
+
 SCENARIO("Pipeline reset and emission behavior", "[program][pipeline]") {
   GIVEN("A pipeline that requires state reset after emission") {
     // Pipeline with MA1(3)→MA2(2), control port for segment-scoped computation.
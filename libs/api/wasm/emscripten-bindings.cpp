@@ -52,6 +52,35 @@ std::string beginVectorMessage(const std::string& programId, const std::string&
   return rtbot::begin_vector_message(programId, portId, static_cast<uint64_t>(time));
 }
 
+// Binary snapshots cross as Uint8Array instead of a JS array of numbers. The
+// view over the WASM heap is copied before the vector goes out of scope.
+val serializeProgramBinary(const std::string& programId) {
+  const auto snapshot = rtbot::serialize_program_binary(programId);
+  return val::global("Uint8Array").new_(typed_memory_view(snapshot.size(), snapshot.data()));
+}
+
+void restoreProgramBinary(const std::string& programId, const val& snapshot) {
+  rtbot::restore_program_binary(programId, convertJSArrayToNumberVector<uint8_t>(snapshot));
+}
+
+val checkpointProgram(const std::string& programId) {
+  const auto checkpoint = rtbot::checkpoint_program(programId);
+  return val::global("Uint8Array").new_(typed_memory_view(checkpoint.size(), checkpoint.data()));
+}
+
+val checkpointProgramDelta(const std::string& programId) {
+  const auto checkpoint = rtbot::checkpoint_program_delta(programId);
+  return val::global("Uint8Array").new_(typed_memory_view(checkpoint.size(), checkpoint.data()));
+}
+
+void applyProgramCheckpoint(const std::string& programId, const val& checkpoint) {
+  rtbot::apply_program_checkpoint(programId, convertJSArrayToNumberVector<uint8_t>(checkpoint));
+}
+
+double getProgramCheckpointEpoch(const std::string& programId) {
+  return static_cast<double>(rtbot::get_program_checkpoint_epoch(programId));
+}
+
 namespace {
 // Helper functions for message creation and access
 timestamp_t getMessage_getTime(const rtbot::Message<rtbot::NumberData>& msg) { return msg.time; }
@@ -111,4 +140,17 @@ EMSCRIPTEN_BINDINGS(RtBot) {
   // State management
   function("serializeProgramData", &rtbot::serialize_program_data);
   function("restoreProgramDataFromJson", &rtbot::restore_program_data_from_json);
+  function("serializeProgramBinary", &serializeProgramBinary);
+  function("restoreProgramBinary", &restoreProgramBinary);
+  function("checkpointProgram", &checkpointProgram);
+  function("checkpointProgramDelta", &checkpointProgramDelta);
+  function("applyProgramCheckpoint", &applyProgramCheckpoint);
+  function("getProgramCheckpointEpoch", &getProgramCheckpointEpoch);
+
+  // Profiling
+  function("getProgramProfile", &rtbot::get_program_profile);
+  function("setProgramProfiling", &rtbot::set_program_profiling);
+  function("resetProgramProfile", &rtbot::reset_program_profile);
+  function("getProgramLatency", &rtbot::get_program_latency);
+  function("setProgramLatency", &rtbot::set_program_latency);
 }
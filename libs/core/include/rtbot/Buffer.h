@@ -29,6 +29,9 @@ class Buffer : public Operator {
 
     add_data_port<T>();
     add_output_port<T>();
+    if constexpr (std::is_same_v<T, NumberData>) {
+      enable_value_queue(0);
+    }
 
     if constexpr (Features::TRACK_SUM) {
       sum_ = 0.0;
@@ -39,9 +42,13 @@ class Buffer : public Operator {
     }
   }
 
+  // Configuration only: the window and statistics start empty.
+  Buffer(const Buffer& other) : Operator(other), window_size_(other.window_size_) {}
+
   void reset() override {
     Operator::reset();
     buffer_.clear();  // Clear buffer contents
+    window_replaced_ = true;
     sum_ = 0.0;       // Reset statistical accumulators
     sum_comp_ = 0.0;  // Reset Kahan compensation term
     M2_ = 0.0;
@@ -153,38 +160,109 @@ class Buffer : public Operator {
         it += msg_size;
     }
 
-    // ---- Optional statistics ----
-    if constexpr (Features::TRACK_SUM) {
-        sum_ = 0.0;
-        sum_comp_ = 0.0;
-        if (!buffer_.empty()) {
-            for (const auto& msg : buffer_) {
-                kahan_add(msg->data.value);
-            }
-        }
-    }
+    window_replaced_ = true;
+    rebuild_statistics();
+  }
 
-    if constexpr (Features::TRACK_VARIANCE) {
-        sum_ = 0.0;
-        sum_comp_ = 0.0;
-        M2_ = 0.0;
+  // The window goes out with the port queues' encoding: one type tag, then
+  // a column of times and a column of values for scalar buffers.
+  void write_state(ByteWriter& w) override {
+    write_ports(w);
+    StateSerializer::write_messages(w, buffer_, typeid(T));
+    write_extra_state(w);
+  }
 
-        if (!buffer_.empty()) {
-            for (const auto& msg : buffer_) {
-                kahan_add(msg->data.value);
-            }
+  void read_state(ByteReader& r) override {
+    read_ports(r);
+    buffer_.clear();
+    read_window_tail(r);
+    window_replaced_ = true;
+    rebuild_statistics();
+    read_extra_state(r);
+  }
 
-            double mean = sum_ / buffer_.size();
-            for (const auto& msg : buffer_) {
-                double delta = msg->data.value - mean;
-                M2_ += delta * delta;
-            }
-        }
+  // Delta against the window at the last checkpoint: how many messages left
+  // the front, then the ones appended since. Falls back to the full state
+  // when the window was replaced (reset / restore) or `since_epoch` predates
+  // that checkpoint.
+  void write_delta(ByteWriter& w, uint64_t since_epoch) override {
+    const uint64_t appended = appended_ - appended_at_checkpoint_;
+    const bool incremental = !window_replaced_ && since_epoch >= checkpoint_epoch() && appended <= buffer_.size();
+    w.write<uint8_t>(incremental ? 1 : 0);
+    if (!incremental) {
+      write_state(w);
+      return;
     }
+    write_ports(w);
+    w.write_size(size_at_checkpoint_ + appended - buffer_.size());
+    const WindowTail tail{buffer_, buffer_.size() - appended};
+    StateSerializer::write_messages(w, tail, typeid(T));
+    write_extra_state(w);
+  }
+
+  void read_delta(ByteReader& r) override {
+    if (r.read<uint8_t>() == 0) {
+      read_state(r);
+      return;
+    }
+    read_ports(r);
+    const size_t evicted = r.read_size();
+    if (evicted > buffer_.size()) {
+      throw std::runtime_error("Buffer delta evicts more than the window holds at " + id());
+    }
+    buffer_.erase(buffer_.begin(), buffer_.begin() + evicted);
+    read_window_tail(r);
+    if (buffer_.size() > window_size_) {
+      throw std::runtime_error("Buffer delta overflows the window at " + id());
+    }
+    window_replaced_ = true;
+    rebuild_statistics();
+    read_extra_state(r);
+  }
+
+  void mark_checkpoint(uint64_t epoch) override {
+    Operator::mark_checkpoint(epoch);
+    appended_at_checkpoint_ = appended_;
+    size_at_checkpoint_ = buffer_.size();
+    window_replaced_ = false;
   }
 
  protected:
+  // State a subclass keeps beside the window, written after it by
+  // write_state() and by incremental deltas.
+  virtual void write_extra_state(ByteWriter& w) { (void)w; }
+  virtual void read_extra_state(ByteReader& r) { (void)r; }
+
   void process_data(bool debug=false) override {
+    if constexpr (std::is_same_v<T, NumberData>) {
+      // Value-mode input: drain the records as one column, slide the window
+      // over it and emit the outputs as one MessageBatch. The window keeps
+      // its own Message<T> copy, built straight from the record.
+      if (get_value_queue(0).empty()) return;
+      in_batch_.clear();
+      out_batch_.clear();
+      drain_value_queue(0, in_batch_);
+      const size_t n = in_batch_.size();
+      for (size_t i = 0; i < n; ++i) {
+        const double value = in_batch_.values[i];
+        std::optional<double> removed_value;
+        if (buffer_.size() == window_size_) {
+          removed_value = buffer_.front()->data.value;
+          buffer_.pop_front();
+        }
+        {
+          MessageArena::Suspend heap;  // the window outlives the receive call
+          buffer_.push_back(std::make_unique<Message<T>>(in_batch_.times[i], T{value}));
+        }
+        ++appended_;
+
+        update_statistics(value, removed_value);
+        process_record(in_batch_.times[i], out_batch_);
+      }
+      emit_output(0, out_batch_, debug);
+      return;
+    }
+
     auto& input_queue = get_data_queue(0);
     if (input_queue.empty()) return;
     if (input_queue.size() >= kEmitBatchThreshold) {
@@ -202,14 +280,15 @@ class Buffer : public Operator {
           buffer_.pop_front();
         }
 
-        // Add new message to buffer
-        auto cloned = input_queue.front()->clone();
+        // Add new message to buffer (heap copy: the window outlives the call)
+        auto cloned = retain_message(*input_queue.front());
         auto* typed_clone = static_cast<Message<T>*>(cloned.get());
         if (!typed_clone) {
           throw std::runtime_error("Failed to cast cloned message in Buffer");
         }
         cloned.release();  // Safe: cast validated above
         buffer_.push_back(std::unique_ptr<Message<T>>(typed_clone));
+        ++appended_;
 
         // Update statistics with added and removed values
         update_statistics(msg->data.value, removed_value);
@@ -235,14 +314,15 @@ class Buffer : public Operator {
           buffer_.pop_front();
         }
 
-        // Add new message to buffer
-        auto cloned = input_queue.front()->clone();
+        // Add new message to buffer (heap copy: the window outlives the call)
+        auto cloned = retain_message(*input_queue.front());
         auto* typed_clone = static_cast<Message<T>*>(cloned.get());
         if (!typed_clone) {
           throw std::runtime_error("Failed to cast cloned message in Buffer");
         }
         cloned.release();  // Safe: cast validated above
         buffer_.push_back(std::unique_ptr<Message<T>>(typed_clone));
+        ++appended_;
 
         // Update statistics with added and removed values
         update_statistics(msg->data.value, removed_value);
@@ -259,7 +339,66 @@ class Buffer : public Operator {
 
   virtual std::vector<std::unique_ptr<Message<T>>> process_message(const Message<T>* msg) = 0;
 
+  // Value-path counterpart of process_message (NumberData buffers only): the
+  // record stamped `time` has just entered the window; append this step's
+  // outputs to `out`. The default goes through process_message; operators
+  // emitting at most one number per input override it to skip the Message
+  // round trip.
+  virtual void process_record(timestamp_t time, MessageBatch<NumberData>& out) {
+    if constexpr (std::is_same_v<T, NumberData>) {
+      (void)time;
+      for (auto& msg : process_message(buffer_.back().get())) out.push_back(msg->time, msg->data.value);
+    }
+  }
+
  private:
+  // The last messages of the window, from index `first`, as a range for
+  // StateSerializer::write_messages.
+  struct WindowTail {
+    const std::deque<std::unique_ptr<Message<T>>>& window;
+    size_t first;
+    size_t size() const { return window.size() - first; }
+    auto begin() const { return window.begin() + first; }
+    auto end() const { return window.end(); }
+  };
+
+  void read_window_tail(ByteReader& r) {
+    StateSerializer::read_messages(r, typeid(T), [this](std::unique_ptr<BaseMessage> msg) {
+      buffer_.push_back(std::unique_ptr<Message<T>>(static_cast<Message<T>*>(msg.release())));
+    });
+  }
+
+  // Recompute the running statistics from the window after a restore.
+  void rebuild_statistics() {
+    if constexpr (Features::TRACK_SUM) {
+        sum_ = 0.0;
+        sum_comp_ = 0.0;
+        if (!buffer_.empty()) {
+            for (const auto& msg : buffer_) {
+                kahan_add(msg->data.value);
+            }
+        }
+    }
+
+    if constexpr (Features::TRACK_VARIANCE) {
+        sum_ = 0.0;
+        sum_comp_ = 0.0;
+        M2_ = 0.0;
+
+        if (!buffer_.empty()) {
+            for (const auto& msg : buffer_) {
+                kahan_add(msg->data.value);
+            }
+
+            double mean = sum_ / buffer_.size();
+            for (const auto& msg : buffer_) {
+                double delta = msg->data.value - mean;
+                M2_ += delta * delta;
+            }
+        }
+    }
+  }
+
   // Kahan-compensated addition: folds the rounding error from each operation
   // into a compensation term so that accumulated drift stays O(1·ε) instead
   // of O(N·ε).  For sliding-window sums over large-magnitude values, naive
@@ -307,9 +446,18 @@ class Buffer : public Operator {
 
   size_t window_size_;
   std::deque<std::unique_ptr<Message<T>>> buffer_;
+  // Value-path scratch columns, reused across process_data calls.
+  MessageBatch<NumberData> in_batch_;
+  MessageBatch<NumberData> out_batch_;
   double sum_{0.0};
   double sum_comp_{0.0};  // Kahan compensation term for sum_
   double M2_{0.0};
+  // Delta checkpoint bookkeeping: messages ever appended, and the append
+  // count and window size at the last checkpoint.
+  uint64_t appended_{0};
+  uint64_t appended_at_checkpoint_{0};
+  size_t size_at_checkpoint_{0};
+  bool window_replaced_{false};
 };
 
 }  // namespace rtbot
@@ -0,0 +1,152 @@
+#ifndef RTBOT_BYTE_STREAM_H
+#define RTBOT_BYTE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace rtbot {
+
+// Streaming writer for binary state snapshots (Operator::write_state).
+//
+// Appends to a caller-owned byte vector. Fixed-width values are memcpy'd in
+// host byte order; counts and lengths are LEB128 varints, so the many small
+// sizes in a snapshot (queue lengths, key counts, ids) take one byte instead
+// of eight. Arrays of trivially copyable values go out in a single copy.
+class ByteWriter {
+ public:
+  explicit ByteWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+  template <typename T>
+  void write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "ByteWriter::write needs a trivially copyable type");
+    write_bytes(&value, sizeof(T));
+  }
+
+  void write_bytes(const void* data, size_t size) {
+    if (size == 0) return;
+    const size_t at = out_.size();
+    out_.resize(at + size);
+    std::memcpy(out_.data() + at, data, size);
+  }
+
+  void write_varint(uint64_t value) {
+    uint8_t buf[10];
+    size_t n = 0;
+    while (value >= 0x80) {
+      buf[n++] = static_cast<uint8_t>(value) | 0x80;
+      value >>= 7;
+    }
+    buf[n++] = static_cast<uint8_t>(value);
+    write_bytes(buf, n);
+  }
+
+  void write_size(size_t size) { write_varint(static_cast<uint64_t>(size)); }
+
+  template <typename T>
+  void write_array(const T* data, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "ByteWriter::write_array needs a trivially copyable type");
+    write_bytes(data, count * sizeof(T));
+  }
+
+  void write_string(const std::string& s) {
+    write_size(s.size());
+    write_bytes(s.data(), s.size());
+  }
+
+  // Length-prefixed opaque bytes.
+  void write_blob(const uint8_t* data, size_t size) {
+    write_size(size);
+    write_bytes(data, size);
+  }
+
+  // Grow the output once ahead of a known-size section.
+  void reserve(size_t additional) { out_.reserve(out_.size() + additional); }
+
+  size_t size() const { return out_.size(); }
+
+ private:
+  std::vector<uint8_t>& out_;
+};
+
+// Reader over a binary snapshot produced by ByteWriter. Every read is bounds
+// checked and throws std::runtime_error on truncated input, so a corrupt
+// snapshot fails the restore instead of reading past the buffer.
+class ByteReader {
+ public:
+  ByteReader(const uint8_t* data, size_t size) : pos_(data), end_(data + size) {}
+  explicit ByteReader(const std::vector<uint8_t>& bytes) : ByteReader(bytes.data(), bytes.size()) {}
+
+  template <typename T>
+  T read() {
+    static_assert(std::is_trivially_copyable_v<T>, "ByteReader::read needs a trivially copyable type");
+    T value;
+    read_bytes(&value, sizeof(T));
+    return value;
+  }
+
+  void read_bytes(void* out, size_t size) {
+    require(size);
+    if (size == 0) return;
+    std::memcpy(out, pos_, size);
+    pos_ += size;
+  }
+
+  uint64_t read_varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      require(1);
+      const uint8_t byte = *pos_++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+    throw std::runtime_error("Binary snapshot: malformed varint");
+  }
+
+  size_t read_size() { return static_cast<size_t>(read_varint()); }
+
+  template <typename T>
+  void read_array(T* out, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "ByteReader::read_array needs a trivially copyable type");
+    if (count > remaining() / sizeof(T)) truncated();
+    read_bytes(out, count * sizeof(T));
+  }
+
+  std::string read_string() {
+    const size_t size = read_size();
+    require(size);
+    std::string s(reinterpret_cast<const char*>(pos_), size);
+    pos_ += size;
+    return s;
+  }
+
+  // Zero-copy view of a length-prefixed blob; valid while the input is.
+  const uint8_t* read_blob(size_t& size) {
+    size = read_size();
+    require(size);
+    const uint8_t* data = pos_;
+    pos_ += size;
+    return data;
+  }
+
+  size_t remaining() const { return static_cast<size_t>(end_ - pos_); }
+  bool at_end() const { return pos_ == end_; }
+
+ private:
+  void require(size_t size) const {
+    if (size > remaining()) truncated();
+  }
+
+  [[noreturn]] static void truncated() { throw std::runtime_error("Binary snapshot truncated"); }
+
+  const uint8_t* pos_;
+  const uint8_t* end_;
+};
+
+}  // namespace rtbot
+
+#endif  // RTBOT_BYTE_STREAM_H
@@ -0,0 +1,182 @@
+#ifndef COUNT_MIN_SKETCH_H
+#define COUNT_MIN_SKETCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "rtbot/Message.h"
+
+namespace rtbot {
+
+// Approximate per-key counts over the last `window` keys
+// (MovingKeyCount's count_min mode), in memory independent of the window
+// length and of the number of distinct keys.
+//
+// The window is cut into `panes` panes of ceil(window / panes) keys, each
+// with its own Count-Min sketch of depth ceil(ln(1 / delta)) and width
+// ceil(e / epsilon); a running total sketch is the sum of the live panes.
+// When the current pane fills up, the oldest pane is subtracted from the
+// total, cleared and reused, so adding a key touches `depth` counters plus
+// an amortized width * depth / pane_size for the pane turnover.
+//
+// The estimate never undercounts: it covers the last `window` keys plus
+// at most one pane (ceil(window / panes) keys) of older ones that have not
+// expired yet, and with probability 1 - delta the sketch adds at most
+// epsilon times the keys it covers. Keys compare by value with -0.0
+// folded into 0.0 and every NaN treated as one key, as in KeyTable.
+class SlidingCountMin {
+ public:
+  SlidingCountMin(size_t window, double epsilon, double delta, size_t panes)
+      : window_(window), epsilon_(epsilon), delta_(delta), panes_(panes) {
+    if (window_ == 0) throw std::runtime_error("SlidingCountMin: window must be positive");
+    if (!(epsilon_ > 0.0 && epsilon_ < 1.0)) throw std::runtime_error("SlidingCountMin: epsilon must be in (0, 1)");
+    if (!(delta_ > 0.0 && delta_ < 1.0)) throw std::runtime_error("SlidingCountMin: delta must be in (0, 1)");
+    if (panes_ == 0) throw std::runtime_error("SlidingCountMin: panes must be positive");
+    panes_ = std::min(panes_, window_);
+    pane_size_ = (window_ + panes_ - 1) / panes_;
+    if (window_ + pane_size_ > std::numeric_limits<Counter>::max()) {
+      throw std::runtime_error("SlidingCountMin: window too large");
+    }
+    depth_ = static_cast<size_t>(std::ceil(std::log(1.0 / delta_)));
+    width_ = static_cast<size_t>(std::ceil(std::exp(1.0) / epsilon_));
+    depth_ = std::max<size_t>(depth_, 1);
+    cells_ = depth_ * width_;
+    // One pane beyond `panes_` holds the keys still arriving.
+    counters_.assign((panes_ + 1) * cells_, 0);
+    total_.assign(cells_, 0);
+  }
+
+  size_t window() const { return window_; }
+  double epsilon() const { return epsilon_; }
+  double delta() const { return delta_; }
+  size_t panes() const { return panes_; }
+  size_t width() const { return width_; }
+  size_t depth() const { return depth_; }
+  size_t memory_bytes() const { return (counters_.size() + total_.size()) * sizeof(Counter); }
+
+  // Adds `key`; returns its estimated count, this occurrence included.
+  uint64_t add(double key) {
+    if (fill_ == pane_size_) advance();
+    ++fill_;
+    Counter* pane = counters_.data() + current_ * cells_;
+    const uint64_t bits = key_bits(key);
+    const uint64_t h1 = mix(bits);
+    const uint64_t h2 = mix(bits ^ 0x9e3779b97f4a7c15ULL) | 1;
+    Counter est = std::numeric_limits<Counter>::max();
+    for (size_t row = 0; row < depth_; ++row) {
+      const size_t cell = row * width_ + static_cast<size_t>((h1 + row * h2) % width_);
+      ++pane[cell];
+      est = std::min(est, ++total_[cell]);
+    }
+    return est;
+  }
+
+  uint64_t estimate(double key) const {
+    const uint64_t bits = key_bits(key);
+    const uint64_t h1 = mix(bits);
+    const uint64_t h2 = mix(bits ^ 0x9e3779b97f4a7c15ULL) | 1;
+    Counter est = std::numeric_limits<Counter>::max();
+    for (size_t row = 0; row < depth_; ++row) {
+      est = std::min(est, total_[row * width_ + static_cast<size_t>((h1 + row * h2) % width_)]);
+    }
+    return est;
+  }
+
+  void clear() {
+    std::fill(counters_.begin(), counters_.end(), 0);
+    std::fill(total_.begin(), total_.end(), 0);
+    current_ = 0;
+    fill_ = 0;
+  }
+
+  // Pane position and pane counters; the total is their sum.
+  void serialize(Bytes& bytes) const {
+    append(bytes, current_);
+    append(bytes, fill_);
+    bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(counters_.data()),
+                 reinterpret_cast<const uint8_t*>(counters_.data() + counters_.size()));
+  }
+
+  void restore(Bytes::const_iterator& it) {
+    std::memcpy(&current_, &(*it), sizeof(current_));
+    it += sizeof(current_);
+    std::memcpy(&fill_, &(*it), sizeof(fill_));
+    it += sizeof(fill_);
+    if (current_ > panes_ || fill_ > pane_size_) {
+      throw std::runtime_error("SlidingCountMin: restored state does not match the sketch size");
+    }
+    std::memcpy(counters_.data(), &(*it), counters_.size() * sizeof(Counter));
+    it += counters_.size() * sizeof(Counter);
+    std::fill(total_.begin(), total_.end(), 0);
+    for (size_t p = 0; p <= panes_; ++p) {
+      const Counter* pane = counters_.data() + p * cells_;
+      for (size_t c = 0; c < cells_; ++c) total_[c] += pane[c];
+    }
+  }
+
+  bool operator==(const SlidingCountMin& other) const {
+    return window_ == other.window_ && epsilon_ == other.epsilon_ && delta_ == other.delta_ &&
+           panes_ == other.panes_ && current_ == other.current_ && fill_ == other.fill_ &&
+           counters_ == other.counters_;
+  }
+  bool operator!=(const SlidingCountMin& other) const { return !(*this == other); }
+
+ private:
+  using Counter = uint32_t;
+
+  static uint64_t key_bits(double key) {
+    if (key == 0.0) key = 0.0;
+    if (key != key) key = std::numeric_limits<double>::quiet_NaN();
+    uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+  }
+
+  // splitmix64 finalizer.
+  static uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+  }
+
+  template <typename T>
+  static void append(Bytes& bytes, const T& v) {
+    bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&v),
+                 reinterpret_cast<const uint8_t*>(&v) + sizeof(v));
+  }
+
+  // Retires the oldest pane and makes it the current one.
+  void advance() {
+    current_ = (current_ + 1) % (panes_ + 1);
+    Counter* pane = counters_.data() + current_ * cells_;
+    for (size_t c = 0; c < cells_; ++c) total_[c] -= pane[c];
+    std::fill(pane, pane + cells_, 0);
+    fill_ = 0;
+  }
+
+  size_t window_;
+  double epsilon_;
+  double delta_;
+  size_t panes_;
+  size_t pane_size_{0};
+  size_t depth_{0};
+  size_t width_{0};
+  size_t cells_{0};
+  std::vector<Counter> counters_;  // (panes_ + 1) panes of depth_ x width_
+  std::vector<Counter> total_;     // sum of the panes
+  size_t current_{0};              // pane receiving keys
+  size_t fill_{0};                 // keys in the current pane
+};
+
+}  // namespace rtbot
+
+#endif  // COUNT_MIN_SKETCH_H
@@ -35,6 +35,7 @@ class Demultiplexer : public Operator {
   }
 
   std::string type_name() const override { return "Demultiplexer"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Demultiplexer>(*this); }
 
   size_t get_num_ports() const { return num_control_ports(); }
 
@@ -0,0 +1,163 @@
+#ifndef EXECUTION_SCHEDULE_H
+#define EXECUTION_SCHEDULE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "rtbot/Operator.h"
+
+namespace rtbot {
+
+// Flat replacement for the recursive Operator::execute() walk.
+//
+// compile() orders every operator reachable from the entry in reverse
+// postorder (children visited in connection order, so siblings run in the
+// same order the recursion would visit them) and flattens the outbound
+// connections into one edge array indexed by schedule position. run() then
+// sweeps a dirty bitmap with a single cursor: an operator runs via
+// execute_local(), and each edge whose output port emitted marks its target
+// dirty. In an acyclic graph every edge points forward, so each operator runs
+// at most once per pass. A recurrent edge (l1 -> ts11 -> l1) points backwards
+// and simply rewinds the cursor to its target, which is where the recursion
+// would have re-entered — no call-stack growth in either case.
+//
+// The schedule holds raw Operator pointers and must be recompiled if the
+// graph reachable from the entry is rewired.
+class ExecutionSchedule {
+ public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  void compile(Operator* entry) {
+    if (!entry) {
+      compile_order({});
+      return;
+    }
+
+    // Iterative DFS. Children are pushed in reverse connection order and
+    // postorder is reversed at the end, which puts earlier connections first.
+    std::unordered_map<Operator*, bool> seen;
+    std::vector<Operator*> postorder;
+    struct Frame {
+      Operator* op;
+      size_t remaining;
+    };
+    std::vector<Frame> stack;
+    seen.emplace(entry, true);
+    stack.push_back({entry, entry->num_connections()});
+    while (!stack.empty()) {
+      Frame& top = stack.back();
+      if (top.remaining == 0) {
+        postorder.push_back(top.op);
+        stack.pop_back();
+        continue;
+      }
+      Operator* child = top.op->get_connection(--top.remaining).child;
+      if (child && seen.emplace(child, true).second) {
+        stack.push_back({child, child->num_connections()});
+      }
+    }
+
+    compile_order(std::vector<Operator*>(postorder.rbegin(), postorder.rend()));
+  }
+
+  // Compile an explicit operator order (e.g. one stage of a partitioned
+  // program). Connections to operators outside `order` are not followed;
+  // whoever owns those edges is responsible for running their targets.
+  void compile_order(std::vector<Operator*> order) {
+    ops_ = std::move(order);
+    index_.clear();
+    edge_begin_.clear();
+    edges_.clear();
+    for (size_t i = 0; i < ops_.size(); ++i) {
+      index_[ops_[i]] = static_cast<uint32_t>(i);
+    }
+
+    edge_begin_.reserve(ops_.size() + 1);
+    for (Operator* op : ops_) {
+      edge_begin_.push_back(static_cast<uint32_t>(edges_.size()));
+      for (size_t c = 0; c < op->num_connections(); ++c) {
+        const auto& conn = op->get_connection(c);
+        auto it = index_.find(conn.child);
+        if (it == index_.end()) continue;
+        edges_.push_back({uint64_t{1} << conn.output_port, it->second});
+      }
+    }
+    edge_begin_.push_back(static_cast<uint32_t>(edges_.size()));
+    dirty_.assign(ops_.size(), 0);
+    cursor_ = ops_.size();
+  }
+
+  // Execute the first operator in the order (the entry) and everything its
+  // output reaches.
+  void run(bool debug = false) {
+    if (ops_.empty()) return;
+    mark_dirty(0);
+    drain(debug);
+  }
+
+  // Schedule the operator at `pos` for the next drain().
+  void mark_dirty(size_t pos) {
+    dirty_[pos] = 1;
+    if (pos < cursor_) cursor_ = pos;
+  }
+
+  // Run every dirty operator, and whatever they propagate to, to completion.
+  void drain(bool debug = false) {
+    const size_t n = ops_.size();
+    size_t cursor = cursor_;
+    try {
+      while (cursor < n) {
+        if (!dirty_[cursor]) {
+          ++cursor;
+          continue;
+        }
+        dirty_[cursor] = 0;
+        const uint64_t mask = ops_[cursor]->execute_local(debug);
+        size_t next = cursor + 1;
+        if (mask) {
+          for (uint32_t e = edge_begin_[cursor]; e < edge_begin_[cursor + 1]; ++e) {
+            if (mask & edges_[e].port_bit) {
+              dirty_[edges_[e].target] = 1;
+              next = std::min<size_t>(next, edges_[e].target);
+            }
+          }
+        }
+        cursor = next;
+      }
+    } catch (...) {
+      // Leave no stale work behind for the next pass.
+      std::fill(dirty_.begin(), dirty_.end(), 0);
+      cursor_ = n;
+      throw;
+    }
+    cursor_ = n;
+  }
+
+  // Position of `op` in the order, or npos when it is not scheduled here.
+  size_t position(const Operator* op) const {
+    auto it = index_.find(op);
+    return it == index_.end() ? npos : it->second;
+  }
+
+  size_t size() const { return ops_.size(); }
+  const std::vector<Operator*>& order() const { return ops_; }
+
+ private:
+  struct Edge {
+    uint64_t port_bit;
+    uint32_t target;
+  };
+
+  std::vector<Operator*> ops_;
+  std::unordered_map<const Operator*, uint32_t> index_;
+  std::vector<uint32_t> edge_begin_;
+  std::vector<Edge> edges_;
+  std::vector<uint8_t> dirty_;
+  size_t cursor_{0};
+};
+
+}  // namespace rtbot
+
+#endif  // EXECUTION_SCHEDULE_H
@@ -79,6 +79,7 @@ class Join : public Operator {
   }
 
   std::string type_name() const override { return "Join"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Join>(*this); }
 
   // Get port configuration
   const std::vector<std::string>& get_port_types() const { return port_type_names_; }
@@ -0,0 +1,208 @@
+#ifndef KEY_TABLE_H
+#define KEY_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace rtbot {
+
+// Hash table from double keys to values, for per-key state (KeyedPipeline).
+//
+// Lookups go through a flat open-addressing index (linear probing, power-of-
+// two capacity, at most half full, backward-shift deletion so there are no
+// tombstones) holding slot numbers into a slab of entries. The slab is a
+// deque with a free list, so a value's address stays valid until it is
+// erased and erasing never moves other values.
+//
+// Entries also sit on an intrusive recency list, least recently touched
+// first, which is what idle-TTL and LRU eviction walk. Keys compare by
+// value with -0.0 folded into 0.0 and every NaN treated as one key.
+template <typename V>
+class KeyTable {
+ public:
+  using Slot = uint32_t;
+  static constexpr Slot npos = std::numeric_limits<Slot>::max();
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  Slot find(double key) const {
+    if (index_.empty()) return npos;
+    const uint64_t bits = key_bits(key);
+    const size_t mask = index_.size() - 1;
+    for (size_t i = mix(bits) & mask;; i = (i + 1) & mask) {
+      const Slot s = index_[i];
+      if (s == npos) return npos;
+      if (entries_[s].bits == bits) return s;
+    }
+  }
+
+  // Slot for `key`, default-constructing the value when the key is new.
+  // A new key is appended as the most recently touched one.
+  std::pair<Slot, bool> insert(double key) {
+    Slot found = find(key);
+    if (found != npos) return {found, false};
+    if ((size_ + 1) * 2 > index_.size()) grow();
+
+    Slot s;
+    if (!free_.empty()) {
+      s = free_.back();
+      free_.pop_back();
+    } else {
+      s = static_cast<Slot>(entries_.size());
+      entries_.emplace_back();
+    }
+    Entry& e = entries_[s];
+    e.key = key;
+    e.bits = key_bits(key);
+    e.live = true;
+    place(s);
+    link_back(s);
+    ++size_;
+    return {s, true};
+  }
+
+  void erase(Slot s) {
+    Entry& e = entries_[s];
+    const size_t mask = index_.size() - 1;
+    size_t i = mix(e.bits) & mask;
+    while (index_[i] != s) i = (i + 1) & mask;
+    // Backward shift: pull later members of the probe run into the hole
+    // unless that would move them before their home position.
+    for (size_t j = (i + 1) & mask; index_[j] != npos; j = (j + 1) & mask) {
+      const size_t home = mix(entries_[index_[j]].bits) & mask;
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        index_[i] = index_[j];
+        i = j;
+      }
+    }
+    index_[i] = npos;
+
+    unlink(s);
+    e.value = V{};
+    e.live = false;
+    e.last_seen = 0;
+    free_.push_back(s);
+    --size_;
+  }
+
+  void clear() {
+    entries_.clear();
+    free_.clear();
+    index_.clear();
+    size_ = 0;
+    oldest_ = newest_ = npos;
+  }
+
+  V& value(Slot s) { return entries_[s].value; }
+  const V& value(Slot s) const { return entries_[s].value; }
+  double key(Slot s) const { return entries_[s].key; }
+  int64_t last_seen(Slot s) const { return entries_[s].last_seen; }
+
+  // Mark `s` as the most recently touched key, seen at event time `time`.
+  void touch(Slot s, int64_t time) {
+    entries_[s].last_seen = time;
+    if (s == newest_) return;
+    unlink(s);
+    link_back(s);
+  }
+
+  // Recency order: oldest() is the least recently touched key.
+  Slot oldest() const { return oldest_; }
+  Slot newest() const { return newest_; }
+  Slot newer(Slot s) const { return entries_[s].next; }
+  Slot older(Slot s) const { return entries_[s].prev; }
+
+  // Visits (slot) for every key, least recently touched first.
+  template <typename F>
+  void for_each(F&& f) const {
+    for (Slot s = oldest_; s != npos; s = entries_[s].next) f(s);
+  }
+
+ private:
+  struct Entry {
+    double key{0.0};
+    uint64_t bits{0};
+    V value{};
+    int64_t last_seen{0};
+    Slot prev{npos};
+    Slot next{npos};
+    bool live{false};
+  };
+
+  static uint64_t key_bits(double key) {
+    if (key == 0.0) key = 0.0;
+    if (key != key) key = std::numeric_limits<double>::quiet_NaN();
+    uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+  }
+
+  // splitmix64 finalizer: keys are often small integers or prices whose
+  // low mantissa bits are all zero.
+  static size_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(x);
+  }
+
+  void place(Slot s) {
+    const size_t mask = index_.size() - 1;
+    size_t i = mix(entries_[s].bits) & mask;
+    while (index_[i] != npos) i = (i + 1) & mask;
+    index_[i] = s;
+  }
+
+  void grow() {
+    index_.assign(index_.empty() ? 16 : index_.size() * 2, npos);
+    for (Slot s = 0; s < entries_.size(); ++s) {
+      if (entries_[s].live) place(s);
+    }
+  }
+
+  void link_back(Slot s) {
+    Entry& e = entries_[s];
+    e.prev = newest_;
+    e.next = npos;
+    if (newest_ != npos) {
+      entries_[newest_].next = s;
+    } else {
+      oldest_ = s;
+    }
+    newest_ = s;
+  }
+
+  void unlink(Slot s) {
+    Entry& e = entries_[s];
+    if (e.prev != npos) {
+      entries_[e.prev].next = e.next;
+    } else {
+      oldest_ = e.next;
+    }
+    if (e.next != npos) {
+      entries_[e.next].prev = e.prev;
+    } else {
+      newest_ = e.prev;
+    }
+    e.prev = e.next = npos;
+  }
+
+  std::deque<Entry> entries_;
+  std::vector<Slot> free_;
+  std::vector<Slot> index_;
+  size_t size_{0};
+  Slot oldest_{npos};
+  Slot newest_{npos};
+};
+
+}  // namespace rtbot
+
+#endif  // KEY_TABLE_H
@@ -0,0 +1,144 @@
+#ifndef RTBOT_LATENCY_HISTOGRAM_H
+#define RTBOT_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <string>
+
+namespace rtbot {
+
+// Log-linear (HDR-style) histogram of nanosecond latencies.
+//
+// Values below 2^kSubBucketBits get one bucket each; above that every power
+// of two is split into 2^(kSubBucketBits - 1) equal sub-buckets, so a bucket
+// is never wider than 1/32 of the values it holds (about 3% relative error)
+// across the full uint64_t range. The counts live in a fixed array: record()
+// is a count-leading-zeros, a shift and an increment, and never allocates.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 6;
+  static constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+  static constexpr uint64_t kSubBucketHalf = kSubBucketCount / 2;
+  static constexpr size_t kBucketCount = kSubBucketCount + (64 - kSubBucketBits) * kSubBucketHalf;
+
+  void record(uint64_t ns) {
+    ++counts_[index_of(ns)];
+    ++total_;
+    sum_ += ns;
+    if (ns < min_) min_ = ns;
+    if (ns > max_) max_ = ns;
+  }
+
+  void reset() {
+    counts_.fill(0);
+    total_ = 0;
+    sum_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+  }
+
+  void merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBucketCount; ++i) counts_[i] += other.counts_[i];
+    total_ += other.total_;
+    sum_ += other.sum_;
+    if (other.min_ < min_) min_ = other.min_;
+    if (other.max_ > max_) max_ = other.max_;
+  }
+
+  uint64_t count() const { return total_; }
+  uint64_t min() const { return total_ ? min_ : 0; }
+  uint64_t max() const { return max_; }
+  double mean() const { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+
+  // Smallest recorded-bucket upper bound with at least `percentile` percent
+  // of the samples at or below it (clamped to the observed max), so p100 is
+  // the max and the estimate never understates a tail.
+  uint64_t percentile(double percentile) const {
+    if (total_ == 0) return 0;
+    if (percentile >= 100.0) return max_;
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total_) + 0.5);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        const uint64_t upper = highest_equivalent(i);
+        return upper < max_ ? (upper > min_ ? upper : min_) : max_;
+      }
+    }
+    return max_;
+  }
+
+  // Bucket layout, exposed for tests: index of the bucket holding `value`
+  // and the largest value that maps to bucket `index`.
+  static size_t index_of(uint64_t value) {
+    if (value < kSubBucketCount) return static_cast<size_t>(value);
+    const int msb = 63 - __builtin_clzll(value);
+    const int shift = msb - kSubBucketBits + 1;
+    const uint64_t sub = value >> shift;  // in [kSubBucketHalf, kSubBucketCount)
+    return static_cast<size_t>(kSubBucketCount + static_cast<uint64_t>(shift - 1) * kSubBucketHalf +
+                               (sub - kSubBucketHalf));
+  }
+
+  static uint64_t highest_equivalent(size_t index) {
+    if (index < kSubBucketCount) return index;
+    const uint64_t rel = index - kSubBucketCount;
+    const int shift = static_cast<int>(rel / kSubBucketHalf) + 1;
+    const uint64_t sub = kSubBucketHalf + rel % kSubBucketHalf;
+    const uint64_t lowest = sub << shift;
+    const uint64_t width = uint64_t{1} << shift;
+    return lowest + (width - 1);
+  }
+
+  // One row: label, count, mean, p50/p90/p99/p999 and max, in microseconds.
+  void dump(std::ostream& os, const std::string& label) const {
+    auto us = [](double ns) { return ns / 1e3; };
+    os << std::left << std::setw(24) << label << std::right << std::setw(12) << total_ << std::fixed
+       << std::setprecision(2) << std::setw(10) << us(mean()) << std::setw(10) << us(percentile(50))
+       << std::setw(10) << us(percentile(90)) << std::setw(10) << us(percentile(99)) << std::setw(10)
+       << us(percentile(99.9)) << std::setw(10) << us(max()) << "\n";
+  }
+
+  static void dump_header(std::ostream& os) {
+    os << std::left << std::setw(24) << "latency (us)" << std::right << std::setw(12) << "count" << std::setw(10)
+       << "mean" << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10)
+       << "p999" << std::setw(10) << "max" << "\n";
+    os << std::string(96, '-') << "\n";
+  }
+
+ private:
+  std::array<uint64_t, kBucketCount> counts_{};
+  uint64_t total_{0};
+  uint64_t sum_{0};
+  uint64_t min_{std::numeric_limits<uint64_t>::max()};
+  uint64_t max_{0};
+};
+
+// Records the wall time of the enclosing scope into `histogram` when it is
+// non-null; a null histogram makes it a no-op without reading the clock.
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram* histogram) : histogram_(histogram) {
+    if (histogram_) start_ = std::chrono::steady_clock::now();
+  }
+  ~ScopedLatency() {
+    if (!histogram_) return;
+    histogram_->record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count()));
+  }
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+ private:
+  LatencyHistogram* histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace rtbot
+
+#endif  // RTBOT_LATENCY_HISTOGRAM_H
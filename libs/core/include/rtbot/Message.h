@@ -10,6 +10,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "rtbot/MessageArena.h"
 #include "rtbot/PerfCounters.h"
 
 namespace rtbot {
@@ -110,6 +111,8 @@ struct BooleanData {
 // remaining allocator tier after the Message<T> pool (see below) is gone.
 // Recycle buffers through a TL ring; on last-shared_ptr death the custom
 // deleter returns the vector to the freelist with its capacity retained.
+// The control block goes through ArenaAllocator, so inside a
+// MessageArena::Scope it is bump-allocated rather than malloc'd.
 struct VectorBufferPool {
   static constexpr std::size_t kCap = 1024;
   std::vector<std::vector<double>*> slots;
@@ -135,7 +138,8 @@ inline std::shared_ptr<std::vector<double>> make_pooled_vector_double(
     raw = new std::vector<double>(size);
   }
   return std::shared_ptr<std::vector<double>>(
-      raw, [](std::vector<double>* v) noexcept {
+      raw,
+      [](std::vector<double>* v) noexcept {
         auto& p = tls_vector_double_pool();
         if (p.slots.size() < VectorBufferPool::kCap) {
           v->clear();
@@ -143,7 +147,8 @@ inline std::shared_ptr<std::vector<double>> make_pooled_vector_double(
         } else {
           delete v;
         }
-      });
+      },
+      ArenaAllocator<std::vector<double>>{});
 }
 
 struct VectorNumberData {
@@ -153,6 +158,18 @@ struct VectorNumberData {
   // then wrap it with make_shared or use the convenience constructor.
   std::shared_ptr<std::vector<double>> values;
 
+  // View over `values`: element i is (*values)[offset + i * stride], for
+  // `length` elements. The constructors cover the whole buffer (length ==
+  // kWhole, size() follows values->size()), so producers can keep filling
+  // `values` in place. slice() makes projections and column ranges share
+  // the parent buffer instead of copying it. Readers go through size() /
+  // operator[] (or materialize() when they need a contiguous vector), never
+  // through *values directly.
+  static constexpr std::size_t kWhole = static_cast<std::size_t>(-1);
+  std::size_t offset = 0;
+  std::size_t stride = 1;
+  std::size_t length = kWhole;
+
   VectorNumberData() : values(make_pooled_vector_double(0)) {}
   // Copy into a pooled buffer — `v`'s allocator can't be recycled since we
   // don't own it. Hot-path emitters (FE/FEV) should build directly into a
@@ -163,13 +180,41 @@ struct VectorNumberData {
   VectorNumberData(std::shared_ptr<std::vector<double>> v)
       : values(std::move(v)) {}
 
+  std::size_t size() const { return length == kWhole ? values->size() : length; }
+  double operator[](std::size_t i) const { return (*values)[offset + i * stride]; }
+  bool is_view() const { return length != kWhole; }
+
+  // Pointer to element 0 when the elements are adjacent in memory (whole
+  // buffers and stride-1 slices), nullptr otherwise.
+  const double* contiguous_data() const { return stride == 1 ? values->data() + offset : nullptr; }
+
+  // `count` elements starting at element `first`, `step` apart, sharing this
+  // buffer. The caller checks the range against size().
+  VectorNumberData slice(std::size_t first, std::size_t count, std::size_t step = 1) const {
+    VectorNumberData view(values);
+    view.offset = offset + first * stride;
+    view.stride = stride * step;
+    view.length = count;
+    return view;
+  }
+
+  // The elements as one contiguous vector: the buffer itself when this
+  // covers all of it, otherwise a pooled copy.
+  std::shared_ptr<std::vector<double>> materialize() const {
+    if (!is_view()) return values;
+    auto out = make_pooled_vector_double(length);
+    for (std::size_t i = 0; i < length; ++i) (*out)[i] = (*this)[i];
+    return out;
+  }
+
   Bytes serialize() const {
     Bytes bytes;
-    size_t size = values->size();
+    size_t size = this->size();
     bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&size),
                  reinterpret_cast<const uint8_t*>(&size) + sizeof(size));
 
-    for (const auto& value : *values) {
+    for (size_t i = 0; i < size; ++i) {
+      const double value = (*this)[i];
       bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&value),
                    reinterpret_cast<const uint8_t*>(&value) + sizeof(value));
     }
@@ -206,9 +251,9 @@ struct VectorNumberData {
 
   uint64_t hash() const {
     uint64_t result = 0;
-    for (int i=0; i < values->size(); i++) {
+    for (size_t i = 0; i < size(); i++) {
       uint64_t u;
-      double value = values->at(i);
+      double value = (*this)[i];
       uint64_t quantize = static_cast<uint64_t>(value * 1e9);
       std::memcpy(&u, &quantize, sizeof(uint64_t));
       result = result + u;
@@ -336,8 +381,11 @@ class Message : public BaseMessage {
   // blocks themselves to short-circuit malloc/free on the common case.
   //
   // Note: this pools the Message<T> object only. For T = VectorNumberData the
-  // inner std::vector<double> still allocates its own buffer; that is tracked
-  // as a follow-up optimization.
+  // inner std::vector<double> is recycled by VectorBufferPool.
+  //
+  // Inside a MessageArena::Scope the pool is bypassed and blocks are bumped
+  // out of the thread's arena. All blocks, pooled or not, carry the arena
+  // block header, so operator delete can tell the two apart.
  private:
   struct Pool {
     static constexpr std::size_t kCap = 1024;
@@ -345,7 +393,7 @@ class Message : public BaseMessage {
     std::size_t count = 0;
     ~Pool() {
       for (std::size_t i = 0; i < count; ++i) {
-        ::operator delete(slots[i]);
+        MessageArena::deallocate(slots[i]);
       }
     }
   };
@@ -357,6 +405,10 @@ class Message : public BaseMessage {
 
  public:
   static void* operator new(std::size_t sz) {
+    if (MessageArena::active()) {
+      RTBOT_PERF_COUNT(MSG_ALLOC_ARENA);
+      return MessageArena::allocate(sz);
+    }
     if (sz == sizeof(Message<T>)) {
       Pool& pool = tls_pool();
       if (pool.count > 0) {
@@ -365,29 +417,31 @@ class Message : public BaseMessage {
       }
     }
     RTBOT_PERF_COUNT(MSG_ALLOC_POOL_MISS);
-    return ::operator new(sz);
+    return MessageArena::heap_allocate(sz);
   }
 
   static void operator delete(void* p, std::size_t sz) noexcept {
     if (!p) return;
-    if (sz == sizeof(Message<T>)) {
+    if (sz == sizeof(Message<T>) && !MessageArena::owns(p)) {
       Pool& pool = tls_pool();
       if (pool.count < Pool::kCap) {
         pool.slots[pool.count++] = p;
         return;
       }
     }
-    ::operator delete(p);
+    MessageArena::deallocate(p);
   }
 
   static void operator delete(void* p) noexcept {
     if (!p) return;
-    Pool& pool = tls_pool();
-    if (pool.count < Pool::kCap) {
-      pool.slots[pool.count++] = p;
-      return;
+    if (!MessageArena::owns(p)) {
+      Pool& pool = tls_pool();
+      if (pool.count < Pool::kCap) {
+        pool.slots[pool.count++] = p;
+        return;
+      }
     }
-    ::operator delete(p);
+    MessageArena::deallocate(p);
   }
   // --- end pool ------------------------------------------------------------------
 
@@ -401,9 +455,9 @@ class Message : public BaseMessage {
       ss << (data.value ? "true" : "false");
     } else if constexpr (std::is_same_v<T, VectorNumberData>) {
       ss << "[";
-      for (size_t i = 0; i < data.values->size(); ++i) {
+      for (size_t i = 0; i < data.size(); ++i) {
         if (i > 0) ss << ", ";
-        ss << (*data.values)[i];
+        ss << data[i];
       }
       ss << "]";
     } else if constexpr (std::is_same_v<T, VectorBooleanData>) {
@@ -498,6 +552,23 @@ std::unique_ptr<Message<T>> create_message(timestamp_t time, const T& data) {
   return std::make_unique<Message<T>>(time, data);
 }
 
+// Copy of `msg` for operator state kept past the current receive call. The
+// copy is heap-allocated even inside a MessageArena::Scope, so it never pins
+// an arena chunk. Inside a scope a VectorNumberData payload is copied into a
+// fresh buffer rather than shared, since its control block may be in the
+// arena.
+inline std::unique_ptr<BaseMessage> retain_message(const BaseMessage& msg) {
+  const bool in_arena = MessageArena::active() != nullptr;
+  MessageArena::Suspend heap;
+  if (in_arena && msg.type() == typeid(VectorNumberData)) {
+    const auto& vec = static_cast<const Message<VectorNumberData>&>(msg);
+    auto values = make_pooled_vector_double(vec.data.size());
+    for (std::size_t i = 0; i < values->size(); ++i) (*values)[i] = vec.data[i];
+    return create_message<VectorNumberData>(vec.time, VectorNumberData(std::move(values)));
+  }
+  return msg.clone();
+}
+
 using PortMsgBatch = std::vector<std::unique_ptr<BaseMessage>>;
 using OperatorMsgBatch = std::unordered_map<std::string, PortMsgBatch>;
 using ProgramMsgBatch = std::unordered_map<std::string, OperatorMsgBatch>;
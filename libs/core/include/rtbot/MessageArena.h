@@ -0,0 +1,268 @@
+#ifndef MESSAGE_ARENA_H
+#define MESSAGE_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace rtbot {
+
+// Bump arena for the transient messages of one Program::receive /
+// receive_batch call.
+//
+// While a MessageArena::Scope is open on the calling thread, Message<T>
+// objects and the shared_ptr control blocks of pooled VectorNumberData
+// buffers are carved out of 64 KiB chunks instead of coming from the
+// Message<T> pool or malloc. Every block (arena or heap) is preceded by a
+// 16-byte header naming its chunk, so a free only has to bump the chunk's
+// freed count. When the outermost scope closes and everything carved from
+// the current chunk is gone — the common case, since queues are drained
+// within the call — the chunk is rewound wholesale.
+//
+// Blocks that outlive the call (the returned output batch, messages still
+// waiting in a join queue) keep their chunk alive: it is retired, and goes
+// to a spare list once the last of its blocks is freed, on whichever thread
+// that happens. Operator state that is kept across calls (Buffer windows,
+// Pipeline output buffers) must not pin chunks: build it under
+// MessageArena::Suspend, or copy it out with retain_message().
+class MessageArena {
+ public:
+  static constexpr std::size_t kChunkBytes = 64 * 1024;
+  static constexpr std::size_t kHeaderBytes = alignof(std::max_align_t);
+  static constexpr std::size_t kMaxSpareChunks = 8;
+
+  struct Chunk {
+    MessageArena* owner = nullptr;
+    char* cursor = nullptr;
+    char* end = nullptr;
+    // Owner-thread counts while the chunk is current.
+    std::size_t allocated = 0;
+    std::size_t freed = 0;
+    bool retired = false;
+    // Frees from other threads, and every free once retired. Negative while
+    // the chunk is current; retire() folds the owner's counts in, so after
+    // that it is the number of live blocks.
+    std::atomic<std::int64_t> pending{0};
+  };
+
+  // Opens an arena on the calling thread for its lifetime. Scopes nest; the
+  // outermost one rewinds (or retires) the current chunk when it closes.
+  class Scope {
+   public:
+    explicit Scope(bool enabled = true) : enabled_(enabled) {
+      if (!enabled_) return;
+      MessageArena& arena = tls();
+      prev_ = active();
+      ++arena.depth_;
+      active() = &arena;
+    }
+    ~Scope() {
+      if (!enabled_) return;
+      MessageArena& arena = tls();
+      active() = prev_;
+      if (--arena.depth_ == 0) arena.rewind();
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    bool enabled_;
+    MessageArena* prev_ = nullptr;
+  };
+
+  // Routes allocations back to the heap for its lifetime, for objects that
+  // will be kept past the enclosing Scope.
+  class Suspend {
+   public:
+    Suspend() : prev_(active()) { active() = nullptr; }
+    ~Suspend() { active() = prev_; }
+    Suspend(const Suspend&) = delete;
+    Suspend& operator=(const Suspend&) = delete;
+
+   private:
+    MessageArena* prev_;
+  };
+
+  // Arena the calling thread allocates from: nullptr outside a Scope or
+  // inside a Suspend. Trivially initialized, so the allocation path check is
+  // a single thread-local load.
+  static MessageArena*& active() noexcept {
+    thread_local MessageArena* arena = nullptr;
+    return arena;
+  }
+
+  // `size` bytes behind a block header: from the active arena when there is
+  // one and the block fits in a chunk, otherwise from the heap.
+  static void* allocate(std::size_t size) {
+    if (MessageArena* arena = active()) {
+      if (void* p = arena->bump(size)) return p;
+    }
+    return heap_allocate(size);
+  }
+
+  static void* heap_allocate(std::size_t size) {
+    char* raw = static_cast<char*>(::operator new(kHeaderBytes + size));
+    Chunk* none = nullptr;
+    std::memcpy(raw, &none, sizeof(none));
+    return raw + kHeaderBytes;
+  }
+
+  static void deallocate(void* p) noexcept {
+    if (Chunk* chunk = chunk_of(p)) {
+      release(chunk);
+    } else {
+      ::operator delete(static_cast<char*>(p) - kHeaderBytes);
+    }
+  }
+
+  // True when `p` (returned by allocate) lives in an arena chunk.
+  static bool owns(const void* p) noexcept { return chunk_of(p) != nullptr; }
+
+  ~MessageArena() {
+    self() = nullptr;
+    if (current_) retire(current_);
+    for (Chunk* c : spares_) free_chunk(c);
+  }
+
+ private:
+  MessageArena() {
+    spares_.reserve(kMaxSpareChunks);
+    self() = this;
+  }
+
+  static MessageArena& tls() {
+    thread_local MessageArena arena;
+    return arena;
+  }
+
+  // This thread's arena, or nullptr before it is created / after it is
+  // destroyed. Used by the free path, which must not construct one.
+  static MessageArena*& self() noexcept {
+    thread_local MessageArena* arena = nullptr;
+    return arena;
+  }
+
+  static constexpr std::size_t round_up(std::size_t n) noexcept {
+    return (n + kHeaderBytes - 1) & ~(kHeaderBytes - 1);
+  }
+
+  static constexpr std::size_t kDataOffset = (sizeof(Chunk) + kHeaderBytes - 1) & ~(kHeaderBytes - 1);
+
+  static Chunk* chunk_of(const void* p) noexcept {
+    Chunk* chunk;
+    std::memcpy(&chunk, static_cast<const char*>(p) - kHeaderBytes, sizeof(chunk));
+    return chunk;
+  }
+
+  void* bump(std::size_t size) {
+    const std::size_t need = kHeaderBytes + round_up(size);
+    if (!current_ || static_cast<std::size_t>(current_->end - current_->cursor) < need) {
+      if (need > kChunkBytes - kDataOffset) return nullptr;
+      if (current_) retire(current_);
+      current_ = acquire_chunk();
+    }
+    char* raw = current_->cursor;
+    current_->cursor += need;
+    ++current_->allocated;
+    std::memcpy(raw, &current_, sizeof(current_));
+    return raw + kHeaderBytes;
+  }
+
+  Chunk* acquire_chunk() {
+    Chunk* c;
+    if (!spares_.empty()) {
+      c = spares_.back();
+      spares_.pop_back();
+    } else {
+      c = new (::operator new(kChunkBytes)) Chunk;
+    }
+    c->owner = this;
+    c->cursor = reinterpret_cast<char*>(c) + kDataOffset;
+    c->end = reinterpret_cast<char*>(c) + kChunkBytes;
+    c->allocated = 0;
+    c->freed = 0;
+    c->retired = false;
+    c->pending.store(0, std::memory_order_relaxed);
+    return c;
+  }
+
+  // Closing the outermost scope: reuse the chunk in place when nothing
+  // carved from it is alive, otherwise leave it to its remaining blocks.
+  void rewind() {
+    if (!current_) return;
+    Chunk* c = current_;
+    const auto live = static_cast<std::int64_t>(c->allocated - c->freed) + c->pending.load(std::memory_order_acquire);
+    if (live == 0) {
+      c->cursor = reinterpret_cast<char*>(c) + kDataOffset;
+      c->allocated = 0;
+      c->freed = 0;
+      c->pending.store(0, std::memory_order_relaxed);
+    } else {
+      retire(c);
+      current_ = nullptr;
+    }
+  }
+
+  // Owner thread only. Whoever brings `pending` to zero afterwards recycles.
+  static void retire(Chunk* c) noexcept {
+    c->retired = true;
+    const auto outstanding = static_cast<std::int64_t>(c->allocated - c->freed);
+    if (c->pending.fetch_add(outstanding, std::memory_order_acq_rel) + outstanding == 0) recycle(c);
+  }
+
+  static void release(Chunk* c) noexcept {
+    if (c->owner == self() && !c->retired) {
+      ++c->freed;
+      return;
+    }
+    if (c->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) recycle(c);
+  }
+
+  static void recycle(Chunk* c) noexcept {
+    MessageArena* arena = self();
+    if (arena && arena->spares_.size() < kMaxSpareChunks) {
+      arena->spares_.push_back(c);  // capacity reserved up front
+    } else {
+      free_chunk(c);
+    }
+  }
+
+  static void free_chunk(Chunk* c) noexcept {
+    c->~Chunk();
+    ::operator delete(static_cast<void*>(c));
+  }
+
+  Chunk* current_ = nullptr;
+  std::vector<Chunk*> spares_;
+  int depth_ = 0;
+};
+
+// Standard allocator over MessageArena::allocate, used for shared_ptr
+// control blocks so they follow the same arena / heap routing as messages.
+template <typename T>
+struct ArenaAllocator {
+  using value_type = T;
+
+  ArenaAllocator() noexcept = default;
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) { return static_cast<T*>(MessageArena::allocate(n * sizeof(T))); }
+  void deallocate(T* p, std::size_t) noexcept { MessageArena::deallocate(p); }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>&) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>&) const noexcept {
+    return false;
+  }
+};
+
+}  // namespace rtbot
+
+#endif  // MESSAGE_ARENA_H
@@ -0,0 +1,52 @@
+#ifndef MESSAGE_BATCH_H
+#define MESSAGE_BATCH_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "rtbot/Message.h"
+
+namespace rtbot {
+
+// Columnar run of scalar messages: a timestamp array plus a value array of
+// equal length, in time order. Operators with a columnar kernel drain their
+// value queue into one of these (Operator::drain_value_queue), run a tight
+// loop over `values` and hand the result to Operator::emit_output in one
+// call, instead of paying a queue pop / emit per message. BooleanData is
+// carried as 0.0 / 1.0, as in ScalarRecord.
+template <typename T>
+struct MessageBatch {
+  static_assert(std::is_same_v<T, NumberData> || std::is_same_v<T, BooleanData>,
+                "MessageBatch holds NumberData or BooleanData");
+
+  std::vector<timestamp_t> times;
+  std::vector<double> values;
+
+  size_t size() const { return times.size(); }
+  bool empty() const { return times.empty(); }
+
+  void clear() {
+    times.clear();
+    values.clear();
+  }
+
+  void reserve(size_t n) {
+    times.reserve(n);
+    values.reserve(n);
+  }
+
+  void resize(size_t n) {
+    times.resize(n);
+    values.resize(n);
+  }
+
+  void push_back(timestamp_t time, double value) {
+    times.push_back(time);
+    values.push_back(value);
+  }
+};
+
+}  // namespace rtbot
+
+#endif  // MESSAGE_BATCH_H
@@ -39,6 +39,7 @@ class Multiplexer : public Operator {
   size_t get_num_ports() const { return data_ports_.size(); }
 
   std::string type_name() const override { return "Multiplexer"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Multiplexer>(*this); }
 
   bool equals(const Multiplexer& other) const {
     return Operator::equals(other);
@@ -1,6 +1,7 @@
 #ifndef OPERATOR_H
 #define OPERATOR_H
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
@@ -17,6 +18,9 @@
 
 #include "rtbot/Base64.h"
 #include "rtbot/Message.h"
+#include "rtbot/MessageBatch.h"
+#include "rtbot/OperatorProfile.h"
+#include "rtbot/ScalarQueue.h"
 #include "rtbot/StateSerializer.h"
 #include "rtbot/telemetry/OpenTelemetry.h"
 
@@ -27,14 +31,21 @@ namespace rtbot {
 // they save in per-connection amortization.
 inline constexpr size_t kEmitBatchThreshold = 20;
 
-// Queue of messages for ports
-using MessageQueue = std::deque<std::unique_ptr<BaseMessage>>;
+// Queue of messages for ports: a power-of-two ring that grows on demand and
+// never shrinks, so steady-state dispatch does not touch the allocator once a
+// port has seen its largest burst (see reserve_queues for preallocation).
+using MessageQueue = RingQueue<std::unique_ptr<BaseMessage>>;
 
 // Port information
 struct PortInfo {
   MessageQueue queue;
   std::type_index type;
   timestamp_t last_timestamp{std::numeric_limits<timestamp_t>::min()};
+  // Value-mode ports (NumberData / BooleanData only, opted into by the owning
+  // operator via enable_value_queue) buffer (time, value) records here and
+  // leave `queue` empty.
+  ScalarQueue values;
+  bool value_mode{false};
 
   // Constructor
   PortInfo(MessageQueue q, std::type_index t)
@@ -65,6 +76,13 @@ class Operator {
 
   virtual std::string type_name() const = 0;
 
+  // Typed copy of a freshly built, unconnected operator: its configuration
+  // and port layout, without connections, queued messages or profiling.
+  // KeyedPipeline stamps each new key's sub-graph out of a compiled
+  // prototype this way instead of re-reading its JSON. nullptr means the
+  // operator cannot be cloned (composites, graph endpoints).
+  virtual std::shared_ptr<Operator> clone() const { return nullptr; }
+
   // Composite operators (Pipeline, TriggerSet) override to expose their
   // internal operators. Returning nullptr — the common case — means "no
   // children", avoiding the dynamic_pointer_cast probes Program used to do
@@ -100,7 +118,11 @@ class Operator {
     // used for ordering validation under debug and is rederivable from the
     // queue contents on replay).
     for (const auto& port : data_ports_) {
-      StateSerializer::serialize_message_queue(bytes, port.queue);
+      if (port.value_mode) {
+        StateSerializer::serialize_scalar_queue(bytes, port.values, port.type);
+      } else {
+        StateSerializer::serialize_message_queue(bytes, port.queue);
+      }
     }
     for (const auto& port : control_ports_) {
       StateSerializer::serialize_message_queue(bytes, port.queue);
@@ -129,7 +151,11 @@ class Operator {
 
     // ---- Restore message queues ----
     for (auto& port : data_ports_) {
+      if (port.value_mode) {
+        StateSerializer::deserialize_scalar_queue(it, port.values);
+      } else {
         StateSerializer::deserialize_message_queue(it, port.queue);
+      }
     }
     for (auto& port : control_ports_) {
         StateSerializer::deserialize_message_queue(it, port.queue);
@@ -142,6 +168,60 @@ class Operator {
     restore(it);
   }
 
+  // Binary snapshot (Program::serialize_binary). The default writes the
+  // port queues in the binary encoding, followed by whatever a subclass
+  // appends in collect_bytes() after the base port section, as an opaque
+  // tail. Operators whose state is large or nested (Buffer, composites)
+  // override both methods to write it natively.
+  virtual void write_state(ByteWriter& w) {
+    write_ports(w);
+    const Bytes legacy = collect_bytes();
+    const size_t prefix = legacy_port_bytes(legacy);
+    w.write_blob(legacy.data() + prefix, legacy.size() - prefix);
+  }
+
+  virtual void read_state(ByteReader& r) {
+    read_ports(r);
+    size_t tail_size = 0;
+    const uint8_t* tail = r.read_blob(tail_size);
+    // Every operator that adds to collect_bytes() also overrides restore(),
+    // so an empty tail means there is nothing beyond the ports to restore.
+    if (tail_size == 0) return;
+    Bytes legacy = Operator::collect_bytes();
+    legacy.insert(legacy.end(), tail, tail + tail_size);
+    auto it = legacy.cbegin();
+    restore(it);
+  }
+
+  // Incremental checkpoints (Program::checkpoint_delta). execute, receive
+  // and reset mark the operator dirty; mark_checkpoint(epoch) closes an
+  // epoch, recording it as the last one in which the operator changed if it
+  // was dirty. An operator that is not marked at a checkpoint must not have
+  // changed since the one it was last marked at: composites that skip
+  // untouched children (KeyedPipeline keys) rely on that.
+  bool state_dirty() const { return state_dirty_; }
+  void mark_state_dirty() { state_dirty_ = true; }
+  bool modified_since(uint64_t epoch) const { return state_dirty_ || modified_epoch_ > epoch; }
+  uint64_t checkpoint_epoch() const { return checkpoint_epoch_; }
+
+  virtual void mark_checkpoint(uint64_t epoch) {
+    if (state_dirty_) {
+      modified_epoch_ = epoch;
+      state_dirty_ = false;
+    }
+    checkpoint_epoch_ = epoch;
+  }
+
+  // Changes since checkpoint `since_epoch`, to be applied by read_delta()
+  // on state restored up to that checkpoint. The default is the full state;
+  // Buffer and KeyedPipeline write only what changed.
+  virtual void write_delta(ByteWriter& w, uint64_t since_epoch) {
+    (void)since_epoch;
+    write_state(w);
+  }
+
+  virtual void read_delta(ByteReader& r) { read_state(r); }
+
   // Dynamic port management with type information
   template <typename T>
   void add_data_port() {
@@ -165,6 +245,7 @@ class Operator {
   // Runtime port access for data with type checking
   virtual void receive_data(std::unique_ptr<BaseMessage> msg, size_t port_index, bool debug = false) {
     RTBOT_PERF_SCOPE(RECEIVE_DATA);
+    state_dirty_ = true;
     if (port_index >= data_ports_.size()) {
       throw std::runtime_error("Invalid data port index at " + type_name() + "(" + id_ + ")" + ":" +
                                std::to_string(port_index));
@@ -189,6 +270,10 @@ class Operator {
     RTBOT_RECORD_MESSAGE(id_, type_name(), std::move(msg->clone()));
 #endif
 
+    if (data_ports_[port_index].value_mode) {
+      data_ports_[port_index].values.push_back({msg->time, scalar_value(*msg)});
+      return;
+    }
     data_ports_[port_index].queue.push_back(std::move(msg));
   }
 
@@ -233,10 +318,57 @@ class Operator {
     }
   }
 
+  // Columnar variant — append a whole MessageBatch to a NumberData /
+  // BooleanData port. Value-mode ports take the columns as records in one
+  // loop; message ports get one Message per row. Same checks as receive_data.
+  template <typename T>
+  void receive_data_columns(const MessageBatch<T>& batch, size_t port_index, bool debug = false) {
+    if (port_index >= data_ports_.size()) {
+      throw std::runtime_error("Invalid data port index at " + type_name() + "(" + id_ + ")" + ":" +
+                               std::to_string(port_index));
+    }
+    auto& port = data_ports_[port_index];
+    if (port.type != std::type_index(typeid(T))) {
+      throw std::runtime_error("Type mismatch on data port at " + type_name() + "(" + id_ + ")" + ":" +
+                               std::to_string(port_index));
+    }
+    if (batch.empty()) return;
+    if (debug) {
+      for (timestamp_t time : batch.times) {
+        if (time <= port.last_timestamp) {
+          throw std::runtime_error("Out of order timestamp received at " + type_name() + "(" + id_ + ")" +
+                                   " port " + std::to_string(port_index) + ". Current timestamp: " +
+                                   std::to_string(time) + ", Last timestamp: " +
+                                   std::to_string(port.last_timestamp));
+        }
+        port.last_timestamp = time;
+      }
+    }
+    port.last_timestamp = batch.times.back();
+
+    const size_t n = batch.size();
+#ifdef RTBOT_INSTRUMENTATION
+    for (size_t i = 0; i < n; ++i) {
+      RTBOT_RECORD_MESSAGE(id_, type_name(), make_scalar_message(port.type, batch.times[i], batch.values[i]));
+    }
+#endif
+    if (port.value_mode) {
+      port.values.reserve(port.values.size() + n);
+      for (size_t i = 0; i < n; ++i) port.values.push_back({batch.times[i], batch.values[i]});
+      return;
+    }
+    port.queue.reserve(port.queue.size() + n);
+    for (size_t i = 0; i < n; ++i) {
+      port.queue.push_back(make_scalar_message(port.type, batch.times[i], batch.values[i]));
+    }
+  }
+
   virtual void reset() {
+    state_dirty_ = true;
     for (auto& port : data_ports_) {
       port.last_timestamp = std::numeric_limits<timestamp_t>::min();
       port.queue.clear();
+      port.values.clear();
     }
     for (auto& port : control_ports_) {
       port.last_timestamp = std::numeric_limits<timestamp_t>::min();
@@ -247,7 +379,66 @@ class Operator {
     }
   }
 
+  // Preallocate every input queue (data, control and value records) and the
+  // debug output queues to hold at least `capacity` entries. Queues still grow
+  // on larger bursts; this only moves first-touch allocations off the hot path.
+  void reserve_queues(size_t capacity) {
+    queue_capacity_ = capacity;
+    for (auto& port : data_ports_) {
+      port.queue.reserve(capacity);
+      if (port.value_mode) port.values.reserve(capacity);
+    }
+    for (auto& port : control_ports_) {
+      port.queue.reserve(capacity);
+    }
+    for (auto& queue : debug_output_queues_) {
+      queue.reserve(capacity);
+    }
+  }
+
+  size_t queue_capacity() const { return queue_capacity_; }
+
+  // Runtime profiling (see OperatorProfile). Enabling starts from zeroed
+  // counters, plus a per-execute LatencyHistogram when `latency` is set;
+  // disabling drops them. profile() is nullptr while disabled.
+  void enable_profiling(bool enabled, bool latency = false) {
+    profile_ = enabled ? std::make_unique<OperatorProfile>() : nullptr;
+    if (!profile_) return;
+    if (latency) profile_->execute_latency = std::make_unique<LatencyHistogram>();
+    profile_->backlog = queued_inputs();
+  }
+
+  bool profiling() const { return profile_ != nullptr; }
+  const OperatorProfile* profile() const { return profile_.get(); }
+
+  void reset_profile() {
+    if (!profile_) return;
+    profile_->reset();
+    profile_->backlog = queued_inputs();
+  }
+
+  // Messages and value records waiting on all data and control ports.
+  size_t queued_inputs() const {
+    size_t n = 0;
+    for (const auto& port : data_ports_) n += port.value_mode ? port.values.size() : port.queue.size();
+    for (const auto& port : control_ports_) n += port.queue.size();
+    return n;
+  }
+
   void execute(bool debug=false) {
+    uint64_t my_mask = execute_local(debug);
+    for (auto& conn : connections_) {
+      if (conn.child && (my_mask & (uint64_t{1} << conn.output_port))) {
+        conn.child->execute(debug);
+      }
+    }
+  }
+
+  // One scheduling step: run this operator's control/data processing without
+  // descending into children, and return the mask of output ports that
+  // emitted. execute() is this plus the recursive walk over connections_;
+  // ExecutionSchedule drives it from a flat loop instead.
+  uint64_t execute_local(bool debug=false) {
     SpanScope span_scope{"operator_execute"};
     RTBOT_ADD_ATTRIBUTE("operator.id", id_);
 
@@ -256,7 +447,7 @@ class Operator {
       if (debug_output_queues_.size() != num_output_ports()) {
         debug_output_queues_.clear();
         for (size_t i = 0; i < num_output_ports(); i++) {
-          debug_output_queues_.emplace_back();
+          debug_output_queues_.emplace_back(queue_capacity_);
         }
       }
     } else if (debug_output_queues_.size() > 0) {
@@ -268,6 +459,16 @@ class Operator {
     // clobber the caller's in-progress propagation state.
     uint64_t saved_mask = propagated_mask_;
     propagated_mask_ = 0;
+    state_dirty_ = true;
+
+    std::chrono::steady_clock::time_point started;
+    if (profile_) {
+      const size_t queued = queued_inputs();
+      if (queued > profile_->backlog) profile_->messages_in += queued - profile_->backlog;
+      if (queued > profile_->queue_high_water) profile_->queue_high_water = queued;
+      ++profile_->executions;
+      started = std::chrono::steady_clock::now();
+    }
 
     // Process control messages first
     if (num_control_ports() > 0) {
@@ -282,21 +483,24 @@ class Operator {
       process_data(debug);
     }
 
+    if (profile_) {
+      const auto elapsed = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count());
+      profile_->process_ns += elapsed;
+      if (profile_->execute_latency) profile_->execute_latency->record(elapsed);
+      profile_->backlog = queued_inputs();
+    }
+
     // Snapshot this call's mask before executing children — a child may
     // recurse back into this->execute() and reset propagated_mask_.
     uint64_t my_mask = propagated_mask_;
     propagated_mask_ = saved_mask;
-
-    for (auto& conn : connections_) {
-      if (conn.child && (my_mask & (uint64_t{1} << conn.output_port))) {
-        conn.child->execute(debug);
-      }
-    }
+    return my_mask;
   }
 
   // Runtime port access for control messages with type checking
   virtual void receive_control(std::unique_ptr<BaseMessage> msg, size_t port_index, bool debug = false) {
-
+    state_dirty_ = true;
     if (port_index >= control_ports_.size()) {
       throw std::runtime_error("Invalid control port index at " + type_name() + "(" + id_ + ")" + ":" +
                                std::to_string(port_index));
@@ -362,6 +566,7 @@ class Operator {
                    ? child->data_ports_[child_port_index]
                    : child->control_ports_[child_port_index];
     conn.sink_queue = &pi.queue;
+    conn.sink_values = pi.value_mode ? &pi.values : nullptr;
     conn.sink_last_ts = &pi.last_timestamp;
     size_t conn_idx = connections_.size();
     connections_.push_back(std::move(conn));
@@ -378,10 +583,14 @@ class Operator {
       child->inbound_control_refs_[child_port_index].push_back({this, conn_idx});
     }
 
-    if (output_port >= conn_count_per_port_.size()) {
-      conn_count_per_port_.resize(output_port + 1, 0);
+    // Splice the edge into its port's slice of the CSR index.
+    if (port_edge_offsets_.size() < output_ports_.size() + 1) {
+      port_edge_offsets_.resize(output_ports_.size() + 1, port_edges_.size());
+      value_conn_count_per_port_.resize(output_ports_.size(), 0);
     }
-    ++conn_count_per_port_[output_port];
+    port_edges_.insert(port_edges_.begin() + port_edge_offsets_[output_port + 1], static_cast<uint32_t>(conn_idx));
+    for (size_t p = output_port + 1; p < port_edge_offsets_.size(); ++p) ++port_edge_offsets_[p];
+    if (pi.value_mode) ++value_conn_count_per_port_[output_port];
     return child;
   }
 
@@ -423,6 +632,13 @@ class Operator {
       for (size_t i = 0; i < data_ports_.size(); ++i) {
         if (data_ports_[i].type != other.data_ports_[i].type) return false;
 
+        if (data_ports_[i].values.size() != other.data_ports_[i].values.size()) return false;
+        for (size_t j = 0; j < data_ports_[i].values.size(); ++j) {
+            if (data_ports_[i].values[j].time != other.data_ports_[i].values[j].time) return false;
+            if (StateSerializer::hash_double(data_ports_[i].values[j].value) !=
+                StateSerializer::hash_double(other.data_ports_[i].values[j].value)) return false;
+        }
+
         if (data_ports_[i].queue.size() != other.data_ports_[i].queue.size()) return false;
         for (size_t j = 0; j < data_ports_[i].queue.size(); ++j) {
             if (data_ports_[i].queue[j]->hash() != other.data_ports_[i].queue[j]->hash()) return false;
@@ -460,6 +676,34 @@ class Operator {
     return data_ports_[port_index].queue;
   }
 
+  // Record queue of a value-mode data port (see enable_value_queue).
+  ScalarQueue& get_value_queue(size_t port_index) {
+    if (port_index >= data_ports_.size()) {
+      throw std::runtime_error("Invalid data port index for value queue");
+    }
+    return data_ports_[port_index].values;
+  }
+
+  bool is_value_port(size_t port_index) const {
+    return port_index < data_ports_.size() && data_ports_[port_index].value_mode;
+  }
+
+  // Move every record of value-mode port `port_index` into `out` (appended)
+  // and leave the queue empty. Columnar kernels start from here.
+  template <typename T>
+  void drain_value_queue(size_t port_index, MessageBatch<T>& out) {
+    auto& queue = get_value_queue(port_index);
+    const size_t n = queue.size();
+    const size_t base = out.size();
+    out.resize(base + n);
+    for (size_t i = 0; i < n; ++i) {
+      const ScalarRecord& rec = queue[i];
+      out.times[base + i] = rec.time;
+      out.values[base + i] = rec.value;
+    }
+    queue.clear();
+  }
+
   MessageQueue& get_control_queue(size_t port_index) {
     if (port_index >= control_ports_.size()) {
       throw std::runtime_error("Invalid control port index for control queue");
@@ -498,6 +742,9 @@ class Operator {
     // this fast path (Input, the only operator with custom receive logic,
     // is always the graph entry and never a connection child).
     MessageQueue* sink_queue{nullptr};
+    // Set instead of being used through sink_queue when the child port is in
+    // value mode: scalar emissions land as (time, value) records.
+    ScalarQueue* sink_values{nullptr};
     // Cached pointer to the child port's last_timestamp for debug-mode
     // ordering validation.
     timestamp_t* sink_last_ts{nullptr};
@@ -518,6 +765,34 @@ class Operator {
     return connections_[conn_index];
   }
 
+  size_t num_connections() const { return connections_.size(); }
+
+  // Number of connections leaving output port `port_index`.
+  size_t port_edge_count(size_t port_index) const {
+    return port_index + 1 < port_edge_offsets_.size()
+               ? port_edge_offsets_[port_index + 1] - port_edge_offsets_[port_index]
+               : 0;
+  }
+
+  // Detach connection `conn_index` from its child's input queue: emissions on
+  // it are pushed into `queue` (with debug ordering checks against `last_ts`)
+  // instead. The caller becomes responsible for delivering them to the child
+  // and scheduling it; the edge stays in connections_ so provenance (child,
+  // ports) remains readable. Used by PipelinedProgram to hand messages to
+  // another thread.
+  void reroute_connection(size_t conn_index, MessageQueue* queue, timestamp_t* last_ts) {
+    if (conn_index >= connections_.size()) {
+      throw std::runtime_error("Invalid connection index for reroute at " + type_name() + "(" + id_ + ")");
+    }
+    auto& conn = connections_[conn_index];
+    if (conn.sink_values) {
+      --value_conn_count_per_port_[conn.output_port];
+      conn.sink_values = nullptr;
+    }
+    conn.sink_queue = queue;
+    conn.sink_last_ts = last_ts;
+  }
+
   const std::vector<InboundRef>& inbound_data_refs(size_t port_index) const {
     static const std::vector<InboundRef> empty;
     if (port_index >= inbound_data_refs_.size()) return empty;
@@ -531,12 +806,125 @@ class Operator {
   }
 
  protected:
+  // Port layout only; backs the implicit copy constructors clone() uses.
+  Operator(const Operator& other) : id_(other.id_), queue_capacity_(other.queue_capacity_) {
+    data_ports_.reserve(other.data_ports_.size());
+    for (const auto& port : other.data_ports_) {
+      data_ports_.push_back({MessageQueue{}, port.type});
+      data_ports_.back().value_mode = port.value_mode;
+    }
+    control_ports_.reserve(other.control_ports_.size());
+    for (const auto& port : other.control_ports_) {
+      control_ports_.push_back({MessageQueue{}, port.type});
+    }
+    output_ports_ = other.output_ports_;
+    if (queue_capacity_ > 0) reserve_queues(queue_capacity_);
+  }
+  Operator& operator=(const Operator&) = delete;
+
   virtual void process_data(bool debug) = 0;
   virtual void process_control(bool debug=false) {};
 
+  // Port section of the binary snapshot: port counts, then each data and
+  // control queue. Overrides of write_state / read_state start with these.
+  void write_ports(ByteWriter& w) const {
+    w.write_size(data_ports_.size());
+    w.write_size(control_ports_.size());
+    w.write_size(output_ports_.size());
+    for (const auto& port : data_ports_) {
+      if (port.value_mode) {
+        StateSerializer::write_scalar_queue(w, port.values, port.type);
+      } else {
+        StateSerializer::write_message_queue(w, port.queue, port.type);
+      }
+    }
+    for (const auto& port : control_ports_) {
+      StateSerializer::write_message_queue(w, port.queue, port.type);
+    }
+  }
+
+  void read_ports(ByteReader& r) {
+    StateSerializer::validate_port_count(r.read_size(), data_ports_.size(), "Data");
+    StateSerializer::validate_port_count(r.read_size(), control_ports_.size(), "Control");
+    StateSerializer::validate_port_count(r.read_size(), output_ports_.size(), "Output");
+    for (auto& port : data_ports_) {
+      if (port.value_mode) {
+        StateSerializer::read_scalar_queue(r, port.values, port.type);
+      } else {
+        StateSerializer::read_message_queue(r, port.queue, port.type);
+      }
+    }
+    for (auto& port : control_ports_) {
+      StateSerializer::read_message_queue(r, port.queue, port.type);
+    }
+  }
+
+  // Length of the base port section at the front of collect_bytes(): three
+  // port counts, then per queue a message count and size-prefixed messages.
+  size_t legacy_port_bytes(const Bytes& bytes) const {
+    auto read_size_at = [&](size_t at) {
+      if (at + sizeof(size_t) > bytes.size()) throw std::runtime_error("Operator state truncated");
+      size_t v;
+      std::memcpy(&v, bytes.data() + at, sizeof(size_t));
+      return v;
+    };
+    size_t at = 3 * sizeof(size_t);
+    const size_t queues = data_ports_.size() + control_ports_.size();
+    for (size_t q = 0; q < queues; ++q) {
+      const size_t count = read_size_at(at);
+      at += sizeof(size_t);
+      for (size_t i = 0; i < count; ++i) at += sizeof(size_t) + read_size_at(at);
+    }
+    return at;
+  }
+
+  // Switch a NumberData / BooleanData data port to value mode: upstream
+  // emissions land in get_value_queue(port_index) as (time, value) records
+  // instead of Message objects in get_data_queue(port_index). Operators opt in
+  // from their constructor — connect() caches the sink representation, so
+  // this must run before the port is wired. Producers that still emit
+  // BaseMessage (and receive_data) are adapted transparently.
+  void enable_value_queue(size_t port_index) {
+    if (port_index >= data_ports_.size()) {
+      throw std::runtime_error("Invalid data port index for value queue");
+    }
+    if (!is_scalar_type(data_ports_[port_index].type)) {
+      throw std::runtime_error("Value queue requires a number or boolean port at " + type_name() + "(" + id_ +
+                               "):" + std::to_string(port_index));
+    }
+    if (port_index < inbound_data_refs_.size() && !inbound_data_refs_[port_index].empty()) {
+      throw std::runtime_error("Value queue must be enabled before connecting " + type_name() + "(" + id_ +
+                               "):" + std::to_string(port_index));
+    }
+    data_ports_[port_index].value_mode = true;
+  }
+
+  // Port-representation-agnostic accessors for code (sync, joins) that only
+  // needs timestamps and must work for both message and value-mode ports.
+  bool data_port_empty(size_t port_index) const {
+    const auto& port = data_ports_[port_index];
+    return port.value_mode ? port.values.empty() : port.queue.empty();
+  }
+
+  timestamp_t data_port_front_time(size_t port_index) const {
+    const auto& port = data_ports_[port_index];
+    return port.value_mode ? port.values.front().time : port.queue.front()->time;
+  }
+
+  void data_port_pop_front(size_t port_index) {
+    auto& port = data_ports_[port_index];
+    if (port.value_mode) {
+      port.values.pop_front();
+    } else {
+      port.queue.pop_front();
+    }
+  }
+
   // Push a message out of the given output port. Delivers directly to
   // connected children's input/control queues. Also copies to debug queues
-  // when debug mode is active.
+  // when debug mode is active. Children whose port is in value mode receive
+  // the scalar payload as a record; the message itself is only cloned for
+  // message-queue children.
   void emit_output(size_t port_index, std::unique_ptr<BaseMessage> msg, bool debug = false) {
     if (debug) {
       debug_output_queues_[port_index].push_back(msg->clone());
@@ -545,18 +933,28 @@ class Operator {
 #ifdef RTBOT_INSTRUMENTATION
     RTBOT_RECORD_OPERATOR_OUTPUT(id_, type_name(), port_index, msg->clone());
 #endif
+    if (profile_) ++profile_->messages_out;
 
-    // Cached count of connections on this port (maintained by connect()).
-    size_t remaining = (port_index < conn_count_per_port_.size())
-                           ? conn_count_per_port_[port_index]
-                           : 0;
-
-    if (remaining == 0) return;
+    const size_t total = port_edge_count(port_index);
+    if (total == 0) return;
 
     propagated_mask_ |= (uint64_t{1} << port_index);
 
-    for (auto& conn : connections_) {
-      if (conn.output_port != port_index) continue;
+    // Only message-queue children consume the unique_ptr; the last of them
+    // takes ownership instead of a clone, so the record for value-mode
+    // children is extracted up front.
+    const size_t value_conns = value_conn_count_per_port_[port_index];
+    size_t remaining = total - value_conns;
+    const ScalarRecord rec = value_conns > 0 ? ScalarRecord{msg->time, scalar_value(*msg)} : ScalarRecord{};
+
+    const uint32_t* edges = port_edges_.data() + port_edge_offsets_[port_index];
+    for (size_t e = 0; e < total; ++e) {
+      auto& conn = connections_[edges[e]];
+      if (conn.sink_values) {
+        if (debug) check_and_advance_sink_ts(conn, rec.time);
+        conn.sink_values->push_back(rec);
+        continue;
+      }
       --remaining;
 
       std::unique_ptr<BaseMessage> msg_to_send;
@@ -573,21 +971,13 @@ class Operator {
       } else {
         RTBOT_PERF_SCOPE(EMIT_CLONE);
         msg_to_send = msg->clone();
+        if (profile_) ++profile_->clones;
       }
 #endif
 
       {
         RTBOT_PERF_SCOPE(EMIT_DISPATCH);
-        if (debug) {
-          if (msg_to_send->time <= *conn.sink_last_ts) {
-            throw std::runtime_error(
-                "Message time out of order on port " +
-                std::to_string(conn.child_input_port) +
-                ". Current time: " + std::to_string(msg_to_send->time) +
-                ", Last timestamp: " + std::to_string(*conn.sink_last_ts));
-          }
-          *conn.sink_last_ts = msg_to_send->time;
-        }
+        if (debug) check_and_advance_sink_ts(conn, msg_to_send->time);
         conn.sink_queue->push_back(std::move(msg_to_send));
       }
     }
@@ -613,19 +1003,34 @@ class Operator {
       RTBOT_RECORD_OPERATOR_OUTPUT(id_, type_name(), port_index, m->clone());
     }
 #endif
+    if (profile_) profile_->messages_out += msgs.size();
 
-    size_t total_conns = (port_index < conn_count_per_port_.size())
-                             ? conn_count_per_port_[port_index]
-                             : 0;
+    const size_t total_conns = port_edge_count(port_index);
     if (total_conns == 0) return;
 
     propagated_mask_ |= (uint64_t{1} << port_index);
 
+    const size_t value_conns = value_conn_count_per_port_[port_index];
+    const size_t queue_conns = total_conns - value_conns;
+    std::vector<ScalarRecord> recs;
+    if (value_conns > 0) {
+      recs.reserve(msgs.size());
+      for (const auto& m : msgs) recs.push_back({m->time, scalar_value(*m)});
+    }
     size_t seen = 0;
-    for (auto& conn : connections_) {
-      if (conn.output_port != port_index) continue;
+    const uint32_t* edges = port_edges_.data() + port_edge_offsets_[port_index];
+    for (size_t e = 0; e < total_conns; ++e) {
+      auto& conn = connections_[edges[e]];
+
+      if (conn.sink_values) {
+        for (const auto& r : recs) {
+          if (debug) check_and_advance_sink_ts(conn, r.time);
+          conn.sink_values->push_back(r);
+        }
+        continue;
+      }
       ++seen;
-      const bool can_move = (seen == total_conns) && !debug;
+      const bool can_move = (seen == queue_conns) && !debug;
 
       for (size_t i = 0; i < msgs.size(); ++i) {
         std::unique_ptr<BaseMessage> msg_to_send;
@@ -642,40 +1047,125 @@ class Operator {
         } else {
           RTBOT_PERF_SCOPE(EMIT_CLONE);
           msg_to_send = msgs[i]->clone();
+          if (profile_) ++profile_->clones;
         }
 #endif
-        if (debug) {
-          if (msg_to_send->time <= *conn.sink_last_ts) {
-            throw std::runtime_error(
-                "Message time out of order on port " +
-                std::to_string(conn.child_input_port) +
-                ". Current time: " + std::to_string(msg_to_send->time) +
-                ", Last timestamp: " + std::to_string(*conn.sink_last_ts));
-          }
-          *conn.sink_last_ts = msg_to_send->time;
-        }
+        if (debug) check_and_advance_sink_ts(conn, msg_to_send->time);
         conn.sink_queue->push_back(std::move(msg_to_send));
       }
     }
   }
 
+  // Columnar overload: forward a whole MessageBatch out of `port_index`.
+  // Value-mode children append the columns as records in one loop per edge;
+  // message-queue children (and the debug queue) get one Message per row.
+  template <typename T>
+  void emit_output(size_t port_index, const MessageBatch<T>& batch, bool debug = false) {
+    if (batch.empty()) return;
+    const std::type_index& type = output_ports_[port_index].type;
+    const size_t n = batch.size();
+
+    if (debug) {
+      for (size_t i = 0; i < n; ++i) {
+        debug_output_queues_[port_index].push_back(make_scalar_message(type, batch.times[i], batch.values[i]));
+      }
+    }
+
+#ifdef RTBOT_INSTRUMENTATION
+    for (size_t i = 0; i < n; ++i) {
+      RTBOT_RECORD_OPERATOR_OUTPUT(id_, type_name(), port_index,
+                                   make_scalar_message(type, batch.times[i], batch.values[i]));
+    }
+#endif
+    if (profile_) profile_->messages_out += n;
+
+    const size_t total = port_edge_count(port_index);
+    if (total == 0) return;
+
+    propagated_mask_ |= (uint64_t{1} << port_index);
+
+    const uint32_t* edges = port_edges_.data() + port_edge_offsets_[port_index];
+    for (size_t e = 0; e < total; ++e) {
+      auto& conn = connections_[edges[e]];
+      if (debug) {
+        for (timestamp_t time : batch.times) check_and_advance_sink_ts(conn, time);
+      }
+      if (conn.sink_values) {
+        ScalarQueue& sink = *conn.sink_values;
+        sink.reserve(sink.size() + n);
+        for (size_t i = 0; i < n; ++i) sink.push_back({batch.times[i], batch.values[i]});
+        continue;
+      }
+      for (size_t i = 0; i < n; ++i) {
+#if defined(RTBOT_INSTRUMENTATION)
+        RTBOT_RECORD_MESSAGE_SENT(id_, type_name(), std::to_string(port_index),
+                                  conn.child->id(), conn.child->type_name(),
+                                  std::to_string(conn.child_input_port),
+                                  conn.child_port_kind == PortKind::DATA ? "" : "[c]",
+                                  make_scalar_message(type, batch.times[i], batch.values[i]));
+#endif
+        conn.sink_queue->push_back(make_scalar_message(type, batch.times[i], batch.values[i]));
+      }
+    }
+  }
+
+  // Value-typed emission for NumberData / BooleanData output ports. Value-mode
+  // children get a record with no allocation and no virtual call; a Message is
+  // materialized only for children that still read BaseMessage queues (and
+  // for the debug queue).
+  void emit_value(size_t port_index, timestamp_t time, double value, bool debug = false) {
+    const std::type_index& type = output_ports_[port_index].type;
+    if (debug) {
+      debug_output_queues_[port_index].push_back(make_scalar_message(type, time, value));
+    }
+
+#ifdef RTBOT_INSTRUMENTATION
+    RTBOT_RECORD_OPERATOR_OUTPUT(id_, type_name(), port_index, make_scalar_message(type, time, value));
+#endif
+    if (profile_) ++profile_->messages_out;
+
+    const size_t total = port_edge_count(port_index);
+    if (total == 0) return;
+
+    propagated_mask_ |= (uint64_t{1} << port_index);
+
+    const uint32_t* edges = port_edges_.data() + port_edge_offsets_[port_index];
+    for (size_t e = 0; e < total; ++e) {
+      auto& conn = connections_[edges[e]];
+      if (debug) check_and_advance_sink_ts(conn, time);
+      if (conn.sink_values) {
+        conn.sink_values->push_back({time, value});
+      } else {
+#if defined(RTBOT_INSTRUMENTATION)
+        RTBOT_RECORD_MESSAGE_SENT(id_, type_name(), std::to_string(port_index),
+                                  conn.child->id(), conn.child->type_name(),
+                                  std::to_string(conn.child_input_port),
+                                  conn.child_port_kind == PortKind::DATA ? "" : "[c]",
+                                  make_scalar_message(type, time, value));
+#endif
+        conn.sink_queue->push_back(make_scalar_message(type, time, value));
+      }
+    }
+  }
+
   bool sync_data_inputs() {
 
     if (data_ports_.empty()) return false;
 
+    const size_t n = data_ports_.size();
     while (true) {
       // If any queue is empty, sync not possible
-      for (auto& port : data_ports_) {
-        if (port.queue.empty())
+      for (size_t i = 0; i < n; ++i) {
+        if (data_port_empty(i))
           return false;
       }
 
       // Find min and max front timestamps
-      timestamp_t min_time = data_ports_.front().queue.front()->time;
+      timestamp_t min_time = data_port_front_time(0);
       timestamp_t max_time = min_time;
 
-      for (auto& port : data_ports_) {
-        timestamp_t t = port.queue.front()->time;
+      for (size_t i = 1; i < n; ++i) {
+        timestamp_t t = data_port_front_time(i);
         if (t < min_time) min_time = t;
         if (t > max_time) max_time = t;
       }
@@ -685,14 +1175,14 @@ class Operator {
         return true;
 
       // Pop all queues that have the oldest front timestamp
-      for (auto& port : data_ports_) {
-        if (!port.queue.empty() && port.queue.front()->time == min_time)
-          port.queue.pop_front();
+      for (size_t i = 0; i < n; ++i) {
+        if (!data_port_empty(i) && data_port_front_time(i) == min_time)
+          data_port_pop_front(i);
       }
 
       // If any queue now empty → cannot sync
-      for (auto& port : data_ports_) {
-        if (port.queue.empty())
+      for (size_t i = 0; i < n; ++i) {
+        if (data_port_empty(i))
           return false;
       }
     }
@@ -744,6 +1234,7 @@ class Operator {
   std::vector<PortInfo> control_ports_;
   std::vector<OutputPortInfo> output_ports_;
   std::deque<MessageQueue> debug_output_queues_;
+  size_t queue_capacity_{0};
   std::vector<Connection> connections_;
   // Reverse index: input port → list of inbound connections feeding it.
   // Stored as (parent_op*, conn_index) so upstream's connections_ vector can
@@ -751,10 +1242,34 @@ class Operator {
   // connect() on the child side.
   std::vector<std::vector<InboundRef>> inbound_data_refs_;
   std::vector<std::vector<InboundRef>> inbound_control_refs_;
-  // Cached count of connections per output port, maintained by connect().
-  // Lets emit_output skip the count-pass loop.
-  std::vector<uint16_t> conn_count_per_port_;
+  // Outgoing edges grouped by output port (CSR): the connections_ indices
+  // leaving port p are port_edges_[port_edge_offsets_[p] ..
+  // port_edge_offsets_[p + 1]), in connect() order. Maintained by connect();
+  // emission walks only its port's slice instead of every connection.
+  std::vector<uint32_t> port_edge_offsets_;
+  std::vector<uint32_t> port_edges_;
+  // Number of edges per output port whose child port is in value mode.
+  std::vector<uint16_t> value_conn_count_per_port_;
   uint64_t propagated_mask_{0};
+  // Runtime counters; null unless enable_profiling(true).
+  std::unique_ptr<OperatorProfile> profile_;
+  // Checkpoint tracking, see mark_checkpoint(). A new operator is dirty so
+  // the first checkpoint after it appears includes it.
+  bool state_dirty_{true};
+  uint64_t modified_epoch_{0};
+  uint64_t checkpoint_epoch_{0};
+
+ private:
+  static void check_and_advance_sink_ts(Connection& conn, timestamp_t time) {
+    if (time <= *conn.sink_last_ts) {
+      throw std::runtime_error(
+          "Message time out of order on port " +
+          std::to_string(conn.child_input_port) +
+          ". Current time: " + std::to_string(time) +
+          ", Last timestamp: " + std::to_string(*conn.sink_last_ts));
+    }
+    *conn.sink_last_ts = time;
+  }
 };
 
 }  // namespace rtbot
@@ -0,0 +1,49 @@
+#ifndef RTBOT_OPERATOR_PROFILE_H
+#define RTBOT_OPERATOR_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "rtbot/LatencyHistogram.h"
+
+namespace rtbot {
+
+// Runtime per-operator counters, switched on per operator with
+// Operator::enable_profiling() (Program does it for the whole graph).
+//
+// Unlike PerfCounters, which is compiled in with -DRTBOT_PERF and aggregates
+// per phase across the thread, these are always built and attributed to one
+// operator. A disabled operator holds a null profile, so the hot path pays a
+// single pointer test per execute / emit.
+struct OperatorProfile {
+  // Messages (or value records) that arrived on data and control ports.
+  uint64_t messages_in{0};
+  // Messages emitted on output ports, counted once per emission regardless
+  // of fan-out.
+  uint64_t messages_out{0};
+  // execute_local() calls and the wall time spent in process_control /
+  // process_data, in nanoseconds.
+  uint64_t executions{0};
+  uint64_t process_ns{0};
+  // Messages cloned to fan out to more than one message-queue child.
+  uint64_t clones{0};
+  // Most input messages queued at once when the operator ran.
+  uint64_t queue_high_water{0};
+  // Input messages left queued by the previous run; new arrivals are the
+  // growth over this.
+  size_t backlog{0};
+  // Distribution of the per-execute process time; only allocated when
+  // profiling was enabled with latency histograms.
+  std::unique_ptr<LatencyHistogram> execute_latency;
+
+  void reset() {
+    messages_in = messages_out = executions = process_ns = clones = queue_high_water = 0;
+    backlog = 0;
+    if (execute_latency) execute_latency->reset();
+  }
+};
+
+}  // namespace rtbot
+
+#endif  // RTBOT_OPERATOR_PROFILE_H
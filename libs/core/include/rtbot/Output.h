@@ -27,6 +27,9 @@ class Output : public Operator {
 
       // Add input port and matching output port
       PortType::add_port(*this, type, true, false ,true);  // input port
+      if (type == PortType::NUMBER || type == PortType::BOOLEAN) {
+        enable_value_queue(num_data_ports() - 1);
+      }
     }
   }
 
@@ -50,6 +53,15 @@ class Output : public Operator {
  protected:
   void process_data(bool debug=false) override {
     for (size_t i = 0; i < num_data_ports(); ++i) {
+      if (is_value_port(i)) {
+        auto& values = get_value_queue(i);
+        while (!values.empty()) {
+          const ScalarRecord rec = values.front();
+          values.pop_front();
+          emit_value(i, rec.time, rec.value, debug);
+        }
+        continue;
+      }
       auto& input_queue = get_data_queue(i);
       if (input_queue.empty()) continue;
       if (input_queue.size() >= kEmitBatchThreshold) {
@@ -32,6 +32,7 @@ enum class PerfPhase : int {
   QUEUE_POP,
   MSG_ALLOC_POOL_HIT,
   MSG_ALLOC_POOL_MISS,
+  MSG_ALLOC_ARENA,
   _COUNT
 };
 
@@ -45,6 +46,7 @@ inline const char* perf_phase_name(PerfPhase p) {
     case PerfPhase::QUEUE_POP: return "QUEUE_POP";
     case PerfPhase::MSG_ALLOC_POOL_HIT: return "MSG_ALLOC_POOL_HIT";
     case PerfPhase::MSG_ALLOC_POOL_MISS: return "MSG_ALLOC_POOL_MISS";
+    case PerfPhase::MSG_ALLOC_ARENA: return "MSG_ALLOC_ARENA";
     default: return "?";
   }
 }
@@ -231,6 +231,28 @@ class Pipeline : public Operator {
     }
   }
 
+  void write_state(ByteWriter& w) override {
+    Operator::write_state(w);
+    w.write_size(operators_.size());
+    for (const auto& [op_id, op] : operators_) {
+      w.write_string(op_id);
+      op->write_state(w);
+    }
+  }
+
+  void read_state(ByteReader& r) override {
+    Operator::read_state(r);
+    const size_t count = r.read_size();
+    for (size_t i = 0; i < count; ++i) {
+      const std::string op_id = r.read_string();
+      auto it = operators_.find(op_id);
+      if (it == operators_.end()) {
+        throw std::runtime_error("Pipeline " + id() + ": snapshot has unknown operator " + op_id);
+      }
+      it->second->read_state(r);
+    }
+  }
+
   std::string type_name() const override { return "Pipeline"; }
 
   bool equals(const Pipeline& other) const {
@@ -365,7 +387,7 @@ class Pipeline : public Operator {
 
       // Evaluate segment bytecode on the first data port's vector to get segment key
       const auto* vec_msg = static_cast<const Message<VectorNumberData>*>(get_data_queue(0).front().get());
-      const auto& vec = *vec_msg->data.values;
+      const auto& vec = vec_msg->data;
       double new_key = evaluate_segment_bytecode(vec);
       timestamp_t boundary_time = vec_msg->time;
 
@@ -444,7 +466,7 @@ class Pipeline : public Operator {
   // current vector. Segment keys are compared with exact floating-point
   // equality, so expressions should produce integer-valued results
   // (e.g., via FLOOR, comparisons producing 1.0/0.0).
-  double evaluate_segment_bytecode(const std::vector<double>& vec) const {
+  double evaluate_segment_bytecode(const VectorNumberData& vec) const {
     const double* bc = segment_bytecode_.data();
     const size_t bc_size = segment_bytecode_.size();
     const double* consts = segment_constants_.data();
@@ -620,7 +642,7 @@ class Pipeline : public Operator {
     for (const auto& entry : output_mapping_cache_) {
       auto& source_queue = entry.collector->get_data_queue(0);
       if (!source_queue.empty()) {
-        last_output_buffer_[entry.pipeline_port] = source_queue.back()->clone();
+        last_output_buffer_[entry.pipeline_port] = retain_message(*source_queue.back());
       }
     }
   }
@@ -18,6 +18,7 @@ class ReduceJoin : public Join {
     if (num_ports < 2) {
       throw std::runtime_error("ReduceJoin requires at least 2 input ports");
     }
+    enable_value_queues();
   }
 
   // Constructor with initial value - single output
@@ -29,6 +30,7 @@ class ReduceJoin : public Join {
     if (num_ports < 2) {
       throw std::runtime_error("ReduceJoin requires at least 2 input ports");
     }
+    enable_value_queues();
   }
 
   virtual ~ReduceJoin() noexcept = default;
@@ -51,7 +53,7 @@ class ReduceJoin : public Join {
         is_any_empty = false;
         is_sync = sync_data_inputs();
         for (int i=0; i < num_data_ports(); i++) {
-          if (get_data_queue(i).empty()) {
+          if (data_port_empty(i)) {
             is_any_empty = true;
             break;
           }
@@ -60,44 +62,85 @@ class ReduceJoin : public Join {
 
       if (!is_sync) return;
 
-      std::vector<const Message<T>*> typed_messages;
-      timestamp_t time = 0;
-      // Process each synchronized set of messages
-      for (int i=0; i < num_data_ports(); i++) {
-        typed_messages.reserve(num_data_ports());
-        const auto* typed_msg = static_cast<const Message<T>*>(get_data_queue(i).front().get());
-        if (!typed_msg) {
-          throw std::runtime_error("Invalid message type in ReduceJoin");
+      if constexpr (kScalar) {
+        // Value-mode ports: fold straight over the front records.
+        timestamp_t time = get_value_queue(0).front().time;
+        std::optional<T> result;
+        size_t first = 0;
+        if (initial_value_.has_value()) {
+          result = initial_value_;
+        } else {
+          result = from_scalar(get_value_queue(0).front().value);
+          first = 1;
         }
-        typed_messages.push_back(typed_msg);
-        time = typed_msg->time;        
-      }
+        for (size_t i = first; i < num_data_ports() && result.has_value(); ++i) {
+          result = combine(*result, from_scalar(get_value_queue(i).front().value));
+        }
+
+        for (size_t i = 0; i < num_data_ports(); i++)
+          get_value_queue(i).pop_front();
 
-      std::optional<T> result;
-      if (initial_value_.has_value()) {
-        result = initial_value_;
-        for (const auto* msg : typed_messages) {
-          result = combine(*result, msg->data);
-          if (!result.has_value()) break;
+        if (result.has_value()) {
+          emit_value(0, time, static_cast<double>(result->value), debug);
         }
       } else {
-        result = typed_messages[0]->data;
-        for (size_t i = 1; i < typed_messages.size(); ++i) {
-          result = combine(*result, typed_messages[i]->data);
-          if (!result.has_value()) break;
+        std::vector<const Message<T>*> typed_messages;
+        timestamp_t time = 0;
+        // Process each synchronized set of messages
+        for (int i=0; i < num_data_ports(); i++) {
+          typed_messages.reserve(num_data_ports());
+          const auto* typed_msg = static_cast<const Message<T>*>(get_data_queue(i).front().get());
+          if (!typed_msg) {
+            throw std::runtime_error("Invalid message type in ReduceJoin");
+          }
+          typed_messages.push_back(typed_msg);
+          time = typed_msg->time;        
+        }
+
+        std::optional<T> result;
+        if (initial_value_.has_value()) {
+          result = initial_value_;
+          for (const auto* msg : typed_messages) {
+            result = combine(*result, msg->data);
+            if (!result.has_value()) break;
+          }
+        } else {
+          result = typed_messages[0]->data;
+          for (size_t i = 1; i < typed_messages.size(); ++i) {
+            result = combine(*result, typed_messages[i]->data);
+            if (!result.has_value()) break;
+          }
         }
-      }
 
-      for (int i = 0; i < num_data_ports(); i++)
-        get_data_queue(i).pop_front();
+        for (int i = 0; i < num_data_ports(); i++)
+          get_data_queue(i).pop_front();
 
-      if (result.has_value()) {
-        emit_output(0, create_message<T>(time, *result), debug);
+        if (result.has_value()) {
+          emit_output(0, create_message<T>(time, *result), debug);
+        }
       }
     }
   }
 
  private:
+  static constexpr bool kScalar = std::is_same_v<T, NumberData> || std::is_same_v<T, BooleanData>;
+
+  static T from_scalar(double value) {
+    if constexpr (std::is_same_v<T, BooleanData>) {
+      return T{value != 0.0};
+    } else {
+      return T{value};
+    }
+  }
+
+  // Scalar reductions (arithmetic, boolean, filter syncs) read their inputs
+  // as value records; vector reductions keep the message queues.
+  void enable_value_queues() {
+    if constexpr (kScalar) {
+      for (size_t i = 0; i < num_data_ports(); ++i) enable_value_queue(i);
+    }
+  }
+
   std::optional<T> initial_value_;
 };
 
@@ -0,0 +1,175 @@
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace rtbot {
+
+// Growable FIFO over a single power-of-two slot array. Unlike std::deque it
+// never frees storage as it drains: once a port queue has seen a burst of N
+// elements it keeps capacity for N, so steady-state push/pop never touches the
+// allocator. Indexing is `slots_[(head_ + i) & mask]`.
+//
+// Only the subset of the std::deque interface rtbot actually uses is provided
+// (push/pop at the ends, front/back, operator[], forward iteration, clear).
+template <typename T>
+class RingQueue {
+ public:
+  RingQueue() = default;
+  explicit RingQueue(size_t capacity) { reserve(capacity); }
+
+  RingQueue(const RingQueue&) = delete;
+  RingQueue& operator=(const RingQueue&) = delete;
+
+  RingQueue(RingQueue&& other) noexcept
+      : slots_(std::move(other.slots_)), capacity_(other.capacity_), head_(other.head_), size_(other.size_) {
+    other.capacity_ = 0;
+    other.head_ = 0;
+    other.size_ = 0;
+  }
+
+  RingQueue& operator=(RingQueue&& other) noexcept {
+    if (this != &other) {
+      slots_ = std::move(other.slots_);
+      capacity_ = other.capacity_;
+      head_ = other.head_;
+      size_ = other.size_;
+      other.capacity_ = 0;
+      other.head_ = 0;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_t size() const noexcept { return size_; }
+  size_t capacity() const noexcept { return capacity_; }
+
+  T& front() { return slots_[head_]; }
+  const T& front() const { return slots_[head_]; }
+  T& back() { return slots_[(head_ + size_ - 1) & (capacity_ - 1)]; }
+  const T& back() const { return slots_[(head_ + size_ - 1) & (capacity_ - 1)]; }
+
+  T& operator[](size_t i) { return slots_[(head_ + i) & (capacity_ - 1)]; }
+  const T& operator[](size_t i) const { return slots_[(head_ + i) & (capacity_ - 1)]; }
+
+  T& at(size_t i) {
+    if (i >= size_) throw std::out_of_range("RingQueue index out of range");
+    return (*this)[i];
+  }
+  const T& at(size_t i) const {
+    if (i >= size_) throw std::out_of_range("RingQueue index out of range");
+    return (*this)[i];
+  }
+
+  void push_back(T value) {
+    if (size_ == capacity_) grow(size_ + 1);
+    slots_[(head_ + size_) & (capacity_ - 1)] = std::move(value);
+    ++size_;
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (size_ == capacity_) grow(size_ + 1);
+    T& slot = slots_[(head_ + size_) & (capacity_ - 1)];
+    slot = T(std::forward<Args>(args)...);
+    ++size_;
+    return slot;
+  }
+
+  // Popped slots are reset to T{} so owning element types (unique_ptr)
+  // release their payload immediately rather than when the slot is reused.
+  void pop_front() {
+    slots_[head_] = T{};
+    head_ = (head_ + 1) & (capacity_ - 1);
+    --size_;
+  }
+
+  void pop_back() {
+    --size_;
+    slots_[(head_ + size_) & (capacity_ - 1)] = T{};
+  }
+
+  void clear() {
+    for (size_t i = 0; i < size_; ++i) {
+      slots_[(head_ + i) & (capacity_ - 1)] = T{};
+    }
+    head_ = 0;
+    size_ = 0;
+  }
+
+  // Grow capacity to at least `n` (rounded up to a power of two). Never
+  // shrinks; a no-op when capacity is already sufficient.
+  void reserve(size_t n) {
+    if (n > capacity_) grow(n);
+  }
+
+  template <bool Const>
+  class basic_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+    using owner_type = std::conditional_t<Const, const RingQueue*, RingQueue*>;
+
+    basic_iterator(owner_type q, size_t i) : q_(q), i_(i) {}
+    reference operator*() const { return (*q_)[i_]; }
+    pointer operator->() const { return &(*q_)[i_]; }
+    basic_iterator& operator++() {
+      ++i_;
+      return *this;
+    }
+    basic_iterator operator++(int) {
+      basic_iterator tmp = *this;
+      ++i_;
+      return tmp;
+    }
+    bool operator==(const basic_iterator& o) const { return i_ == o.i_ && q_ == o.q_; }
+    bool operator!=(const basic_iterator& o) const { return !(*this == o); }
+
+   private:
+    owner_type q_;
+    size_t i_;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, size_); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size_); }
+
+ private:
+  static size_t round_up_pow2(size_t n) {
+    size_t cap = 8;
+    while (cap < n) cap <<= 1;
+    return cap;
+  }
+
+  void grow(size_t min_capacity) {
+    size_t new_capacity = round_up_pow2(min_capacity);
+    std::unique_ptr<T[]> fresh(new T[new_capacity]);
+    for (size_t i = 0; i < size_; ++i) {
+      fresh[i] = std::move(slots_[(head_ + i) & (capacity_ - 1)]);
+    }
+    slots_ = std::move(fresh);
+    capacity_ = new_capacity;
+    head_ = 0;
+  }
+
+  std::unique_ptr<T[]> slots_;
+  size_t capacity_{0};
+  size_t head_{0};
+  size_t size_{0};
+};
+
+}  // namespace rtbot
+
+#endif  // RING_QUEUE_H
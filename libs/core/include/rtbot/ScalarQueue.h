@@ -0,0 +1,53 @@
+#ifndef SCALAR_QUEUE_H
+#define SCALAR_QUEUE_H
+
+#include <memory>
+#include <stdexcept>
+#include <typeindex>
+
+#include "rtbot/Message.h"
+#include "rtbot/RingQueue.h"
+
+namespace rtbot {
+
+// Value-typed queue entry for NumberData / BooleanData ports. BooleanData is
+// carried as 0.0 / 1.0 so one record layout serves both scalar port types.
+struct ScalarRecord {
+  timestamp_t time{0};
+  double value{0.0};
+};
+
+// Contiguous ring of (timestamp, value) records. A port in value mode (see
+// Operator::enable_value_queue) is fed through this queue instead of the
+// MessageQueue, so a scalar hop costs a 16-byte store rather than a pooled
+// Message<T> allocation plus a virtual clone().
+using ScalarQueue = RingQueue<ScalarRecord>;
+
+inline bool is_scalar_type(const std::type_index& type) {
+  return type == std::type_index(typeid(NumberData)) || type == std::type_index(typeid(BooleanData));
+}
+
+// Adapter: read the scalar payload of a Message<NumberData> / Message<BooleanData>.
+inline double scalar_value(const BaseMessage& msg) {
+  if (msg.type() == std::type_index(typeid(NumberData))) {
+    return static_cast<const Message<NumberData>&>(msg).data.value;
+  }
+  if (msg.type() == std::type_index(typeid(BooleanData))) {
+    return static_cast<const Message<BooleanData>&>(msg).data.value ? 1.0 : 0.0;
+  }
+  throw std::runtime_error("scalar_value: message is not NumberData or BooleanData");
+}
+
+// Adapter: materialize a record as a Message of the given scalar port type,
+// for consumers that still read BaseMessage queues.
+inline std::unique_ptr<BaseMessage> make_scalar_message(const std::type_index& type, timestamp_t time,
+                                                        double value) {
+  if (type == std::type_index(typeid(BooleanData))) {
+    return create_message<BooleanData>(time, BooleanData{value != 0.0});
+  }
+  return create_message<NumberData>(time, NumberData{value});
+}
+
+}  // namespace rtbot
+
+#endif  // SCALAR_QUEUE_H
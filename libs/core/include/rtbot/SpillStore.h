@@ -0,0 +1,181 @@
+#ifndef SPILL_STORE_H
+#define SPILL_STORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define RTBOT_SPILL_MMAP 1
+#endif
+
+namespace rtbot {
+
+// Append-only store of byte records for state that has gone cold
+// (KeyedPipeline's spilled sub-graphs).
+//
+// Records live in one contiguous region: a memory-mapped scratch file when a
+// directory is given, an in-process buffer otherwise. Each record is
+// addressed by a stable handle. Erasing a record only counts its bytes as
+// garbage; once garbage outweighs the live bytes the region is compacted in
+// place, so the file stays within about twice the live data.
+//
+// The file gets a unique name in the directory and is unlinked as soon as it
+// is open, so stores can share a directory and nothing is left behind when
+// the process exits. It is scratch space, not a durable snapshot.
+// Memory-mapped files need POSIX; elsewhere only the in-process buffer is
+// available.
+class SpillStore {
+ public:
+  using Handle = uint32_t;
+  static constexpr Handle npos = std::numeric_limits<Handle>::max();
+
+  explicit SpillStore(std::string dir = "") : dir_(std::move(dir)) {
+    if (dir_.empty()) return;
+#ifdef RTBOT_SPILL_MMAP
+    std::string name = dir_ + "/rtbot-spill-XXXXXX";
+    fd_ = ::mkstemp(&name[0]);
+    if (fd_ < 0) throw std::runtime_error("SpillStore: cannot create a spill file in " + dir_);
+    ::unlink(name.c_str());
+#else
+    throw std::runtime_error("SpillStore: spill files are not supported on this platform");
+#endif
+  }
+
+  SpillStore(const SpillStore&) = delete;
+  SpillStore& operator=(const SpillStore&) = delete;
+
+  ~SpillStore() {
+#ifdef RTBOT_SPILL_MMAP
+    if (fd_ >= 0) {
+      if (base_) ::munmap(base_, capacity_);
+      ::close(fd_);
+    }
+#endif
+  }
+
+  const std::string& dir() const { return dir_; }
+  bool file_backed() const { return fd_ >= 0; }
+  size_t size() const { return records_.size() - free_.size(); }
+  size_t live_bytes() const { return live_; }
+  size_t mapped_bytes() const { return capacity_; }
+
+  Handle put(const uint8_t* data, size_t size) {
+    if (garbage_ > live_ && garbage_ >= kMinCompact) compact();
+    reserve(end_ + size);
+    if (size > 0) std::memcpy(base_ + end_, data, size);
+
+    Handle h;
+    if (!free_.empty()) {
+      h = free_.back();
+      free_.pop_back();
+    } else {
+      h = static_cast<Handle>(records_.size());
+      records_.emplace_back();
+    }
+    records_[h] = {end_, size, true};
+    end_ += size;
+    live_ += size;
+    return h;
+  }
+
+  // The record's bytes; valid until the next put().
+  std::pair<const uint8_t*, size_t> get(Handle h) const {
+    const Record& r = records_[h];
+    return {base_ + r.offset, r.size};
+  }
+
+  void erase(Handle h) {
+    Record& r = records_[h];
+    live_ -= r.size;
+    garbage_ += r.size;
+    r.live = false;
+    free_.push_back(h);
+  }
+
+  void clear() {
+    records_.clear();
+    free_.clear();
+    end_ = live_ = garbage_ = 0;
+  }
+
+ private:
+  struct Record {
+    size_t offset{0};
+    size_t size{0};
+    bool live{false};
+  };
+
+  static constexpr size_t kMinCompact = 1 << 20;
+  static constexpr size_t kMinCapacity = 1 << 16;
+
+  // Slides live records down over the garbage, in offset order.
+  void compact() {
+    std::vector<Handle> order;
+    order.reserve(size());
+    for (Handle h = 0; h < records_.size(); ++h) {
+      if (records_[h].live) order.push_back(h);
+    }
+    std::sort(order.begin(), order.end(),
+              [this](Handle a, Handle b) { return records_[a].offset < records_[b].offset; });
+    size_t at = 0;
+    for (Handle h : order) {
+      Record& r = records_[h];
+      if (r.offset != at && r.size > 0) std::memmove(base_ + at, base_ + r.offset, r.size);
+      r.offset = at;
+      at += r.size;
+    }
+    end_ = at;
+    garbage_ = 0;
+  }
+
+  void reserve(size_t needed) {
+    if (needed <= capacity_) return;
+    size_t capacity = std::max(capacity_ * 2, kMinCapacity);
+    while (capacity < needed) capacity *= 2;
+#ifdef RTBOT_SPILL_MMAP
+    if (fd_ >= 0) {
+      if (::ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+        throw std::runtime_error("SpillStore: cannot grow the spill file in " + dir_);
+      }
+      if (base_) ::munmap(base_, capacity_);
+      void* p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+      if (p == MAP_FAILED) {
+        base_ = nullptr;
+        capacity_ = 0;
+        throw std::runtime_error("SpillStore: cannot map the spill file in " + dir_);
+      }
+      base_ = static_cast<uint8_t*>(p);
+      capacity_ = capacity;
+      return;
+    }
+#endif
+    memory_.resize(capacity);
+    base_ = memory_.data();
+    capacity_ = capacity;
+  }
+
+  std::string dir_;
+  int fd_{-1};
+  std::vector<uint8_t> memory_;
+  uint8_t* base_{nullptr};
+  size_t capacity_{0};
+  size_t end_{0};
+  size_t live_{0};
+  size_t garbage_{0};
+  std::vector<Record> records_;
+  std::vector<Handle> free_;
+};
+
+}  // namespace rtbot
+
+#endif  // SPILL_STORE_H
@@ -3,7 +3,6 @@
 #define STATE_SERIALIZER_H
 
 #include <cstdint>
-#include <deque>
 #include <map>
 #include <memory>
 #include <set>
@@ -11,11 +10,14 @@
 #include <typeindex>
 #include <vector>
 
+#include "rtbot/ByteStream.h"
 #include "rtbot/Message.h"
+#include "rtbot/RingQueue.h"
+#include "rtbot/ScalarQueue.h"
 
 namespace rtbot {
 
-using MessageQueue = std::deque<std::unique_ptr<BaseMessage>>;
+using MessageQueue = RingQueue<std::unique_ptr<BaseMessage>>;
 
 class StateSerializer {
  public:
@@ -49,6 +51,11 @@ class StateSerializer {
   static void serialize_message_queue(Bytes& bytes, const MessageQueue& queue);
   static void deserialize_message_queue(Bytes::const_iterator& it, MessageQueue& queue);
 
+  // Value-mode port queues use the same wire layout as message queues, so a
+  // snapshot restores regardless of which representation either side uses.
+  static void serialize_scalar_queue(Bytes& bytes, const ScalarQueue& queue, const std::type_index& type);
+  static void deserialize_scalar_queue(Bytes::const_iterator& it, ScalarQueue& queue);
+
   static void serialize_index_set(Bytes& bytes, const std::set<size_t>& indices);
   static void deserialize_index_set(Bytes::const_iterator& it, std::set<size_t>& indices);
 
@@ -66,7 +73,45 @@ class StateSerializer {
   static void deserialize_port_timestamp_set_map(Bytes::const_iterator& it,
                                                  std::map<size_t, std::set<timestamp_t>>& port_map);
 
+  // Binary snapshot encoding (ByteWriter / ByteReader, see
+  // Operator::write_state). The message type is interned as a one-byte tag
+  // written once per queue instead of a mangled type name per message, and
+  // scalar queues go out as a column of times followed by a column of values.
+  enum TypeTag : uint8_t { TAG_NUMBER = 1, TAG_BOOLEAN = 2, TAG_VECTOR_NUMBER = 3, TAG_VECTOR_BOOLEAN = 4 };
+  static uint8_t type_tag(const std::type_index& type);
+
+  // Payload only (no tag, no time).
+  static void write_payload(ByteWriter& w, const BaseMessage& msg, uint8_t tag);
+  static std::unique_ptr<BaseMessage> read_payload(ByteReader& r, uint8_t tag, timestamp_t time);
+
+  // One self-describing message: tag, time, payload.
+  static void write_message(ByteWriter& w, const BaseMessage& msg);
+  static std::unique_ptr<BaseMessage> read_message(ByteReader& r);
+
+  // A run of messages of port type `type`: count, tag, then the columns (or
+  // time + payload per message for vector types). Works on any range of
+  // unique_ptr to messages, so Buffer windows share the queue encoding.
+  template <typename Range>
+  static void write_messages(ByteWriter& w, const Range& messages, const std::type_index& type);
+  // Reads a run written by write_messages / write_scalar_queue, checking the
+  // tag against `type`, and hands each message to `sink`.
+  template <typename Sink>
+  static void read_messages(ByteReader& r, const std::type_index& type, Sink&& sink);
+
+  static void write_message_queue(ByteWriter& w, const MessageQueue& queue, const std::type_index& type) {
+    write_messages(w, queue, type);
+  }
+  static void read_message_queue(ByteReader& r, MessageQueue& queue, const std::type_index& type);
+  static void write_scalar_queue(ByteWriter& w, const ScalarQueue& queue, const std::type_index& type);
+  static void read_scalar_queue(ByteReader& r, ScalarQueue& queue, const std::type_index& type);
+
  private:
+  template <typename Row>
+  static void read_scalar_columns(ByteReader& r, size_t count, uint8_t tag, Row&& row);
+  static void check_tag(uint8_t stored, uint8_t expected);
+  // Ranges of Message<T> (Buffer windows) cast through the base type.
+  static const BaseMessage& as_base(const BaseMessage& msg) { return msg; }
+
   // Private constructor to prevent instantiation
   StateSerializer() = default;
 };
@@ -296,6 +341,32 @@ inline void StateSerializer::deserialize_message_queue(Bytes::const_iterator& it
   }
 }
 
+inline void StateSerializer::serialize_scalar_queue(Bytes& bytes, const ScalarQueue& queue,
+                                                    const std::type_index& type) {
+  size_t queue_size = queue.size();
+  bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&queue_size),
+               reinterpret_cast<const uint8_t*>(&queue_size) + sizeof(queue_size));
+
+  for (const auto& rec : queue) {
+    Bytes msg_bytes = make_scalar_message(type, rec.time, rec.value)->serialize();
+    size_t msg_size = msg_bytes.size();
+
+    bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&msg_size),
+                 reinterpret_cast<const uint8_t*>(&msg_size) + sizeof(msg_size));
+    bytes.insert(bytes.end(), msg_bytes.begin(), msg_bytes.end());
+  }
+}
+
+inline void StateSerializer::deserialize_scalar_queue(Bytes::const_iterator& it, ScalarQueue& queue) {
+  MessageQueue messages;
+  deserialize_message_queue(it, messages);
+
+  queue.clear();
+  for (const auto& msg : messages) {
+    queue.push_back({msg->time, scalar_value(*msg)});
+  }
+}
+
 inline void StateSerializer::serialize_index_set(Bytes& bytes, const std::set<size_t>& indices) {
   size_t set_size = indices.size();
   bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&set_size),
@@ -381,6 +452,194 @@ inline void StateSerializer::deserialize_port_control_map(Bytes::const_iterator&
   }
 }
 
+inline uint8_t StateSerializer::type_tag(const std::type_index& type) {
+  if (type == std::type_index(typeid(NumberData))) return TAG_NUMBER;
+  if (type == std::type_index(typeid(BooleanData))) return TAG_BOOLEAN;
+  if (type == std::type_index(typeid(VectorNumberData))) return TAG_VECTOR_NUMBER;
+  if (type == std::type_index(typeid(VectorBooleanData))) return TAG_VECTOR_BOOLEAN;
+  throw std::runtime_error(std::string("Binary snapshot: unsupported message type ") + type.name());
+}
+
+inline void StateSerializer::write_payload(ByteWriter& w, const BaseMessage& msg, uint8_t tag) {
+  switch (tag) {
+    case TAG_NUMBER:
+      w.write(static_cast<const Message<NumberData>&>(msg).data.value);
+      break;
+    case TAG_BOOLEAN:
+      w.write<uint8_t>(static_cast<const Message<BooleanData>&>(msg).data.value ? 1 : 0);
+      break;
+    case TAG_VECTOR_NUMBER: {
+      const auto& v = static_cast<const Message<VectorNumberData>&>(msg).data;
+      const size_t n = v.size();
+      w.write_size(n);
+      if (const double* p = v.contiguous_data()) {
+        w.write_array(p, n);
+      } else {
+        for (size_t i = 0; i < n; ++i) w.write(v[i]);
+      }
+      break;
+    }
+    case TAG_VECTOR_BOOLEAN: {
+      const auto& v = *static_cast<const Message<VectorBooleanData>&>(msg).data.values;
+      w.write_size(v.size());
+      uint8_t packed = 0;
+      for (size_t i = 0; i < v.size(); ++i) {
+        if (v[i]) packed |= static_cast<uint8_t>(1u << (i % 8));
+        if (i % 8 == 7 || i + 1 == v.size()) {
+          w.write(packed);
+          packed = 0;
+        }
+      }
+      break;
+    }
+    default:
+      throw std::runtime_error("Binary snapshot: unknown type tag " + std::to_string(tag));
+  }
+}
+
+inline std::unique_ptr<BaseMessage> StateSerializer::read_payload(ByteReader& r, uint8_t tag, timestamp_t time) {
+  switch (tag) {
+    case TAG_NUMBER:
+      return create_message<NumberData>(time, NumberData{r.read<double>()});
+    case TAG_BOOLEAN:
+      return create_message<BooleanData>(time, BooleanData{r.read<uint8_t>() != 0});
+    case TAG_VECTOR_NUMBER: {
+      const size_t n = r.read_size();
+      if (n > r.remaining() / sizeof(double)) throw std::runtime_error("Binary snapshot truncated");
+      auto values = make_pooled_vector_double(n);
+      r.read_array(values->data(), n);
+      return create_message<VectorNumberData>(time, VectorNumberData(std::move(values)));
+    }
+    case TAG_VECTOR_BOOLEAN: {
+      const size_t n = r.read_size();
+      if ((n + 7) / 8 > r.remaining()) throw std::runtime_error("Binary snapshot truncated");
+      std::vector<bool> values(n);
+      uint8_t packed = 0;
+      for (size_t i = 0; i < n; ++i) {
+        if (i % 8 == 0) packed = r.read<uint8_t>();
+        values[i] = (packed >> (i % 8)) & 1;
+      }
+      return create_message<VectorBooleanData>(time, VectorBooleanData(std::move(values)));
+    }
+    default:
+      throw std::runtime_error("Binary snapshot: unknown type tag " + std::to_string(tag));
+  }
+}
+
+inline void StateSerializer::write_message(ByteWriter& w, const BaseMessage& msg) {
+  const uint8_t tag = type_tag(msg.type());
+  w.write(tag);
+  w.write(msg.time);
+  write_payload(w, msg, tag);
+}
+
+inline std::unique_ptr<BaseMessage> StateSerializer::read_message(ByteReader& r) {
+  const uint8_t tag = r.read<uint8_t>();
+  const timestamp_t time = r.read<timestamp_t>();
+  return read_payload(r, tag, time);
+}
+
+template <typename Range>
+inline void StateSerializer::write_messages(ByteWriter& w, const Range& messages, const std::type_index& type) {
+  const uint8_t tag = type_tag(type);
+  const size_t count = messages.size();
+  w.write_size(count);
+  w.write(tag);
+  if (count == 0) return;
+
+  if (tag == TAG_NUMBER) {
+    w.reserve(count * (sizeof(timestamp_t) + sizeof(double)));
+    for (const auto& msg : messages) w.write(msg->time);
+    for (const auto& msg : messages) w.write(static_cast<const Message<NumberData>&>(as_base(*msg)).data.value);
+  } else if (tag == TAG_BOOLEAN) {
+    w.reserve(count * (sizeof(timestamp_t) + 1));
+    for (const auto& msg : messages) w.write(msg->time);
+    for (const auto& msg : messages) {
+      w.write<uint8_t>(static_cast<const Message<BooleanData>&>(as_base(*msg)).data.value);
+    }
+  } else {
+    for (const auto& msg : messages) {
+      w.write(msg->time);
+      write_payload(w, *msg, tag);
+    }
+  }
+}
+
+template <typename Row>
+inline void StateSerializer::read_scalar_columns(ByteReader& r, size_t count, uint8_t tag, Row&& row) {
+  const size_t value_size = tag == TAG_NUMBER ? sizeof(double) : 1;
+  if (count > r.remaining() / (sizeof(timestamp_t) + value_size)) {
+    throw std::runtime_error("Binary snapshot truncated");
+  }
+  std::vector<timestamp_t> times(count);
+  r.read_array(times.data(), count);
+  if (tag == TAG_NUMBER) {
+    std::vector<double> values(count);
+    r.read_array(values.data(), count);
+    for (size_t i = 0; i < count; ++i) row(times[i], values[i]);
+  } else {
+    std::vector<uint8_t> values(count);
+    r.read_array(values.data(), count);
+    for (size_t i = 0; i < count; ++i) row(times[i], values[i] ? 1.0 : 0.0);
+  }
+}
+
+inline void StateSerializer::check_tag(uint8_t stored, uint8_t expected) {
+  if (stored != expected) {
+    throw std::runtime_error("Port type mismatch during restore: stored tag=" + std::to_string(stored) +
+                             ", expected tag=" + std::to_string(expected));
+  }
+}
+
+template <typename Sink>
+inline void StateSerializer::read_messages(ByteReader& r, const std::type_index& type, Sink&& sink) {
+  const size_t count = r.read_size();
+  const uint8_t tag = r.read<uint8_t>();
+  check_tag(tag, type_tag(type));
+
+  if (tag == TAG_NUMBER || tag == TAG_BOOLEAN) {
+    read_scalar_columns(r, count, tag, [&](timestamp_t time, double value) {
+      sink(make_scalar_message(type, time, value));
+    });
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    const timestamp_t time = r.read<timestamp_t>();
+    sink(read_payload(r, tag, time));
+  }
+}
+
+inline void StateSerializer::read_message_queue(ByteReader& r, MessageQueue& queue, const std::type_index& type) {
+  queue.clear();
+  read_messages(r, type, [&](std::unique_ptr<BaseMessage> msg) { queue.push_back(std::move(msg)); });
+}
+
+inline void StateSerializer::write_scalar_queue(ByteWriter& w, const ScalarQueue& queue,
+                                                const std::type_index& type) {
+  const uint8_t tag = type_tag(type);
+  const size_t count = queue.size();
+  w.write_size(count);
+  w.write(tag);
+  if (count == 0) return;
+  for (const auto& rec : queue) w.write(rec.time);
+  if (tag == TAG_NUMBER) {
+    for (const auto& rec : queue) w.write(rec.value);
+  } else {
+    for (const auto& rec : queue) w.write<uint8_t>(rec.value != 0.0);
+  }
+}
+
+inline void StateSerializer::read_scalar_queue(ByteReader& r, ScalarQueue& queue, const std::type_index& type) {
+  const size_t count = r.read_size();
+  const uint8_t tag = r.read<uint8_t>();
+  check_tag(tag, type_tag(type));
+  if (tag != TAG_NUMBER && tag != TAG_BOOLEAN) {
+    throw std::runtime_error("Binary snapshot: scalar queue with vector type tag");
+  }
+  queue.clear();
+  read_scalar_columns(r, count, tag, [&](timestamp_t time, double value) { queue.push_back({time, value}); });
+}
+
 }  // namespace rtbot
 
-#endif  // STATE_SERIALIZER_H
\ No newline at end of file
+#endif  // STATE_SERIALIZER_H
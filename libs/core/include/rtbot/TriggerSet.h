@@ -132,6 +132,28 @@ class TriggerSet : public Operator {
     }
   }
 
+  void write_state(ByteWriter& w) override {
+    write_ports(w);
+    w.write_size(operators_.size());
+    for (const auto& [op_id, op] : operators_) {
+      w.write_string(op_id);
+      op->write_state(w);
+    }
+  }
+
+  void read_state(ByteReader& r) override {
+    read_ports(r);
+    const size_t count = r.read_size();
+    for (size_t i = 0; i < count; ++i) {
+      const std::string op_id = r.read_string();
+      auto it = operators_.find(op_id);
+      if (it == operators_.end()) {
+        throw std::runtime_error("TriggerSet " + id() + ": snapshot has unknown operator " + op_id);
+      }
+      it->second->read_state(r);
+    }
+  }
+
   std::string type_name() const override { return "TriggerSet"; }
 
   bool equals(const TriggerSet& other) const {
@@ -0,0 +1,167 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rtbot {
+
+// Fork-join pool for running a burst of independent tasks in parallel.
+//
+// run(n, task) calls task(0..n-1) across `threads` participants — the
+// calling thread plus threads - 1 workers — and returns once every task has
+// finished. Tasks are dealt out as contiguous ranges, one per participant;
+// a participant that runs out of its own range steals from the far end of
+// the others', so skewed task costs still balance. Workers sleep between
+// runs. The first exception thrown by a task is rethrown by run(), and the
+// tasks not yet started are skipped.
+//
+// One run() at a time: the pool belongs to a single owner (e.g. one
+// KeyedPipeline) and is not meant to be shared between callers.
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(size_t threads) : queues_(threads > 0 ? threads : 1) {
+    for (auto& q : queues_) q = std::make_unique<Queue>();
+    workers_.reserve(queues_.size() - 1);
+    for (size_t i = 1; i < queues_.size(); ++i) {
+      workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+  }
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& w : workers_) w.join();
+  }
+
+  size_t size() const { return queues_.size(); }
+
+  void run(size_t n, const std::function<void(size_t)>& task) {
+    if (n == 0) return;
+    if (workers_.empty() || n == 1) {
+      for (size_t i = 0; i < n; ++i) task(i);
+      return;
+    }
+
+    const size_t p = queues_.size();
+    for (size_t q = 0; q < p; ++q) {
+      std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+      for (size_t i = q * n / p; i < (q + 1) * n / p; ++i) queues_[q]->tasks.push_back(i);
+    }
+    failed_.store(false, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = &task;
+      error_ = nullptr;
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    work(0);
+
+    // Every queue is empty once work(0) returns; wait for the workers still
+    // inside a task.
+    std::exception_ptr error;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this] { return busy_ == 0; });
+      task_ = nullptr;
+      std::swap(error, error_);
+    }
+    if (error) std::rethrow_exception(error);
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+  void worker_loop(size_t self) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      wake_.wait(lock, [&] { return stop_ || (task_ != nullptr && generation_ != seen); });
+      if (stop_) return;
+      seen = generation_;
+      ++busy_;
+      lock.unlock();
+      work(self);
+      lock.lock();
+      if (--busy_ == 0) done_.notify_all();
+    }
+  }
+
+  // Own range front to back, then steal from the back of the others.
+  bool take(size_t self, size_t& task) {
+    {
+      Queue& own = *queues_[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = own.tasks.front();
+        own.tasks.pop_front();
+        return true;
+      }
+    }
+    for (size_t k = 1; k < queues_.size(); ++k) {
+      Queue& victim = *queues_[(self + k) % queues_.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = victim.tasks.back();
+        victim.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(size_t self) {
+    const std::function<void(size_t)>* task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task = task_;
+    }
+    size_t i;
+    while (take(self, i)) {
+      if (failed_.load(std::memory_order_relaxed)) continue;
+      try {
+        (*task)(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) error_ = std::current_exception();
+        failed_.store(true, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(size_t)>* task_{nullptr};
+  uint64_t generation_{0};
+  size_t busy_{0};
+  bool stop_{false};
+  std::exception_ptr error_;
+  std::atomic<bool> failed_{false};
+};
+
+}  // namespace rtbot
+
+#endif  // WORK_STEALING_POOL_H
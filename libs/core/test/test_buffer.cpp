@@ -182,6 +182,94 @@ SCENARIO("Buffer operator handles state serialization and restoration", "[Buffer
         }
       }
     }
+
+    WHEN("State is written as a binary snapshot and read into a new buffer") {
+      Bytes snapshot;
+      ByteWriter writer(snapshot);
+      buffer.write_state(writer);
+
+      auto restored_buffer = TestBuffer<FullStats>("test", 3);
+      ByteReader reader(snapshot);
+      restored_buffer.read_state(reader);
+
+      THEN("The window and statistics match and the snapshot is consumed") {
+        REQUIRE(reader.at_end());
+        REQUIRE(restored_buffer.buffer_size() == 3);
+        REQUIRE(restored_buffer.sum() == buffer.sum());
+        REQUIRE(restored_buffer.variance() == buffer.variance());
+        REQUIRE(restored_buffer.buffer().front()->time == 1);
+        REQUIRE(restored_buffer.buffer().back()->data.value == 6.0);
+      }
+
+      THEN("The binary snapshot is smaller than the legacy bytes") {
+        REQUIRE(snapshot.size() < buffer.collect_bytes().size());
+      }
+    }
+
+    WHEN("A delta is written after more messages slide the window") {
+      Bytes base;
+      ByteWriter base_writer(base);
+      buffer.write_state(base_writer);
+      buffer.mark_checkpoint(1);
+
+      buffer.receive_data(create_message<NumberData>(4, NumberData{8.0}), 0);
+      buffer.execute();
+      buffer.receive_data(create_message<NumberData>(5, NumberData{10.0}), 0);
+      buffer.execute();
+
+      Bytes delta;
+      ByteWriter delta_writer(delta);
+      buffer.write_delta(delta_writer, 1);
+
+      auto restored_buffer = TestBuffer<FullStats>("test", 3);
+      ByteReader base_reader(base);
+      restored_buffer.read_state(base_reader);
+      restored_buffer.mark_checkpoint(1);
+      ByteReader delta_reader(delta);
+      restored_buffer.read_delta(delta_reader);
+
+      THEN("Base plus delta rebuilds the current window") {
+        REQUIRE(delta_reader.at_end());
+        REQUIRE(restored_buffer.buffer_size() == 3);
+        REQUIRE(restored_buffer.buffer().front()->time == 3);
+        REQUIRE(restored_buffer.buffer().back()->data.value == 10.0);
+        REQUIRE(restored_buffer.sum() == buffer.sum());
+        REQUIRE(restored_buffer.variance() == Approx(buffer.variance()));
+      }
+
+      THEN("The delta is smaller than the full state") { REQUIRE(delta.size() < base.size()); }
+    }
+  }
+}
+
+SCENARIO("Buffer copies carry the configuration, not the window", "[Buffer]") {
+  GIVEN("A Buffer holding messages") {
+    auto buffer = TestBuffer<FullStats>("test", 2);
+    buffer.receive_data(create_message<NumberData>(1, NumberData{2.0}), 0);
+    buffer.execute();
+
+    WHEN("It is copied") {
+      TestBuffer<FullStats> copy(buffer);
+
+      THEN("The copy has the same window size and ports but starts empty") {
+        REQUIRE(copy.id() == "test");
+        REQUIRE(copy.window_size() == 2);
+        REQUIRE(copy.num_data_ports() == 1);
+        REQUIRE(copy.num_output_ports() == 1);
+        REQUIRE(copy.buffer_size() == 0);
+        REQUIRE(copy.sum() == 0.0);
+      }
+
+      THEN("The copy runs independently") {
+        copy.receive_data(create_message<NumberData>(5, NumberData{4.0}), 0);
+        copy.execute();
+        copy.receive_data(create_message<NumberData>(6, NumberData{6.0}), 0);
+        copy.execute();
+        REQUIRE(copy.buffer_full());
+        REQUIRE(copy.mean() == 5.0);
+        REQUIRE(buffer.buffer_size() == 1);
+      }
+    }
   }
 }
 
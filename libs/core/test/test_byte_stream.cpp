@@ -0,0 +1,113 @@
+#include <catch2/catch.hpp>
+#include <limits>
+
+#include "rtbot/ByteStream.h"
+#include "rtbot/StateSerializer.h"
+
+using namespace rtbot;
+
+SCENARIO("ByteWriter and ByteReader round-trip values", "[ByteStream]") {
+  Bytes bytes;
+  ByteWriter w(bytes);
+  w.write<int64_t>(-42);
+  w.write(3.25);
+  w.write_varint(0);
+  w.write_varint(127);
+  w.write_varint(128);
+  w.write_varint(std::numeric_limits<uint64_t>::max());
+  const double column[] = {1.0, 2.0, 3.0};
+  w.write_array(column, 3);
+  w.write_string("ma1");
+  const uint8_t blob[] = {9, 8, 7};
+  w.write_blob(blob, 3);
+
+  THEN("Small varints take one byte") {
+    Bytes one;
+    ByteWriter(one).write_varint(127);
+    REQUIRE(one.size() == 1);
+  }
+
+  THEN("Everything reads back in order") {
+    ByteReader r(bytes);
+    REQUIRE(r.read<int64_t>() == -42);
+    REQUIRE(r.read<double>() == 3.25);
+    REQUIRE(r.read_varint() == 0);
+    REQUIRE(r.read_varint() == 127);
+    REQUIRE(r.read_varint() == 128);
+    REQUIRE(r.read_varint() == std::numeric_limits<uint64_t>::max());
+    double out[3];
+    r.read_array(out, 3);
+    REQUIRE(out[2] == 3.0);
+    REQUIRE(r.read_string() == "ma1");
+    size_t size = 0;
+    const uint8_t* data = r.read_blob(size);
+    REQUIRE(size == 3);
+    REQUIRE(data[0] == 9);
+    REQUIRE(r.at_end());
+  }
+
+  THEN("Reading past the end throws") {
+    ByteReader r(bytes.data(), 5);
+    REQUIRE_THROWS_AS(r.read<double>(), std::runtime_error);
+  }
+}
+
+SCENARIO("StateSerializer writes message runs with interned type tags", "[ByteStream][StateSerializer]") {
+  GIVEN("A queue of number messages") {
+    MessageQueue queue;
+    for (int i = 1; i <= 4; ++i) queue.push_back(create_message<NumberData>(i, NumberData{i * 1.5}));
+
+    Bytes bytes;
+    ByteWriter w(bytes);
+    StateSerializer::write_message_queue(w, queue, typeid(NumberData));
+
+    THEN("The run is a count, one tag and two columns") {
+      REQUIRE(bytes.size() == 1 + 1 + 4 * (sizeof(timestamp_t) + sizeof(double)));
+    }
+
+    THEN("It reads back into a value queue") {
+      ScalarQueue values;
+      ByteReader r(bytes);
+      StateSerializer::read_scalar_queue(r, values, typeid(NumberData));
+      REQUIRE(values.size() == 4);
+      REQUIRE(values.back().time == 4);
+      REQUIRE(values.back().value == 6.0);
+    }
+
+    THEN("Reading it as another port type throws") {
+      MessageQueue wrong;
+      ByteReader r(bytes);
+      REQUIRE_THROWS_AS(StateSerializer::read_message_queue(r, wrong, typeid(BooleanData)), std::runtime_error);
+    }
+  }
+
+  GIVEN("Vector messages, including a strided view") {
+    MessageQueue queue;
+    queue.push_back(create_message<VectorNumberData>(1, VectorNumberData{std::vector<double>{1, 2, 3, 4}}));
+    queue.push_back(
+        create_message<VectorNumberData>(2, VectorNumberData{std::vector<double>{1, 2, 3, 4, 5}}.slice(0, 3, 2)));
+    queue.push_back(create_message<VectorBooleanData>(3, VectorBooleanData{std::vector<bool>(11, true)}));
+
+    Bytes bytes;
+    ByteWriter w(bytes);
+    StateSerializer::write_message(w, *queue[0]);
+    StateSerializer::write_message(w, *queue[1]);
+    StateSerializer::write_message(w, *queue[2]);
+
+    THEN("They read back element for element") {
+      REQUIRE(bytes[0] == StateSerializer::TAG_VECTOR_NUMBER);
+      ByteReader r(bytes);
+      auto v1 = StateSerializer::read_message(r);
+      auto v2 = StateSerializer::read_message(r);
+      auto v3 = StateSerializer::read_message(r);
+      REQUIRE(r.at_end());
+      REQUIRE(v1->time == 1);
+      const auto& view = static_cast<const Message<VectorNumberData>&>(*v2).data;
+      REQUIRE(view.size() == 3);
+      REQUIRE(view[2] == 5.0);
+      const auto& flags = *static_cast<const Message<VectorBooleanData>&>(*v3).data.values;
+      REQUIRE(flags.size() == 11);
+      REQUIRE(flags[10]);
+    }
+  }
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "rtbot/CountMinSketch.h"
+
+using namespace rtbot;
+
+namespace {
+
+// Skewed keys: a few heavy hitters over a long tail.
+std::vector<double> make_keys(size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::geometric_distribution<int> heavy(0.2);
+  std::uniform_int_distribution<int> tail(100, 100000);
+  std::bernoulli_distribution pick_heavy(0.5);
+  std::vector<double> keys(n);
+  for (auto& k : keys) k = pick_heavy(rng) ? heavy(rng) : tail(rng);
+  return keys;
+}
+
+size_t count_in(const std::deque<double>& keys, double key) {
+  size_t n = 0;
+  for (double k : keys) n += k == key;
+  return n;
+}
+
+}  // namespace
+
+SCENARIO("SlidingCountMin bounds counts over a sliding window", "[CountMinSketch]") {
+  const size_t window = 2000;
+  const size_t panes = 8;
+  const size_t pane_size = window / panes;
+  const double epsilon = 0.01;
+  const double delta = 0.01;
+  SlidingCountMin sketch(window, epsilon, delta, panes);
+  REQUIRE(sketch.depth() == 5);
+  REQUIRE(sketch.width() == 272);
+
+  const auto keys = make_keys(20000, 3);
+  std::deque<double> last_window;  // exact last `window` keys
+  std::deque<double> covered;      // the keys the sketch still counts
+  size_t over_bound = 0;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const uint64_t est = sketch.add(keys[i]);
+    last_window.push_back(keys[i]);
+    covered.push_back(keys[i]);
+    if (last_window.size() > window) last_window.pop_front();
+    // Full panes plus the current one; the current pane holds
+    // (i % pane_size) + 1 keys.
+    const size_t live = panes * pane_size + i % pane_size + 1;
+    while (covered.size() > live) covered.pop_front();
+
+    REQUIRE(est >= count_in(last_window, keys[i]));
+    REQUIRE(est >= count_in(covered, keys[i]));
+    REQUIRE(est == sketch.estimate(keys[i]));
+    if (est - count_in(covered, keys[i]) > epsilon * static_cast<double>(covered.size())) ++over_bound;
+  }
+  // Each estimate exceeds the bound with probability at most delta.
+  REQUIRE(over_bound <= 2 * delta * keys.size());
+
+  THEN("Keys that left the window stop counting") {
+    for (size_t i = 0; i < window + pane_size; ++i) sketch.add(-1.0);
+    REQUIRE(sketch.estimate(0.0) == 0);
+    REQUIRE(sketch.estimate(-1.0) == window + pane_size);
+  }
+}
+
+SCENARIO("SlidingCountMin folds -0.0 and NaN keys", "[CountMinSketch]") {
+  SlidingCountMin sketch(10, 0.1, 0.1, 2);
+  sketch.add(0.0);
+  REQUIRE(sketch.add(-0.0) == 2);
+  sketch.add(std::numeric_limits<double>::quiet_NaN());
+  REQUIRE(sketch.add(-std::numeric_limits<double>::quiet_NaN()) == 2);
+}
+
+SCENARIO("SlidingCountMin serializes and clears", "[CountMinSketch]") {
+  SlidingCountMin sketch(100, 0.05, 0.05, 4);
+  const auto keys = make_keys(1234, 9);
+  for (double k : keys) sketch.add(k);
+
+  THEN("restore() rebuilds an equal sketch that keeps sliding the same way") {
+    Bytes bytes;
+    sketch.serialize(bytes);
+    SlidingCountMin restored(100, 0.05, 0.05, 4);
+    Bytes::const_iterator it = bytes.begin();
+    restored.restore(it);
+    REQUIRE(it == bytes.end());
+    REQUIRE(restored == sketch);
+    for (double k : make_keys(500, 10)) REQUIRE(restored.add(k) == sketch.add(k));
+  }
+
+  THEN("clear() empties every pane") {
+    sketch.clear();
+    REQUIRE(sketch == SlidingCountMin(100, 0.05, 0.05, 4));
+    REQUIRE(sketch.estimate(keys.back()) == 0);
+  }
+
+  THEN("Invalid parameters are rejected") {
+    REQUIRE_THROWS_AS(SlidingCountMin(0, 0.1, 0.1, 1), std::runtime_error);
+    REQUIRE_THROWS_AS(SlidingCountMin(10, 0.0, 0.1, 1), std::runtime_error);
+    REQUIRE_THROWS_AS(SlidingCountMin(10, 0.1, 1.0, 1), std::runtime_error);
+    REQUIRE_THROWS_AS(SlidingCountMin(10, 0.1, 0.1, 0), std::runtime_error);
+  }
+
+  THEN("Panes are capped at the window") {
+    REQUIRE(SlidingCountMin(3, 0.1, 0.1, 8).panes() == 3);
+  }
+}
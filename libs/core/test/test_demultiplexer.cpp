@@ -221,3 +221,47 @@ SCENARIO("Demultiplexer handles state serialization", "[demultiplexer][State]")
     }
   }
 }
+
+SCENARIO("Demultiplexer emits only on the edges of the selected port", "[demultiplexer]") {
+  GIVEN("A demultiplexer whose ports were connected out of order, some with fan-out") {
+    constexpr size_t kPorts = 8;
+    auto demux = std::make_shared<Demultiplexer<NumberData>>("demux", kPorts);
+    std::vector<std::shared_ptr<Collector>> cols;
+    for (size_t i = 0; i < kPorts; ++i) {
+      cols.push_back(std::make_shared<Collector>("c" + std::to_string(i), std::vector<std::string>{"number", "number"}));
+    }
+    // Interleave ports so edges of one port are not contiguous in connect order.
+    for (size_t i = 0; i < kPorts; ++i) demux->connect(cols[(i * 3) % kPorts], (i * 3) % kPorts, 0);
+    for (size_t i = 0; i < kPorts; i += 2) demux->connect(cols[i], i, 1);
+
+    THEN("each port indexes exactly its own edges") {
+      REQUIRE(demux->num_connections() == kPorts + kPorts / 2);
+      for (size_t i = 0; i < kPorts; ++i) REQUIRE(demux->port_edge_count(i) == (i % 2 == 0 ? 2 : 1));
+      REQUIRE(demux->port_edge_count(kPorts) == 0);
+    }
+
+    WHEN("each timestamp selects one port") {
+      for (size_t t = 1; t <= 4 * kPorts; ++t) {
+        for (size_t i = 0; i < kPorts; ++i) {
+          demux->receive_control(create_message<BooleanData>(t, BooleanData{i == t % kPorts}), i);
+        }
+        demux->receive_data(create_message<NumberData>(t, NumberData{static_cast<double>(t)}), 0);
+      }
+      demux->execute();
+
+      THEN("only the collectors of that port receive the message") {
+        for (size_t i = 0; i < kPorts; ++i) {
+          for (size_t port = 0; port < 2; ++port) {
+            const auto& q = cols[i]->get_data_queue(port);
+            if (port == 1 && i % 2 == 1) {
+              REQUIRE(q.empty());
+              continue;
+            }
+            REQUIRE(q.size() == 4);
+            for (const auto& m : q) REQUIRE(m->time % kPorts == i);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,162 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/ExecutionSchedule.h"
+#include "rtbot/Input.h"
+#include "rtbot/Output.h"
+
+using namespace rtbot;
+
+namespace {
+
+// Forwards every number unchanged and logs its id to `trace` each time it
+// processes a non-empty queue.
+class Relay : public Operator {
+ public:
+  Relay(std::string id, std::vector<std::string>* trace) : Operator(std::move(id)), trace_(trace) {
+    add_data_port<NumberData>();
+    add_output_port<NumberData>();
+  }
+  std::string type_name() const override { return "Relay"; }
+
+ protected:
+  void process_data(bool debug) override {
+    auto& q = get_data_queue(0);
+    if (!q.empty() && trace_) trace_->push_back(id());
+    while (!q.empty()) {
+      emit_output(0, std::move(q.front()), debug);
+      q.pop_front();
+    }
+  }
+
+ private:
+  std::vector<std::string>* trace_;
+};
+
+// Emits value-1 one tick later until it reaches zero. Wired back onto itself
+// this forms the smallest recurrent loop.
+class Countdown : public Operator {
+ public:
+  explicit Countdown(std::string id) : Operator(std::move(id)) {
+    add_data_port<NumberData>();
+    add_output_port<NumberData>();
+  }
+  std::string type_name() const override { return "Countdown"; }
+
+ protected:
+  void process_data(bool debug) override {
+    auto& q = get_data_queue(0);
+    while (!q.empty()) {
+      const auto* m = static_cast<const Message<NumberData>*>(q.front().get());
+      if (m->data.value > 0) {
+        emit_output(0, create_message<NumberData>(m->time + 1, NumberData{m->data.value - 1}), debug);
+      }
+      q.pop_front();
+    }
+  }
+};
+
+std::vector<double> values(const MessageQueue& q) {
+  std::vector<double> out;
+  for (const auto& m : q) out.push_back(static_cast<const Message<NumberData>*>(m.get())->data.value);
+  return out;
+}
+
+}  // namespace
+
+SCENARIO("ExecutionSchedule orders a diamond like the recursive walk", "[execution_schedule]") {
+  std::vector<std::string> trace;
+  auto in = make_number_input("in");
+  auto b = std::make_shared<Relay>("b", &trace);
+  auto c = std::make_shared<Relay>("c", &trace);
+  auto out = make_output("out", std::vector<std::string>{PortType::NUMBER, PortType::NUMBER});
+  auto col = make_collector("col", std::vector<std::string>{PortType::NUMBER, PortType::NUMBER});
+  in->connect(b);
+  in->connect(c);
+  b->connect(out, 0, 0);
+  c->connect(out, 0, 1);
+  out->connect(col, 0, 0);
+  out->connect(col, 1, 1);
+
+  ExecutionSchedule schedule;
+  schedule.compile(in.get());
+
+  THEN("operators are ordered topologically, siblings in connection order") {
+    REQUIRE(schedule.size() == 5);
+    const auto& order = schedule.order();
+    REQUIRE(order[0] == in.get());
+    REQUIRE(order[1] == b.get());
+    REQUIRE(order[2] == c.get());
+    REQUIRE(order[3] == out.get());
+    REQUIRE(order[4] == col.get());
+  }
+
+  WHEN("messages are driven through the schedule") {
+    for (int i = 1; i <= 3; ++i) {
+      in->receive_data(create_message<NumberData>(i, NumberData{i * 1.0}), 0);
+      schedule.run();
+    }
+    THEN("each operator runs once per pass and both branches arrive") {
+      REQUIRE(trace == std::vector<std::string>{"b", "c", "b", "c", "b", "c"});
+      REQUIRE(values(col->get_data_queue(0)) == std::vector<double>{1, 2, 3});
+      REQUIRE(values(col->get_data_queue(1)) == std::vector<double>{1, 2, 3});
+    }
+  }
+}
+
+SCENARIO("ExecutionSchedule follows recurrent edges", "[execution_schedule]") {
+  auto build = [](std::shared_ptr<Input>& in, std::shared_ptr<Countdown>& loop, std::shared_ptr<Collector>& col) {
+    in = make_number_input("in");
+    loop = std::make_shared<Countdown>("loop");
+    col = make_number_collector("col");
+    in->connect(loop);
+    loop->connect(loop);
+    loop->connect(col);
+  };
+
+  std::shared_ptr<Input> rec_in, flat_in;
+  std::shared_ptr<Countdown> rec_loop, flat_loop;
+  std::shared_ptr<Collector> rec_col, flat_col;
+  build(rec_in, rec_loop, rec_col);
+  build(flat_in, flat_loop, flat_col);
+
+  ExecutionSchedule schedule;
+  schedule.compile(flat_in.get());
+
+  rec_in->receive_data(create_message<NumberData>(1, NumberData{5.0}), 0);
+  rec_in->execute();
+  flat_in->receive_data(create_message<NumberData>(1, NumberData{5.0}), 0);
+  schedule.run();
+
+  THEN("the loop unrolls to the same output as Operator::execute") {
+    REQUIRE(values(rec_col->get_data_queue(0)) == std::vector<double>{4, 3, 2, 1, 0});
+    REQUIRE(values(flat_col->get_data_queue(0)) == values(rec_col->get_data_queue(0)));
+  }
+}
+
+SCENARIO("ExecutionSchedule runs deep chains without recursion", "[execution_schedule]") {
+  constexpr size_t kDepth = 20000;
+  auto in = make_number_input("in");
+  std::vector<std::shared_ptr<Relay>> chain;
+  chain.reserve(kDepth);
+  std::shared_ptr<Operator> prev = in;
+  for (size_t i = 0; i < kDepth; ++i) {
+    chain.push_back(std::make_shared<Relay>("r" + std::to_string(i), nullptr));
+    prev->connect(chain.back());
+    prev = chain.back();
+  }
+  auto col = make_number_collector("col");
+  prev->connect(col);
+
+  ExecutionSchedule schedule;
+  schedule.compile(in.get());
+  REQUIRE(schedule.size() == kDepth + 2);
+
+  in->receive_data(create_message<NumberData>(1, NumberData{7.0}), 0);
+  schedule.run();
+  REQUIRE(values(col->get_data_queue(0)) == std::vector<double>{7.0});
+}
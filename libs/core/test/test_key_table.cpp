@@ -0,0 +1,113 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "rtbot/KeyTable.h"
+
+using namespace rtbot;
+
+namespace {
+
+std::vector<double> recency(const KeyTable<int>& table) {
+  std::vector<double> keys;
+  table.for_each([&](KeyTable<int>::Slot s) { keys.push_back(table.key(s)); });
+  return keys;
+}
+
+}  // namespace
+
+SCENARIO("KeyTable finds, inserts and erases keys", "[KeyTable]") {
+  KeyTable<int> table;
+  REQUIRE(table.find(1.0) == KeyTable<int>::npos);
+
+  auto [a, inserted_a] = table.insert(1.0);
+  table.value(a) = 10;
+  auto [b, inserted_b] = table.insert(2.5);
+  table.value(b) = 20;
+  REQUIRE(inserted_a);
+  REQUIRE(inserted_b);
+  REQUIRE(table.size() == 2);
+
+  THEN("Existing keys are found, not inserted again") {
+    auto [again, inserted] = table.insert(1.0);
+    REQUIRE_FALSE(inserted);
+    REQUIRE(again == a);
+    REQUIRE(table.value(table.find(2.5)) == 20);
+  }
+
+  THEN("-0.0 is the same key as 0.0 and NaN is a single key") {
+    auto zero = table.insert(0.0).first;
+    REQUIRE(table.find(-0.0) == zero);
+    auto nan = table.insert(std::nan("")).first;
+    REQUIRE(table.insert(-std::numeric_limits<double>::quiet_NaN()).first == nan);
+    REQUIRE(table.size() == 4);
+  }
+
+  THEN("Erasing frees the slot for reuse and keeps other values in place") {
+    int* kept = &table.value(b);
+    table.erase(a);
+    REQUIRE(table.find(1.0) == KeyTable<int>::npos);
+    REQUIRE(table.size() == 1);
+    auto [c, inserted] = table.insert(7.0);
+    REQUIRE(inserted);
+    REQUIRE(c == a);
+    REQUIRE(table.value(c) == 0);
+    REQUIRE(&table.value(b) == kept);
+  }
+}
+
+SCENARIO("KeyTable keeps keys in recency order", "[KeyTable]") {
+  KeyTable<int> table;
+  for (double k : {1.0, 2.0, 3.0}) table.touch(table.insert(k).first, static_cast<int64_t>(k));
+
+  REQUIRE(recency(table) == std::vector<double>{1.0, 2.0, 3.0});
+
+  table.touch(table.find(1.0), 10);
+  REQUIRE(recency(table) == std::vector<double>{2.0, 3.0, 1.0});
+  REQUIRE(table.key(table.oldest()) == 2.0);
+  REQUIRE(table.key(table.newest()) == 1.0);
+  REQUIRE(table.last_seen(table.newest()) == 10);
+
+  table.erase(table.find(3.0));
+  REQUIRE(recency(table) == std::vector<double>{2.0, 1.0});
+  REQUIRE(table.key(table.older(table.newest())) == 2.0);
+}
+
+SCENARIO("KeyTable matches std::map under random inserts and erases", "[KeyTable]") {
+  KeyTable<int> table;
+  std::map<double, int> reference;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, 2000);
+
+  for (int step = 0; step < 50000; ++step) {
+    const double key = pick(rng) * 0.5;
+    if (step % 3 == 2) {
+      const auto s = table.find(key);
+      REQUIRE((s != KeyTable<int>::npos) == (reference.count(key) == 1));
+      if (s != KeyTable<int>::npos) {
+        table.erase(s);
+        reference.erase(key);
+      }
+    } else {
+      auto [s, inserted] = table.insert(key);
+      REQUIRE(inserted == (reference.count(key) == 0));
+      table.value(s) += 1;
+      reference[key] += 1;
+    }
+  }
+
+  REQUIRE(table.size() == reference.size());
+  for (const auto& [key, count] : reference) {
+    const auto s = table.find(key);
+    REQUIRE(s != KeyTable<int>::npos);
+    REQUIRE(table.value(s) == count);
+  }
+  REQUIRE(recency(table).size() == reference.size());
+
+  table.clear();
+  REQUIRE(table.empty());
+  REQUIRE(table.oldest() == KeyTable<int>::npos);
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <sstream>
+
+#include "rtbot/LatencyHistogram.h"
+
+using namespace rtbot;
+
+SCENARIO("LatencyHistogram buckets are log-linear", "[latency][histogram]") {
+  GIVEN("Values below the sub-bucket count") {
+    THEN("each has its own bucket") {
+      for (uint64_t v = 0; v < LatencyHistogram::kSubBucketCount; ++v) {
+        REQUIRE(LatencyHistogram::index_of(v) == v);
+        REQUIRE(LatencyHistogram::highest_equivalent(v) == v);
+      }
+    }
+  }
+
+  GIVEN("Values across the uint64_t range") {
+    THEN("every value lies in its bucket, and buckets are at most 1/32 of their values wide") {
+      for (int bit = 6; bit < 64; ++bit) {
+        for (uint64_t v : {uint64_t{1} << bit, (uint64_t{1} << bit) + 12345, ~uint64_t{0} >> (63 - bit)}) {
+          const size_t index = LatencyHistogram::index_of(v);
+          REQUIRE(index < LatencyHistogram::kBucketCount);
+          const uint64_t upper = LatencyHistogram::highest_equivalent(index);
+          REQUIRE(upper >= v);
+          REQUIRE(static_cast<double>(upper - v) <= static_cast<double>(v) / 32.0);
+          REQUIRE(LatencyHistogram::index_of(upper) == index);
+        }
+      }
+      REQUIRE(LatencyHistogram::index_of(~uint64_t{0}) == LatencyHistogram::kBucketCount - 1);
+    }
+  }
+}
+
+SCENARIO("LatencyHistogram reports percentiles", "[latency][histogram]") {
+  LatencyHistogram h;
+
+  GIVEN("An empty histogram") {
+    THEN("everything reads zero") {
+      REQUIRE(h.count() == 0);
+      REQUIRE(h.percentile(99) == 0);
+      REQUIRE(h.min() == 0);
+      REQUIRE(h.mean() == 0.0);
+    }
+  }
+
+  GIVEN("1..100000 ns recorded once each") {
+    for (uint64_t v = 1; v <= 100000; ++v) h.record(v);
+
+    THEN("percentiles are within the bucket resolution") {
+      REQUIRE(h.count() == 100000);
+      REQUIRE(h.min() == 1);
+      REQUIRE(h.max() == 100000);
+      REQUIRE(h.mean() == Approx(50000.5));
+      for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        const double exact = p / 100.0 * 100000.0;
+        REQUIRE(static_cast<double>(h.percentile(p)) >= exact);
+        REQUIRE(static_cast<double>(h.percentile(p)) <= exact * (1.0 + 1.0 / 32.0));
+      }
+      REQUIRE(h.percentile(100) == 100000);
+    }
+
+    WHEN("it is merged into another and reset") {
+      LatencyHistogram other;
+      other.record(1000000);
+      other.merge(h);
+      h.reset();
+
+      THEN("the counts move with the merge") {
+        REQUIRE(other.count() == 100001);
+        REQUIRE(other.max() == 1000000);
+        REQUIRE(other.min() == 1);
+        REQUIRE(h.count() == 0);
+        REQUIRE(h.max() == 0);
+      }
+    }
+  }
+
+  GIVEN("A single slow outlier among fast samples") {
+    for (int i = 0; i < 999; ++i) h.record(200);
+    h.record(5000000);
+
+    THEN("the median stays fast and the max keeps the outlier") {
+      REQUIRE(h.percentile(50) >= 200);
+      REQUIRE(h.percentile(50) <= 206);
+      REQUIRE(h.percentile(99) == h.percentile(50));
+      REQUIRE(h.percentile(100) == 5000000);
+    }
+
+    THEN("dump prints one row in microseconds") {
+      std::ostringstream os;
+      h.dump(os, "receive");
+      REQUIRE(os.str().find("receive") == 0);
+      REQUIRE(os.str().find("5000.00") != std::string::npos);
+    }
+  }
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "rtbot/Message.h"
+#include "rtbot/MessageArena.h"
+
+using namespace rtbot;
+
+SCENARIO("MessageArena routes allocations by scope", "[message][arena]") {
+  GIVEN("No open scope") {
+    auto msg = create_message<NumberData>(1, NumberData{1.0});
+    THEN("messages come from the pool / heap") { REQUIRE_FALSE(MessageArena::owns(msg.get())); }
+  }
+
+  GIVEN("An open scope") {
+    MessageArena::Scope arena;
+    auto msg = create_message<NumberData>(1, NumberData{1.0});
+    THEN("messages are carved from the arena") { REQUIRE(MessageArena::owns(msg.get())); }
+
+    WHEN("the arena is suspended") {
+      MessageArena::Suspend heap;
+      auto kept = create_message<NumberData>(2, NumberData{2.0});
+      THEN("messages go back to the heap") { REQUIRE_FALSE(MessageArena::owns(kept.get())); }
+    }
+
+    WHEN("a block does not fit in a chunk") {
+      void* big = MessageArena::allocate(MessageArena::kChunkBytes);
+      THEN("it falls back to the heap") { REQUIRE_FALSE(MessageArena::owns(big)); }
+      MessageArena::deallocate(big);
+    }
+  }
+}
+
+SCENARIO("MessageArena rewinds a chunk once its messages are gone", "[message][arena]") {
+  const void* first = nullptr;
+  {
+    MessageArena::Scope arena;
+    auto msg = create_message<NumberData>(1, NumberData{1.0});
+    first = msg.get();
+  }
+  MessageArena::Scope arena;
+  auto msg = create_message<NumberData>(2, NumberData{2.0});
+  REQUIRE(static_cast<const void*>(msg.get()) == first);
+  REQUIRE(msg->data.value == 2.0);
+}
+
+SCENARIO("MessageArena keeps messages that outlive their scope", "[message][arena]") {
+  GIVEN("Messages created in a scope and kept after it closes") {
+    std::vector<std::unique_ptr<Message<NumberData>>> kept;
+    {
+      MessageArena::Scope arena;
+      for (int i = 0; i < 5000; ++i) {
+        kept.push_back(create_message<NumberData>(i, NumberData{static_cast<double>(i)}));
+      }
+    }
+
+    WHEN("a later scope allocates") {
+      std::vector<std::unique_ptr<Message<NumberData>>> fresh;
+      {
+        MessageArena::Scope arena;
+        for (int i = 0; i < 100; ++i) fresh.push_back(create_message<NumberData>(i, NumberData{-1.0}));
+      }
+      THEN("the kept messages are untouched") {
+        for (int i = 0; i < 5000; ++i) {
+          REQUIRE(kept[i]->time == i);
+          REQUIRE(kept[i]->data.value == static_cast<double>(i));
+        }
+      }
+    }
+
+    WHEN("they are freed on another thread") {
+      std::thread([&] { kept.clear(); }).join();
+      THEN("the arena stays usable") {
+        MessageArena::Scope arena;
+        auto msg = create_message<NumberData>(7, NumberData{7.0});
+        REQUIRE(msg->data.value == 7.0);
+      }
+    }
+  }
+
+  GIVEN("Messages freed on another thread while their chunk is current") {
+    MessageArena::Scope arena;
+    std::vector<std::unique_ptr<Message<NumberData>>> msgs;
+    for (int i = 0; i < 10; ++i) msgs.push_back(create_message<NumberData>(i, NumberData{0.0}));
+    std::thread([&] { msgs.clear(); }).join();
+    auto msg = create_message<NumberData>(11, NumberData{11.0});
+    REQUIRE(MessageArena::owns(msg.get()));
+    REQUIRE(msg->data.value == 11.0);
+  }
+}
+
+SCENARIO("retain_message copies out of the arena", "[message][arena]") {
+  MessageArena::Scope arena;
+
+  auto num = create_message<NumberData>(3, NumberData{4.5});
+  auto kept = retain_message(*num);
+  REQUIRE_FALSE(MessageArena::owns(kept.get()));
+  REQUIRE(static_cast<const Message<NumberData>*>(kept.get())->data.value == 4.5);
+
+  auto vec = create_message<VectorNumberData>(5, VectorNumberData(std::vector<double>{1.0, 2.0, 3.0}));
+  auto kept_vec = retain_message(*vec);
+  const auto* typed = static_cast<const Message<VectorNumberData>*>(kept_vec.get());
+  REQUIRE_FALSE(MessageArena::owns(kept_vec.get()));
+  REQUIRE(typed->data.values != vec->data.values);
+  REQUIRE(*typed->data.values == std::vector<double>{1.0, 2.0, 3.0});
+  REQUIRE(typed->time == 5);
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/MessageBatch.h"
+#include "rtbot/Operator.h"
+
+using namespace rtbot;
+
+namespace {
+
+// Doubles its input column and forwards it as one MessageBatch.
+class ColumnDouble : public Operator {
+ public:
+  explicit ColumnDouble(std::string id) : Operator(std::move(id)) {
+    add_data_port<NumberData>();
+    add_output_port<NumberData>();
+    enable_value_queue(0);
+  }
+  std::string type_name() const override { return "ColumnDouble"; }
+
+ protected:
+  void process_data(bool debug) override {
+    batch_.clear();
+    drain_value_queue(0, batch_);
+    for (auto& v : batch_.values) v *= 2.0;
+    emit_output(0, batch_, debug);
+  }
+
+ private:
+  MessageBatch<NumberData> batch_;
+};
+
+// Value-mode sink so both child representations can be observed.
+class ValueSink : public Operator {
+ public:
+  explicit ValueSink(std::string id) : Operator(std::move(id)) {
+    add_data_port<NumberData>();
+    enable_value_queue(0);
+  }
+  std::string type_name() const override { return "ValueSink"; }
+
+ protected:
+  void process_data(bool) override {}
+};
+
+MessageBatch<NumberData> make_column(timestamp_t first, size_t n) {
+  MessageBatch<NumberData> batch;
+  for (size_t i = 0; i < n; ++i) batch.push_back(first + static_cast<timestamp_t>(i), static_cast<double>(i));
+  return batch;
+}
+
+}  // namespace
+
+SCENARIO("MessageBatch columns flow through receive, drain and emit", "[message_batch]") {
+  GIVEN("An operator feeding a message-queue and a value-mode child") {
+    auto op = std::make_shared<ColumnDouble>("double");
+    auto col = std::make_shared<Collector>("col", std::vector<std::string>{"number"});
+    auto sink = std::make_shared<ValueSink>("sink");
+    op->connect(col, 0, 0);
+    op->connect(sink, 0, 0);
+
+    WHEN("a batch is received as columns and executed") {
+      op->receive_data_columns(make_column(10, 50), 0);
+      REQUIRE(op->get_value_queue(0).size() == 50);
+      op->execute(true);
+
+      THEN("the collector gets one message per row") {
+        const auto& q = col->get_data_queue(0);
+        REQUIRE(q.size() == 50);
+        for (size_t i = 0; i < q.size(); ++i) {
+          auto* m = static_cast<const Message<NumberData>*>(q[i].get());
+          REQUIRE(m->time == 10 + static_cast<timestamp_t>(i));
+          REQUIRE(m->data.value == 2.0 * i);
+        }
+      }
+      THEN("the value-mode child gets the same rows as records") {
+        const auto& values = sink->get_value_queue(0);
+        REQUIRE(values.size() == 50);
+        REQUIRE(values[49].time == 59);
+        REQUIRE(values[49].value == 98.0);
+      }
+      THEN("debug mode mirrors the batch into the debug queue") {
+        REQUIRE(op->get_debug_output_queue(0).size() == 50);
+      }
+    }
+
+    WHEN("a message port receives columns") {
+      col->receive_data_columns(make_column(1, 3), 0);
+      THEN("they are materialized as messages") {
+        REQUIRE(col->get_data_queue(0).size() == 3);
+      }
+    }
+
+    WHEN("columns are out of order under debug") {
+      op->receive_data_columns(make_column(5, 2), 0, true);
+      THEN("receive_data_columns rejects them") {
+        REQUIRE_THROWS(op->receive_data_columns(make_column(5, 1), 0, true));
+      }
+    }
+
+    WHEN("the batch type does not match the port") {
+      MessageBatch<BooleanData> flags;
+      flags.push_back(1, 1.0);
+      THEN("receive_data_columns throws") { REQUIRE_THROWS(op->receive_data_columns(flags, 0)); }
+    }
+  }
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "rtbot/SpillStore.h"
+
+using namespace rtbot;
+
+namespace {
+
+std::vector<uint8_t> record(uint32_t seed, size_t size) {
+  std::vector<uint8_t> bytes(size);
+  for (size_t i = 0; i < size; ++i) bytes[i] = static_cast<uint8_t>(seed * 31 + i);
+  return bytes;
+}
+
+std::vector<uint8_t> read(const SpillStore& store, SpillStore::Handle h) {
+  const auto r = store.get(h);
+  return std::vector<uint8_t>(r.first, r.first + r.second);
+}
+
+void churn(SpillStore& store) {
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<size_t> size(0, 4096);
+  std::map<SpillStore::Handle, std::vector<uint8_t>> reference;
+  uint32_t seed = 0;
+
+  // Enough churn to pass the compaction threshold several times.
+  for (int step = 0; step < 6000; ++step) {
+    if (!reference.empty() && rng() % 2 == 0) {
+      auto it = reference.begin();
+      std::advance(it, rng() % reference.size());
+      store.erase(it->first);
+      reference.erase(it);
+    } else {
+      auto bytes = record(++seed, size(rng));
+      const auto h = store.put(bytes.data(), bytes.size());
+      REQUIRE(reference.count(h) == 0);
+      reference[h] = std::move(bytes);
+    }
+  }
+
+  REQUIRE(store.size() == reference.size());
+  size_t live = 0;
+  for (const auto& [h, bytes] : reference) {
+    REQUIRE(read(store, h) == bytes);
+    live += bytes.size();
+  }
+  REQUIRE(store.live_bytes() == live);
+  REQUIRE(store.mapped_bytes() <= 4 * live + (1 << 21));
+}
+
+}  // namespace
+
+SCENARIO("SpillStore keeps records across erases and compaction", "[SpillStore]") {
+  SECTION("In process memory") {
+    SpillStore store;
+    REQUIRE_FALSE(store.file_backed());
+    churn(store);
+  }
+
+  SECTION("In a memory-mapped file") {
+    const auto dir = std::filesystem::temp_directory_path().string();
+    SpillStore store(dir);
+    REQUIRE(store.file_backed());
+    churn(store);
+    store.clear();
+    REQUIRE(store.size() == 0);
+    REQUIRE(store.live_bytes() == 0);
+  }
+
+  SECTION("A directory that does not exist fails") {
+    REQUIRE_THROWS_AS(SpillStore("/nonexistent/rtbot/spill"), std::runtime_error);
+  }
+}
@@ -0,0 +1,198 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "rtbot/Buffer.h"
+#include "rtbot/Collector.h"
+#include "rtbot/Input.h"
+#include "rtbot/Output.h"
+#include "rtbot/RingQueue.h"
+#include "rtbot/ScalarQueue.h"
+
+using namespace rtbot;
+
+namespace {
+
+// Passes its scalar input through unchanged, reading the port in value mode.
+class ValueEcho : public Operator {
+ public:
+  explicit ValueEcho(std::string id) : Operator(std::move(id)) {
+    add_data_port<NumberData>();
+    add_output_port<NumberData>();
+    enable_value_queue(0);
+  }
+  std::string type_name() const override { return "ValueEcho"; }
+
+ protected:
+  void process_data(bool debug) override {
+    auto& q = get_value_queue(0);
+    while (!q.empty()) {
+      emit_value(0, q.front().time, q.front().value, debug);
+      q.pop_front();
+    }
+  }
+};
+
+class LastValueBuffer : public Buffer<NumberData> {
+ public:
+  LastValueBuffer(std::string id, size_t window) : Buffer<NumberData>(std::move(id), window) {}
+  std::string type_name() const override { return "LastValueBuffer"; }
+
+ protected:
+  std::vector<std::unique_ptr<Message<NumberData>>> process_message(const Message<NumberData>* msg) override {
+    std::vector<std::unique_ptr<Message<NumberData>>> out;
+    if (buffer_full()) out.push_back(create_message<NumberData>(msg->time, NumberData{sum()}));
+    return out;
+  }
+};
+
+}  // namespace
+
+SCENARIO("RingQueue behaves as a FIFO across wrap-around and growth", "[ring_queue]") {
+  RingQueue<int> q;
+  REQUIRE(q.empty());
+
+  // Interleave pushes and pops so head_ wraps several times before growing.
+  int next_in = 0;
+  int next_out = 0;
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 5; ++i) q.push_back(next_in++);
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(q.front() == next_out++);
+      q.pop_front();
+    }
+  }
+  REQUIRE(q.size() == static_cast<size_t>(next_in - next_out));
+  for (size_t i = 0; i < q.size(); ++i) {
+    REQUIRE(q[i] == next_out + static_cast<int>(i));
+  }
+
+  size_t cap = q.capacity();
+  REQUIRE((cap & (cap - 1)) == 0);
+  q.clear();
+  REQUIRE(q.empty());
+  REQUIRE(q.capacity() == cap);  // never shrinks
+}
+
+SCENARIO("RingQueue releases owned elements on pop", "[ring_queue]") {
+  RingQueue<std::unique_ptr<BaseMessage>> q;
+  auto msg = create_message<NumberData>(1, NumberData{1.0});
+  q.push_back(std::move(msg));
+  q.push_back(create_message<NumberData>(2, NumberData{2.0}));
+  REQUIRE(q.back()->time == 2);
+  q.pop_front();
+  REQUIRE(q.size() == 1);
+  REQUIRE(q.front()->time == 2);
+}
+
+SCENARIO("Operator::reserve_queues preallocates port queues", "[ring_queue]") {
+  auto echo = std::make_shared<ValueEcho>("echo");
+  auto col = make_number_collector("col");
+  echo->connect(col);
+  echo->reserve_queues(100);
+  col->reserve_queues(100);
+
+  REQUIRE(echo->queue_capacity() == 100);
+  REQUIRE(echo->get_value_queue(0).capacity() == 128);
+  REQUIRE(col->get_data_queue(0).capacity() == 128);
+
+  for (int i = 1; i <= 100; ++i) {
+    echo->receive_data(create_message<NumberData>(i, NumberData{1.0}), 0);
+  }
+  echo->execute(true);
+  REQUIRE(col->get_data_queue(0).size() == 100);
+  REQUIRE(col->get_data_queue(0).capacity() == 128);
+  REQUIRE(echo->get_debug_output_queue(0).capacity() == 128);
+}
+
+SCENARIO("Value-mode ports interoperate with message-mode neighbours", "[value_queue]") {
+  GIVEN("Input -> ValueEcho -> Collector") {
+    auto input = make_number_input("in");
+    auto echo = std::make_shared<ValueEcho>("echo");
+    auto col = make_number_collector("col");
+    input->connect(echo);
+    echo->connect(col);
+
+    WHEN("messages flow through") {
+      for (int i = 1; i <= 50; ++i) {
+        input->receive_data(create_message<NumberData>(i, NumberData{i * 0.5}), 0);
+      }
+      input->execute();
+
+      THEN("the value-mode hop is transparent") {
+        auto& out = col->get_data_queue(0);
+        REQUIRE(out.size() == 50);
+        for (int i = 0; i < 50; ++i) {
+          const auto* m = static_cast<const Message<NumberData>*>(out[i].get());
+          REQUIRE(m->time == i + 1);
+          REQUIRE(m->data.value == Approx((i + 1) * 0.5));
+        }
+        REQUIRE(echo->get_data_queue(0).empty());
+        REQUIRE(echo->get_value_queue(0).empty());
+      }
+    }
+  }
+
+  GIVEN("A value-mode port receiving through receive_data") {
+    auto echo = std::make_shared<ValueEcho>("echo");
+    echo->receive_data(create_message<NumberData>(3, NumberData{7.0}), 0);
+    THEN("the message is stored as a record") {
+      REQUIRE(echo->get_data_queue(0).empty());
+      REQUIRE(echo->get_value_queue(0).size() == 1);
+      REQUIRE(echo->get_value_queue(0).front().time == 3);
+      REQUIRE(echo->get_value_queue(0).front().value == 7.0);
+    }
+  }
+
+  GIVEN("A boolean Output port in value mode") {
+    auto out = make_boolean_output("out");
+    auto col = make_boolean_collector("col");
+    out->connect(col);
+    out->receive_data(create_message<BooleanData>(1, BooleanData{true}), 0);
+    out->receive_data(create_message<BooleanData>(2, BooleanData{false}), 0);
+    out->execute();
+    THEN("records are materialized back into BooleanData messages") {
+      auto& q = col->get_data_queue(0);
+      REQUIRE(q.size() == 2);
+      REQUIRE(static_cast<const Message<BooleanData>*>(q[0].get())->data.value);
+      REQUIRE_FALSE(static_cast<const Message<BooleanData>*>(q[1].get())->data.value);
+    }
+  }
+
+  GIVEN("A buffer holding undrained value records") {
+    auto buf = std::make_shared<LastValueBuffer>("buf", 3);
+    auto restored = std::make_shared<LastValueBuffer>("buf", 3);
+    buf->receive_data(create_message<NumberData>(1, NumberData{1.0}), 0);
+    buf->receive_data(create_message<NumberData>(2, NumberData{2.0}), 0);
+
+    THEN("state round-trips through collect/restore") {
+      Bytes bytes = buf->collect_bytes();
+      auto it = bytes.cbegin();
+      restored->restore(it);
+      REQUIRE(restored->get_value_queue(0).size() == 2);
+      REQUIRE(*restored == *buf);
+    }
+  }
+
+  GIVEN("An operator whose value port is already connected") {
+    THEN("enabling value mode is rejected") {
+      class LateOptIn : public Operator {
+       public:
+        explicit LateOptIn(std::string id) : Operator(std::move(id)) {
+          add_data_port<NumberData>();
+          add_output_port<NumberData>();
+        }
+        std::string type_name() const override { return "LateOptIn"; }
+        void opt_in() { enable_value_queue(0); }
+
+       protected:
+        void process_data(bool) override {}
+      };
+      auto input = make_number_input("in");
+      auto late = std::make_shared<LateOptIn>("late");
+      input->connect(late);
+      REQUIRE_THROWS(late->opt_in());
+    }
+  }
+}
@@ -0,0 +1,45 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "rtbot/WorkStealingPool.h"
+
+using namespace rtbot;
+
+SCENARIO("WorkStealingPool runs every task once", "[WorkStealingPool]") {
+  WorkStealingPool pool(4);
+  REQUIRE(pool.size() == 4);
+
+  for (size_t n : {size_t{0}, size_t{1}, size_t{3}, size_t{1000}}) {
+    std::vector<std::atomic<int>> runs(n);
+    pool.run(n, [&](size_t i) {
+      // Skewed costs: the first range is much slower, so the others steal.
+      if (i < n / 4) std::this_thread::sleep_for(std::chrono::microseconds(20));
+      runs[i].fetch_add(1);
+    });
+    for (size_t i = 0; i < n; ++i) REQUIRE(runs[i].load() == 1);
+  }
+}
+
+SCENARIO("WorkStealingPool rethrows a task's exception and stays usable", "[WorkStealingPool]") {
+  WorkStealingPool pool(3);
+  REQUIRE_THROWS_WITH(pool.run(100,
+                               [](size_t i) {
+                                 if (i == 42) throw std::runtime_error("task 42");
+                               }),
+                      "task 42");
+
+  std::atomic<size_t> sum{0};
+  pool.run(100, [&](size_t i) { sum += i; });
+  REQUIRE(sum.load() == 4950);
+}
+
+SCENARIO("A one-thread WorkStealingPool runs inline", "[WorkStealingPool]") {
+  WorkStealingPool pool(1);
+  std::vector<size_t> order;
+  pool.run(5, [&](size_t i) { order.push_back(i); });
+  REQUIRE(order == std::vector<size_t>{0, 1, 2, 3, 4});
+}
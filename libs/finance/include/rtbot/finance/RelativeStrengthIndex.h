@@ -30,6 +30,7 @@ class RelativeStrengthIndex : public Buffer<NumberData, RSIFeatures> {
         prev_average_loss_(0.0) {}
 
   std::string type_name() const override { return "RelativeStrengthIndex"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<RelativeStrengthIndex>(*this); }
 
   void reset() override {
     Buffer<NumberData, RSIFeatures>::reset();
@@ -70,6 +71,22 @@ class RelativeStrengthIndex : public Buffer<NumberData, RSIFeatures> {
   }
 
  protected:
+  void write_extra_state(ByteWriter& w) override {
+    w.write(initialized_);
+    w.write(average_gain_);
+    w.write(average_loss_);
+    w.write(prev_average_gain_);
+    w.write(prev_average_loss_);
+  }
+
+  void read_extra_state(ByteReader& r) override {
+    initialized_ = r.read<bool>();
+    average_gain_ = r.read<double>();
+    average_loss_ = r.read<double>();
+    prev_average_gain_ = r.read<double>();
+    prev_average_loss_ = r.read<double>();
+  }
+
   std::vector<std::unique_ptr<Message<NumberData>>> process_message(const Message<NumberData>* msg) override {
     // Only compute RSI when buffer is full
     if (!buffer_full()) {
@@ -76,6 +76,7 @@ class BurstAggregate : public Operator {
   }
 
   std::string type_name() const override { return "BurstAggregate"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<BurstAggregate>(*this); }
   std::size_t get_num_agg_outputs() const { return num_agg_outputs_; }
   std::size_t get_num_input_cols() const { return num_input_cols_; }
   const std::vector<std::size_t>& get_key_columns() const { return key_columns_; }
@@ -98,8 +99,7 @@ class BurstAggregate : public Operator {
     for (auto& msg : messages) {
       auto* vm = static_cast<Message<VectorNumberData>*>(msg.get());
       if (!vm) continue;
-      const auto& row = *vm->data.values;
-      process_row_(vm->time, row.data(), row.size(), debug);
+      process_vector_(vm->time, vm->data, debug);
     }
     messages.clear();
   }
@@ -129,13 +129,23 @@ class BurstAggregate : public Operator {
     auto& queue = get_data_queue(0);
     while (!queue.empty()) {
       auto* vm = static_cast<const Message<VectorNumberData>*>(queue.front().get());
-      const auto& row = *vm->data.values;
-      process_row_(vm->time, row.data(), row.size(), debug);
+      process_vector_(vm->time, vm->data, debug);
       queue.pop_front();
     }
   }
 
  private:
+  // Rows that are strided views are gathered once; everything else is read
+  // in place.
+  void process_vector_(timestamp_t time, const VectorNumberData& vec, bool debug) {
+    if (const double* row = vec.contiguous_data()) {
+      process_row_(time, row, vec.size(), debug);
+    } else {
+      const auto gathered = vec.materialize();
+      process_row_(time, gathered->data(), gathered->size(), debug);
+    }
+  }
+
   void process_row_(timestamp_t time, const double* row, std::size_t cols,
                     bool debug) {
     if (cols < num_input_cols_) {
@@ -97,6 +97,7 @@ class FusedExpression : public VectorCompose {
   }
 
   std::string type_name() const override { return "FusedExpression"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<FusedExpression>(*this); }
 
   size_t get_num_outputs() const { return num_outputs_; }
   // Decodes packed instructions back to the caller-facing double bytecode
@@ -81,6 +81,7 @@ class FusedExpressionVector : public Operator {
   }
 
   std::string type_name() const override { return "FusedExpressionVector"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<FusedExpressionVector>(*this); }
 
   size_t get_num_outputs() const { return num_outputs_; }
   std::vector<double> get_bytecode() const {
@@ -157,8 +158,9 @@ class FusedExpressionVector : public Operator {
         const auto* msg = static_cast<const Message<VectorNumberData>*>(
             input.front().get());
         timestamp_t time = msg->time;
-        const std::vector<double>& inputs = *msg->data.values;
-        if (inputs.size() < min_required_input_size_) {
+        const auto gathered = msg->data.contiguous_data() ? nullptr : msg->data.materialize();
+        const double* inputs = gathered ? gathered->data() : msg->data.contiguous_data();
+        if (msg->data.size() < min_required_input_size_) {
           throw std::runtime_error(
               "FusedExpressionVector INPUT index out of bounds");
         }
@@ -167,7 +169,7 @@ class FusedExpressionVector : public Operator {
             ins, ins_size, consts,
             aux_args_.empty() ? nullptr : aux_args_.data(),
             coefficients_.empty() ? nullptr : coefficients_.data(),
-            inputs.data(), state_.data(),
+            inputs, state_.data(),
             out_vec->data(), num_outputs_);
         if (emit) {
           emit_output(0,
@@ -190,7 +192,7 @@ class FusedExpressionVector : public Operator {
       while (lane < B && !input.empty()) {
         const auto* msg = static_cast<const Message<VectorNumberData>*>(
             input.front().get());
-        const std::vector<double>& values = *msg->data.values;
+        const VectorNumberData& values = msg->data;
         if (values.size() < min_required_input_size_) {
           throw std::runtime_error(
               "FusedExpressionVector INPUT index out of bounds");
@@ -0,0 +1,356 @@
+#ifndef RTBOT_FUSE_KEYED_FUSED_EXPRESSION_H
+#define RTBOT_FUSE_KEYED_FUSED_EXPRESSION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rtbot/ByteStream.h"
+#include "rtbot/KeyTable.h"
+#include "rtbot/Message.h"
+#include "rtbot/Operator.h"
+#include "rtbot/fuse/FusedBytecode.h"
+#include "rtbot/fuse/FusedScalarEval.h"
+#include "rtbot/fuse/FusedStateLayout.h"
+
+namespace rtbot {
+
+// Grouped fused expression: one FusedExpressionVector program, evaluated
+// with separate state for every value of a key column.
+//
+// Replaces the `KeyedPipeline → Pipeline → FusedExpressionVector` chain that
+// `GROUP BY key` with moving aggregates compiles to. Instead of a sub-graph
+// (operators, connections, collector) per key, every key owns one row of
+// `state_size` doubles in a single flat table; the row layout is the
+// program's FusedStateLayout, so the per-key footprint is just the state
+// the bytecode declares. A row costs a hash probe in the KeyTable plus one
+// evaluate_one() over the key's state row, with no message hop inside the
+// operator.
+//
+// Output shape matches KeyedPipeline in key_index mode over an equivalent
+// FusedExpressionVector: `[key, out_0, ..., out_{numOutputs-1}]`, stamped
+// with the input row's time, and nothing while a windowed opcode of that
+// key is still warming up. `INPUT k` reads column k of the full input row
+// (the key column included).
+class KeyedFusedExpression : public Operator {
+ public:
+  using NewKeyCallback = std::function<void(double)>;
+  using EvictKeyCallback = std::function<void(double)>;
+
+  KeyedFusedExpression(std::string id, int key_index, size_t num_outputs,
+                       std::vector<double> bytecode,
+                       std::vector<double> constants,
+                       std::vector<double> coefficients = {})
+      : Operator(std::move(id)),
+        key_index_(key_index),
+        num_outputs_(num_outputs),
+        constants_(std::move(constants)),
+        coefficients_(std::move(coefficients)) {
+    if (key_index < 0) {
+      throw std::runtime_error("KeyedFusedExpression key_index must be non-negative");
+    }
+    if (num_outputs_ < 1) {
+      throw std::runtime_error(
+          "KeyedFusedExpression requires at least 1 output expression");
+    }
+    auto pack = rtbot::fuse::pack_bytecode(bytecode);
+    packed_ = std::move(pack.packed);
+    aux_args_ = std::move(pack.aux_args);
+    auto layout = rtbot::fuse::compute_state_layout(packed_, aux_args_);
+    state_size_ = layout.total_state_size;
+    state_init_ = std::move(layout.initial_values);
+    state_init_.resize(state_size_, 0.0);
+
+    min_required_input_size_ = static_cast<size_t>(key_index_) + 1;
+    size_t end_count = 0;
+    for (const auto& i : packed_) {
+      if (i.op == static_cast<std::uint8_t>(fused_op::INPUT)) {
+        min_required_input_size_ = std::max(min_required_input_size_, static_cast<size_t>(i.arg) + 1);
+      } else if (i.op == static_cast<std::uint8_t>(fused_op::END)) {
+        ++end_count;
+      }
+    }
+    if (end_count != num_outputs_) {
+      throw std::runtime_error(
+          "KeyedFusedExpression bytecode has " + std::to_string(end_count) +
+          " END markers but num_outputs is " + std::to_string(num_outputs_));
+    }
+
+    add_data_port<VectorNumberData>();
+    add_output_port<VectorNumberData>();
+  }
+
+  std::string type_name() const override { return "KeyedFusedExpression"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<KeyedFusedExpression>(*this); }
+
+  int get_key_index() const { return key_index_; }
+  size_t get_num_outputs() const { return num_outputs_; }
+  std::vector<double> get_bytecode() const {
+    return rtbot::fuse::unpack_bytecode(packed_, aux_args_);
+  }
+  const std::vector<double>& get_constants() const { return constants_; }
+  const std::vector<double>& get_coefficients() const { return coefficients_; }
+
+  // Doubles of state each key owns.
+  size_t get_state_size() const { return state_size_; }
+  size_t num_keys() const { return keys_.size(); }
+  bool has_key(double key) const { return keys_.find(key) != KeyTable<KeyRow>::npos; }
+
+  // The key's state row (get_state_size() doubles), or nullptr for a key
+  // that has not been seen or was evicted.
+  const double* key_state(double key) const {
+    const Slot s = keys_.find(key);
+    return s == KeyTable<KeyRow>::npos ? nullptr : states_.data() + s * state_size_;
+  }
+
+  void set_new_key_callback(NewKeyCallback cb) { new_key_callback_ = std::move(cb); }
+  void set_evict_key_callback(EvictKeyCallback cb) { evict_key_callback_ = std::move(cb); }
+
+  // Bounded key state, as in KeyedPipeline::set_eviction: `max_keys` caps
+  // the live keys (least recently used goes first), `idle_ttl` evicts a key
+  // once a row arrives more than idle_ttl after the key last saw one. 0
+  // disables either. An evicted key that reappears starts from fresh state.
+  void set_eviction(size_t max_keys, timestamp_t idle_ttl) {
+    if (idle_ttl < 0) {
+      throw std::runtime_error("KeyedFusedExpression idle_ttl must be non-negative");
+    }
+    max_keys_ = max_keys;
+    idle_ttl_ = idle_ttl;
+    evict_();
+  }
+  size_t get_max_keys() const { return max_keys_; }
+  timestamp_t get_idle_ttl() const { return idle_ttl_; }
+  uint64_t num_evicted() const { return num_evicted_; }
+
+  void reset() override {
+    Operator::reset();
+    keys_.clear();
+    states_.clear();
+  }
+
+  // Raw-buffer entry point: rows are read in place, with no Message per
+  // input row.
+  void receive_data_buffer(const double* data, size_t num_rows,
+                           size_t num_cols, const timestamp_t* times,
+                           size_t port_index, bool debug) override {
+    (void)port_index;
+    mark_state_dirty();
+    for (size_t r = 0; r < num_rows; ++r) {
+      process_row_(times[r], data + r * num_cols, num_cols, debug);
+    }
+  }
+
+  // Key section after the base port bytes: its length, then the same
+  // encoding as write_state.
+  Bytes collect_bytes() override {
+    Bytes bytes = Operator::collect_bytes();
+    Bytes keys;
+    ByteWriter w(keys);
+    write_keys_(w);
+    const size_t n = keys.size();
+    bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&n),
+                 reinterpret_cast<const uint8_t*>(&n) + sizeof(n));
+    bytes.insert(bytes.end(), keys.begin(), keys.end());
+    return bytes;
+  }
+
+  void restore(Bytes::const_iterator& it) override {
+    Operator::restore(it);
+    size_t n;
+    std::memcpy(&n, &(*it), sizeof(n));
+    it += sizeof(n);
+    ByteReader r(&(*it), n);
+    read_keys_(r);
+    it += n;
+  }
+
+  void write_state(ByteWriter& w) override {
+    write_ports(w);
+    write_keys_(w);
+  }
+
+  void read_state(ByteReader& r) override {
+    read_ports(r);
+    read_keys_(r);
+  }
+
+  bool equals(const KeyedFusedExpression& other) const {
+    if (key_index_ != other.key_index_ || num_outputs_ != other.num_outputs_) return false;
+    if (packed_.size() != other.packed_.size()) return false;
+    for (std::size_t k = 0; k < packed_.size(); ++k) {
+      if (packed_[k].op != other.packed_[k].op ||
+          packed_[k].flags != other.packed_[k].flags ||
+          packed_[k].arg != other.packed_[k].arg) {
+        return false;
+      }
+    }
+    if (constants_ != other.constants_ || coefficients_ != other.coefficients_) return false;
+    if (max_keys_ != other.max_keys_ || idle_ttl_ != other.idle_ttl_) return false;
+    if (keys_.size() != other.keys_.size()) return false;
+
+    bool same = true;
+    keys_.for_each([&](Slot s) {
+      if (!same) return;
+      const Slot o = other.keys_.find(keys_.key(s));
+      same = o != KeyTable<KeyRow>::npos &&
+             std::equal(states_.begin() + s * state_size_, states_.begin() + (s + 1) * state_size_,
+                        other.states_.begin() + o * state_size_);
+    });
+    return same && Operator::equals(other);
+  }
+
+  bool operator==(const KeyedFusedExpression& other) const { return equals(other); }
+  bool operator!=(const KeyedFusedExpression& other) const { return !(*this == other); }
+
+ protected:
+  void process_data(bool debug = false) override {
+    auto& input = get_data_queue(0);
+    while (!input.empty()) {
+      const auto* msg = static_cast<const Message<VectorNumberData>*>(input.front().get());
+      if (const double* row = msg->data.contiguous_data()) {
+        process_row_(msg->time, row, msg->data.size(), debug);
+      } else {
+        const auto gathered = msg->data.materialize();
+        process_row_(msg->time, gathered->data(), gathered->size(), debug);
+      }
+      input.pop_front();
+    }
+  }
+
+ private:
+  // Per-key state lives in states_, in the row of the key's slot; the
+  // table itself only holds keys and recency.
+  struct KeyRow {};
+  using Slot = KeyTable<KeyRow>::Slot;
+
+  void process_row_(timestamp_t time, const double* row, size_t cols, bool debug) {
+    if (cols < min_required_input_size_) {
+      throw std::runtime_error("KeyedFusedExpression row has " + std::to_string(cols) +
+                               " columns but needs " + std::to_string(min_required_input_size_));
+    }
+    const double key = row[key_index_];
+    const Slot s = route_(key, time);
+
+    auto out_vec = make_pooled_vector_double(num_outputs_ + 1);
+    const bool emit = rtbot::fuse::evaluate_one(
+        packed_.data(), packed_.size(),
+        constants_.empty() ? nullptr : constants_.data(),
+        aux_args_.empty() ? nullptr : aux_args_.data(),
+        coefficients_.empty() ? nullptr : coefficients_.data(),
+        row, states_.data() + s * state_size_,
+        out_vec->data() + 1, num_outputs_);
+    if (emit) {
+      (*out_vec)[0] = key;
+      emit_output(0, create_message<VectorNumberData>(time, VectorNumberData(std::move(out_vec))), debug);
+    }
+  }
+
+  // The key's slot for a row at `time`, after idle and cap eviction. A new
+  // key's state row starts from the layout's initial values.
+  Slot route_(double key, timestamp_t time) {
+    if (idle_ttl_ > 0) evict_idle_(time);
+    const auto [s, inserted] = keys_.insert(key);
+    if (inserted) {
+      init_row_(s);
+      if (new_key_callback_) new_key_callback_(key);
+    }
+    keys_.touch(s, time);
+    if (max_keys_ > 0 && keys_.size() > max_keys_) evict_();
+    return s;
+  }
+
+  // Slots are dense and reused, so the table never holds more rows than
+  // the most keys live at once.
+  void init_row_(Slot s) {
+    const size_t end = (static_cast<size_t>(s) + 1) * state_size_;
+    if (states_.size() < end) states_.resize(end);
+    std::copy(state_init_.begin(), state_init_.end(), states_.begin() + s * state_size_);
+  }
+
+  void evict_key_(Slot s) {
+    const double key = keys_.key(s);
+    keys_.erase(s);
+    ++num_evicted_;
+    if (evict_key_callback_) evict_key_callback_(key);
+  }
+
+  // The recency list is in arrival order, so the walk stops at the first
+  // key still live.
+  void evict_idle_(timestamp_t now) {
+    for (Slot s = keys_.oldest(); s != KeyTable<KeyRow>::npos && now - keys_.last_seen(s) > idle_ttl_;
+         s = keys_.oldest()) {
+      evict_key_(s);
+    }
+  }
+
+  void evict_() {
+    while (max_keys_ > 0 && keys_.size() > max_keys_) evict_key_(keys_.oldest());
+  }
+
+  // Least recently used first, so reading back rebuilds the recency order.
+  void write_keys_(ByteWriter& w) const {
+    w.write_size(keys_.size());
+    w.write_size(state_size_);
+    w.reserve(keys_.size() * (sizeof(double) + sizeof(timestamp_t) + state_size_ * sizeof(double)));
+    keys_.for_each([&](Slot s) {
+      w.write(keys_.key(s));
+      w.write(keys_.last_seen(s));
+      w.write_array(states_.data() + s * state_size_, state_size_);
+    });
+  }
+
+  void read_keys_(ByteReader& r) {
+    const size_t key_count = r.read_size();
+    if (r.read_size() != state_size_) {
+      throw std::runtime_error("KeyedFusedExpression state size does not match the program");
+    }
+    keys_.clear();
+    states_.clear();
+    for (size_t k = 0; k < key_count; ++k) {
+      const double key = r.read<double>();
+      const auto seen = r.read<timestamp_t>();
+      const Slot s = keys_.insert(key).first;
+      init_row_(s);
+      r.read_array(states_.data() + s * state_size_, state_size_);
+      keys_.touch(s, seen);
+    }
+  }
+
+  int key_index_;
+  size_t num_outputs_;
+  std::vector<double> constants_;
+  std::vector<double> coefficients_;
+  std::vector<rtbot::fuse::Instruction> packed_;
+  std::vector<rtbot::fuse::AuxArgs> aux_args_;
+  size_t state_size_{0};
+  std::vector<double> state_init_;
+  size_t min_required_input_size_{0};
+
+  KeyTable<KeyRow> keys_;
+  std::vector<double> states_;  // keys_ slot s owns [s * state_size_, (s + 1) * state_size_)
+
+  size_t max_keys_{0};
+  timestamp_t idle_ttl_{0};
+  uint64_t num_evicted_{0};
+  NewKeyCallback new_key_callback_;
+  EvictKeyCallback evict_key_callback_;
+};
+
+inline std::shared_ptr<KeyedFusedExpression> make_keyed_fused_expression(
+    std::string id, int key_index, size_t num_outputs,
+    std::vector<double> bytecode, std::vector<double> constants,
+    std::vector<double> coefficients = {}) {
+  return std::make_shared<KeyedFusedExpression>(
+      std::move(id), key_index, num_outputs, std::move(bytecode),
+      std::move(constants), std::move(coefficients));
+}
+
+}  // namespace rtbot
+
+#endif  // RTBOT_FUSE_KEYED_FUSED_EXPRESSION_H
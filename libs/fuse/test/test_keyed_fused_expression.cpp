@@ -0,0 +1,204 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/OperatorJson.h"
+#include "rtbot/fuse/KeyedFusedExpression.h"
+
+using namespace rtbot;
+using namespace fused_op;
+
+namespace {
+
+// MA(col 1, window 3) and CUMSUM(col 1) + col 2: a windowed opcode with a
+// warmup, next to a manually placed accumulator.
+const std::vector<double> kProgram = {INPUT, 1, MA_UPDATE, 3, END, INPUT, 1, CUMSUM, 0, INPUT, 2, ADD, END};
+
+const char* kKeyedPipelineJson = R"({
+  "type": "KeyedPipeline", "id": "kp", "key_index": 0,
+  "prototype": {
+    "operators": [
+      {"type": "FusedExpressionVector", "id": "fev", "numOutputs": 2,
+       "bytecode": [0, 1, 35, 3, 20, 0, 1, 21, 0, 0, 2, 2, 20]}
+    ],
+    "connections": [],
+    "entry": {"operator": "fev"},
+    "output": {"operator": "fev"}
+  }
+})";
+
+struct Row {
+  timestamp_t time;
+  std::vector<double> values;
+};
+
+std::vector<Row> make_rows(size_t n, size_t keys, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> key(0, keys - 1);
+  std::uniform_real_distribution<double> value(-10.0, 10.0);
+  std::vector<Row> rows;
+  for (size_t i = 0; i < n; ++i) {
+    rows.push_back({static_cast<timestamp_t>(i + 1), {static_cast<double>(key(rng)), value(rng), value(rng)}});
+  }
+  return rows;
+}
+
+// Sends the rows one execute() per row and returns the emitted (time, values...).
+std::vector<double> run(Operator& op, Collector& sink, const std::vector<Row>& rows) {
+  std::vector<double> out;
+  for (const auto& row : rows) {
+    op.receive_data(create_message<VectorNumberData>(row.time, VectorNumberData(row.values)), 0);
+    op.execute();
+  }
+  for (const auto& msg : sink.get_data_queue(0)) {
+    const auto* vec = static_cast<const Message<VectorNumberData>*>(msg.get());
+    out.push_back(static_cast<double>(vec->time));
+    for (size_t i = 0; i < vec->data.size(); ++i) out.push_back(vec->data[i]);
+  }
+  sink.get_data_queue(0).clear();
+  return out;
+}
+
+std::shared_ptr<Collector> sink_for(Operator& op) {
+  auto sink = make_vector_number_collector("sink");
+  op.connect(sink, 0, 0);
+  return sink;
+}
+
+}  // namespace
+
+SCENARIO("KeyedFusedExpression matches KeyedPipeline over FusedExpressionVector", "[keyed_fused_expression]") {
+  const auto rows = make_rows(3000, 40, 7);
+
+  auto keyed = OperatorJson::read_op(kKeyedPipelineJson);
+  auto keyed_sink = sink_for(*keyed);
+  const auto expected = run(*keyed, *keyed_sink, rows);
+
+  auto kfe = make_keyed_fused_expression("kfe", 0, 2, kProgram, {});
+  auto sink = sink_for(*kfe);
+
+  THEN("Every key gets only the program's state") {
+    // CUMSUM at 0..1, then the MA ring (3) + sum, compensation and count.
+    REQUIRE(kfe->get_state_size() == 2 + 3 + 3);
+  }
+
+  THEN("The output stream is identical, warmup rows included") {
+    REQUIRE(run(*kfe, *sink, rows) == expected);
+    REQUIRE(kfe->num_keys() == 40);
+    REQUIRE(kfe->has_key(3.0));
+    REQUIRE_FALSE(kfe->has_key(40.0));
+  }
+
+  THEN("Raw buffers give the same outputs") {
+    std::vector<double> data;
+    std::vector<timestamp_t> times;
+    for (const auto& row : rows) {
+      data.insert(data.end(), row.values.begin(), row.values.end());
+      times.push_back(row.time);
+    }
+    kfe->receive_data_buffer(data.data(), rows.size(), 3, times.data(), 0, false);
+    REQUIRE(run(*kfe, *sink, {}) == expected);
+  }
+}
+
+SCENARIO("KeyedFusedExpression snapshots per-key state", "[keyed_fused_expression]") {
+  const auto rows = make_rows(2000, 25, 11);
+  const std::vector<Row> first(rows.begin(), rows.begin() + 1000);
+  const std::vector<Row> second(rows.begin() + 1000, rows.end());
+
+  auto kfe = make_keyed_fused_expression("kfe", 0, 2, kProgram, {});
+  auto sink = sink_for(*kfe);
+  run(*kfe, *sink, first);
+
+  THEN("A binary snapshot restores equal state and the same outputs") {
+    Bytes bytes;
+    ByteWriter w(bytes);
+    kfe->write_state(w);
+
+    auto restored = make_keyed_fused_expression("kfe", 0, 2, kProgram, {});
+    ByteReader r(bytes);
+    restored->read_state(r);
+    REQUIRE(r.at_end());
+    REQUIRE(*restored == *kfe);
+
+    auto restored_sink = sink_for(*restored);
+    REQUIRE(run(*restored, *restored_sink, second) == run(*kfe, *sink, second));
+  }
+
+  THEN("collect() and restore_data_from_json round trip") {
+    auto restored = make_keyed_fused_expression("kfe", 0, 2, kProgram, {});
+    restored->restore_data_from_json(kfe->collect());
+    REQUIRE(*restored == *kfe);
+  }
+
+  THEN("A program with a different state size is rejected") {
+    Bytes bytes;
+    ByteWriter w(bytes);
+    kfe->write_state(w);
+    auto other = make_keyed_fused_expression("kfe", 0, 1, {INPUT, 1, MA_UPDATE, 9, END}, {});
+    ByteReader r(bytes);
+    REQUIRE_THROWS_AS(other->read_state(r), std::runtime_error);
+  }
+
+  THEN("reset() drops every key") {
+    kfe->reset();
+    REQUIRE(kfe->num_keys() == 0);
+    REQUIRE(kfe->key_state(0.0) == nullptr);
+  }
+}
+
+SCENARIO("KeyedFusedExpression evicts keys", "[keyed_fused_expression]") {
+  auto kfe = make_keyed_fused_expression("kfe", 0, 1, {INPUT, 1, CUMSUM, 0, END}, {});
+  auto sink = sink_for(*kfe);
+  std::vector<double> evicted;
+  kfe->set_evict_key_callback([&](double key) { evicted.push_back(key); });
+
+  WHEN("The key cap is reached") {
+    kfe->set_eviction(2, 0);
+    const auto out = run(*kfe, *sink, {{1, {1.0, 5.0, 0.0}}, {2, {2.0, 1.0, 0.0}}, {3, {1.0, 5.0, 0.0}},
+                                       {4, {3.0, 2.0, 0.0}}, {5, {2.0, 1.0, 0.0}}});
+
+    THEN("The least recently used key goes and comes back fresh") {
+      REQUIRE(evicted == std::vector<double>{2.0, 1.0});
+      REQUIRE(out == std::vector<double>{1, 1, 5, 2, 2, 1, 3, 1, 10, 4, 3, 2, 5, 2, 1});
+      REQUIRE(kfe->num_keys() == 2);
+      REQUIRE(kfe->num_evicted() == 2);
+      REQUIRE_FALSE(kfe->has_key(1.0));
+    }
+  }
+
+  WHEN("Keys go idle") {
+    kfe->set_eviction(0, 10);
+    run(*kfe, *sink, {{1, {1.0, 1.0, 0.0}}, {5, {2.0, 1.0, 0.0}}, {12, {2.0, 1.0, 0.0}}});
+
+    THEN("Only keys idle for more than idleTtl are evicted") {
+      REQUIRE(evicted == std::vector<double>{1.0});
+      REQUIRE(kfe->key_state(2.0)[0] == 2.0);
+    }
+  }
+}
+
+SCENARIO("KeyedFusedExpression JSON and validation", "[keyed_fused_expression]") {
+  auto original = make_keyed_fused_expression("kfe_json", 2, 2, kProgram, {});
+  original->set_eviction(1000, 60);
+  auto restored = OperatorJson::read_op(OperatorJson::write_op(original));
+  auto* kfe = dynamic_cast<KeyedFusedExpression*>(restored.get());
+  REQUIRE(kfe != nullptr);
+  REQUIRE(kfe->get_key_index() == 2);
+  REQUIRE(kfe->get_num_outputs() == 2);
+  REQUIRE(kfe->get_bytecode() == kProgram);
+  REQUIRE(kfe->get_max_keys() == 1000);
+  REQUIRE(kfe->get_idle_ttl() == 60);
+  REQUIRE(*kfe == *original);
+
+  REQUIRE_THROWS_AS(make_keyed_fused_expression("bad", -1, 1, {INPUT, 1, END}, {}), std::runtime_error);
+  REQUIRE_THROWS_AS(make_keyed_fused_expression("bad", 0, 2, {INPUT, 1, END}, {}), std::runtime_error);
+
+  auto short_rows = make_keyed_fused_expression("short", 0, 1, {INPUT, 3, END}, {});
+  short_rows->receive_data(create_message<VectorNumberData>(1, VectorNumberData({1.0, 2.0})), 0);
+  REQUIRE_THROWS_AS(short_rows->execute(), std::runtime_error);
+}
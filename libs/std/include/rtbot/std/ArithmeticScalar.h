@@ -17,6 +17,7 @@ class ArithmeticScalar : public Operator {
     // Add single input and output port for numeric data
     add_data_port<NumberData>();
     add_output_port<NumberData>();
+    enable_value_queue(0);
   }
 
   virtual ~ArithmeticScalar() = default;
@@ -24,41 +25,33 @@ class ArithmeticScalar : public Operator {
   // Pure virtual method that derived classes must implement
   virtual double apply(double value) const = 0;
 
+  // Columnar kernel: out[i] = apply(in[i]). Concrete operators override it
+  // with map_values so the loop calls apply() non-virtually and can inline
+  // (and vectorize) it.
+  virtual void apply_batch(const double* in, double* out, size_t n) const {
+    for (size_t i = 0; i < n; ++i) out[i] = apply(in[i]);
+  }
+
   bool equals(const ArithmeticScalar& other) const {
     return Operator::equals(other);
   }
 
  protected:
   void process_data(bool debug=false) override {
-    auto& input_queue = get_data_queue(0);
-    if (input_queue.empty()) return;
-    if (input_queue.size() >= kEmitBatchThreshold) {
-      std::vector<std::unique_ptr<BaseMessage>> batch;
-      batch.reserve(input_queue.size());
-      while (!input_queue.empty()) {
-        const auto* msg = static_cast<const Message<NumberData>*>(input_queue.front().get());
-        if (!msg) {
-          throw std::runtime_error("Invalid message type in ArithmeticScalar");
-        }
-
-        // Apply the mathematical operation and create output message
-        batch.push_back(create_message<NumberData>(msg->time, NumberData{apply(msg->data.value)}));
-        input_queue.pop_front();
-      }
-      emit_output(0, std::move(batch), debug);
-    } else {
-      while (!input_queue.empty()) {
-        const auto* msg = static_cast<const Message<NumberData>*>(input_queue.front().get());
-        if (!msg) {
-          throw std::runtime_error("Invalid message type in ArithmeticScalar");
-        }
-
-        // Apply the mathematical operation and create output message
-        emit_output(0, create_message<NumberData>(msg->time, NumberData{apply(msg->data.value)}), debug);
-        input_queue.pop_front();
-      }
-    }
+    if (get_value_queue(0).empty()) return;
+    batch_.clear();
+    drain_value_queue(0, batch_);
+    apply_batch(batch_.values.data(), batch_.values.data(), batch_.size());
+    emit_output(0, batch_, debug);
+  }
+
+  template <typename Self>
+  static void map_values(const Self& self, const double* in, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = self.Self::apply(in[i]);
   }
+
+ private:
+  MessageBatch<NumberData> batch_;  // scratch, reused across calls
 };
 
 // Concrete implementations for various mathematical operations
@@ -66,7 +59,9 @@ class Add : public ArithmeticScalar {
  public:
   Add(std::string id, double value) : ArithmeticScalar(std::move(id)), value_(value) {}
   std::string type_name() const override { return "Add"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Add>(*this); }
   double apply(double x) const override { return x + value_; }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
 
   bool equals(const Add& other) const {
@@ -89,7 +84,9 @@ class Scale : public ArithmeticScalar {
  public:
   Scale(std::string id, double value) : ArithmeticScalar(std::move(id)), value_(value) {}
   std::string type_name() const override { return "Scale"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Scale>(*this); }
   double apply(double x) const override { return x * value_; }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
 
   bool equals(const Scale& other) const {
@@ -112,7 +109,9 @@ class Power : public ArithmeticScalar {
  public:
   Power(std::string id, double value) : ArithmeticScalar(std::move(id)), value_(value) {}
   std::string type_name() const override { return "Power"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Power>(*this); }
   double apply(double x) const override { return std::pow(x, value_); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
 
   bool equals(const Power& other) const {
@@ -136,6 +135,7 @@ class Sin : public ArithmeticScalar {
  public:
   Sin(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Sin"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Sin>(*this); }
 
   bool equals(const Sin& other) const {
     return ArithmeticScalar::equals(other);
@@ -150,12 +150,14 @@ class Sin : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::sin(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 class Cos : public ArithmeticScalar {
  public:
   Cos(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Cos"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Cos>(*this); }
 
   bool equals(const Cos& other) const {
     return ArithmeticScalar::equals(other);
@@ -170,12 +172,14 @@ class Cos : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::cos(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 class Tan : public ArithmeticScalar {
  public:
   Tan(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Tan"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Tan>(*this); }
 
   bool equals(const Tan& other) const {
     return ArithmeticScalar::equals(other);
@@ -190,6 +194,7 @@ class Tan : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::tan(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 // Exponential and logarithmic functions
@@ -197,6 +202,7 @@ class Exp : public ArithmeticScalar {
  public:
   Exp(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Exp"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Exp>(*this); }
 
   bool equals(const Exp& other) const {
     return ArithmeticScalar::equals(other);
@@ -211,12 +217,14 @@ class Exp : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::exp(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 class Log : public ArithmeticScalar {
  public:
   Log(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Log"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Log>(*this); }
 
   bool equals(const Log& other) const {
     return ArithmeticScalar::equals(other);
@@ -231,12 +239,14 @@ class Log : public ArithmeticScalar {
   }
   
   double apply(double x) const override { return std::log(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 class Log10 : public ArithmeticScalar {
  public:
   Log10(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Log10"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Log10>(*this); }
 
   bool equals(const Log10& other) const {
     return ArithmeticScalar::equals(other);
@@ -251,6 +261,7 @@ class Log10 : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::log10(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 // Absolute value and sign functions
@@ -258,6 +269,7 @@ class Abs : public ArithmeticScalar {
  public:
   Abs(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Abs"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Abs>(*this); }
 
   bool equals(const Abs& other) const {
     return ArithmeticScalar::equals(other);
@@ -272,12 +284,14 @@ class Abs : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::abs(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 class Sign : public ArithmeticScalar {
  public:
   Sign(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Sign"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Sign>(*this); }
 
   bool equals(const Sign& other) const {
     return ArithmeticScalar::equals(other);
@@ -292,6 +306,7 @@ class Sign : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return x > 0 ? 1.0 : (x < 0 ? -1.0 : 0.0); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 // Rounding functions
@@ -299,6 +314,7 @@ class Floor : public ArithmeticScalar {
  public:
   Floor(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Floor"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Floor>(*this); }
 
   bool equals(const Floor& other) const {
     return ArithmeticScalar::equals(other);
@@ -313,12 +329,14 @@ class Floor : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::floor(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 class Ceil : public ArithmeticScalar {
  public:
   Ceil(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Ceil"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Ceil>(*this); }
 
   bool equals(const Ceil& other) const {
     return ArithmeticScalar::equals(other);
@@ -333,12 +351,14 @@ class Ceil : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::ceil(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 class Round : public ArithmeticScalar {
  public:
   Round(std::string id) : ArithmeticScalar(std::move(id)) {}
   std::string type_name() const override { return "Round"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Round>(*this); }
 
   bool equals(const Round& other) const {
     return ArithmeticScalar::equals(other);
@@ -353,6 +373,7 @@ class Round : public ArithmeticScalar {
   }
 
   double apply(double x) const override { return std::round(x); }
+  void apply_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
 };
 
 // Factory functions
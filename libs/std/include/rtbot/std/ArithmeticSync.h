@@ -32,6 +32,7 @@ class Addition : public ArithmeticSync<NumberData> {
       : ArithmeticSync<NumberData>(std::move(id), num_ports, NumberData{0.0}) {}
   ~Addition() noexcept = default;
   std::string type_name() const override { return "Addition"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Addition>(*this); }
 
   bool equals(const Addition& other) const {
     return ArithmeticSync::equals(other);
@@ -57,6 +58,7 @@ class Subtraction : public ArithmeticSync<NumberData> {
       : ArithmeticSync<NumberData>(std::move(id), num_ports) {}
   ~Subtraction() noexcept = default;
   std::string type_name() const override { return "Subtraction"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Subtraction>(*this); }
 
   bool equals(const Subtraction& other) const {
     return ArithmeticSync::equals(other);
@@ -87,6 +89,7 @@ class Multiplication : public ArithmeticSync<NumberData> {
       : ArithmeticSync<NumberData>(std::move(id), num_ports, NumberData{1.0}) {}
   ~Multiplication() noexcept = default;
   std::string type_name() const override { return "Multiplication"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Multiplication>(*this); }
 
   bool equals(const Multiplication& other) const {
     return ArithmeticSync::equals(other);
@@ -112,6 +115,7 @@ class Division : public ArithmeticSync<NumberData> {
       : ArithmeticSync<NumberData>(std::move(id), num_ports) {}
   ~Division() noexcept = default;
   std::string type_name() const override { return "Division"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Division>(*this); }
 
   bool equals(const Division& other) const {
     return ArithmeticSync::equals(other);
@@ -35,6 +35,7 @@ class LogicalAnd : public BooleanSync {
       : BooleanSync(std::move(id), num_ports, true) {}
   ~LogicalAnd() noexcept = default;
   std::string type_name() const override { return "LogicalAnd"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LogicalAnd>(*this); }
 
   bool equals(const LogicalAnd& other) const {
     return BooleanSync::equals(other);
@@ -60,6 +61,7 @@ class LogicalOr : public BooleanSync {
       : BooleanSync(std::move(id), num_ports, false) {}
   ~LogicalOr() noexcept = default;
   std::string type_name() const override { return "LogicalOr"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LogicalOr>(*this); }
 
   bool equals(const LogicalOr& other) const {
     return BooleanSync::equals(other);
@@ -85,6 +87,7 @@ class LogicalXor : public BooleanSync {
       : BooleanSync(std::move(id), num_ports) {}
   ~LogicalXor() noexcept = default;
   std::string type_name() const override { return "LogicalXor"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LogicalXor>(*this); }
 
   bool equals(const LogicalXor& other) const {
     return BooleanSync::equals(other);
@@ -110,6 +113,7 @@ class LogicalNand : public BooleanSync {
       : BooleanSync(std::move(id), num_ports, true) {}
   ~LogicalNand() noexcept = default;
   std::string type_name() const override { return "LogicalNand"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LogicalNand>(*this); }
 
   bool equals(const LogicalNand& other) const {
     return BooleanSync::equals(other);
@@ -136,6 +140,7 @@ class LogicalNor : public BooleanSync {
       : BooleanSync(std::move(id), num_ports, true) {}
   ~LogicalNor() noexcept = default;
   std::string type_name() const override { return "LogicalNor"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LogicalNor>(*this); }
 
   bool equals(const LogicalNor& other) const {
     return BooleanSync::equals(other);
@@ -161,6 +166,7 @@ class LogicalXnor : public BooleanSync {
       : BooleanSync(std::move(id), num_ports) {}
   ~LogicalXnor() noexcept = default;
   std::string type_name() const override { return "LogicalXnor"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LogicalXnor>(*this); }
 
   bool equals(const LogicalXnor& other) const {
     return BooleanSync::equals(other);
@@ -186,6 +192,7 @@ class LogicalImplication : public BooleanSync {
       : BooleanSync(std::move(id), num_ports, true) {}
   ~LogicalImplication() noexcept = default;
   std::string type_name() const override { return "LogicalImplication"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LogicalImplication>(*this); }
 
   bool equals(const LogicalImplication& other) const {
     return BooleanSync::equals(other);
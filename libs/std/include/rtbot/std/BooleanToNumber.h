@@ -16,6 +16,7 @@ class BooleanToNumber : public Operator {
   }
 
   std::string type_name() const override { return "BooleanToNumber"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<BooleanToNumber>(*this); }
 
   bool equals(const BooleanToNumber& other) const {
     return Operator::equals(other);
@@ -15,52 +15,52 @@ class CompareScalar : public Operator {
   CompareScalar(std::string id) : Operator(std::move(id)) {
     add_data_port<NumberData>();
     add_output_port<BooleanData>();
+    enable_value_queue(0);
   }
 
   virtual ~CompareScalar() = default;
 
   virtual bool evaluate(double value) const = 0;
 
+  // Columnar kernel: out[i] = evaluate(in[i]) as 0.0 / 1.0. Concrete
+  // comparisons override it with map_values to inline evaluate().
+  virtual void evaluate_batch(const double* in, double* out, size_t n) const {
+    for (size_t i = 0; i < n; ++i) out[i] = evaluate(in[i]) ? 1.0 : 0.0;
+  }
+
   bool equals(const CompareScalar& other) const {
     return Operator::equals(other);
   }
 
  protected:
   void process_data(bool debug = false) override {
-    auto& input_queue = get_data_queue(0);
-    if (input_queue.empty()) return;
-    if (input_queue.size() >= kEmitBatchThreshold) {
-      std::vector<std::unique_ptr<BaseMessage>> batch;
-      batch.reserve(input_queue.size());
-      while (!input_queue.empty()) {
-        const auto* msg = static_cast<const Message<NumberData>*>(input_queue.front().get());
-        if (!msg) {
-          throw std::runtime_error("Invalid message type in CompareScalar");
-        }
-        batch.push_back(
-            create_message<BooleanData>(msg->time, BooleanData{evaluate(msg->data.value)}));
-        input_queue.pop_front();
-      }
-      emit_output(0, std::move(batch), debug);
-    } else {
-      while (!input_queue.empty()) {
-        const auto* msg = static_cast<const Message<NumberData>*>(input_queue.front().get());
-        if (!msg) {
-          throw std::runtime_error("Invalid message type in CompareScalar");
-        }
-        emit_output(0,
-            create_message<BooleanData>(msg->time, BooleanData{evaluate(msg->data.value)}), debug);
-        input_queue.pop_front();
-      }
-    }
+    if (get_value_queue(0).empty()) return;
+    in_batch_.clear();
+    drain_value_queue(0, in_batch_);
+    out_batch_.times.swap(in_batch_.times);
+    out_batch_.values.resize(out_batch_.times.size());
+    evaluate_batch(in_batch_.values.data(), out_batch_.values.data(), out_batch_.size());
+    emit_output(0, out_batch_, debug);
+  }
+
+  template <typename Self>
+  static void map_values(const Self& self, const double* in, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = self.Self::evaluate(in[i]) ? 1.0 : 0.0;
   }
+
+ private:
+  // Scratch columns, reused across calls.
+  MessageBatch<NumberData> in_batch_;
+  MessageBatch<BooleanData> out_batch_;
 };
 
 class CompareGT : public CompareScalar {
  public:
   CompareGT(std::string id, double value) : CompareScalar(std::move(id)), value_(value) {}
   std::string type_name() const override { return "CompareGT"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareGT>(*this); }
   bool evaluate(double x) const override { return x > value_; }
+  void evaluate_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
 
   bool equals(const CompareGT& other) const {
@@ -78,7 +78,9 @@ class CompareLT : public CompareScalar {
  public:
   CompareLT(std::string id, double value) : CompareScalar(std::move(id)), value_(value) {}
   std::string type_name() const override { return "CompareLT"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareLT>(*this); }
   bool evaluate(double x) const override { return x < value_; }
+  void evaluate_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
 
   bool equals(const CompareLT& other) const {
@@ -96,7 +98,9 @@ class CompareGTE : public CompareScalar {
  public:
   CompareGTE(std::string id, double value) : CompareScalar(std::move(id)), value_(value) {}
   std::string type_name() const override { return "CompareGTE"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareGTE>(*this); }
   bool evaluate(double x) const override { return x >= value_; }
+  void evaluate_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
 
   bool equals(const CompareGTE& other) const {
@@ -114,7 +118,9 @@ class CompareLTE : public CompareScalar {
  public:
   CompareLTE(std::string id, double value) : CompareScalar(std::move(id)), value_(value) {}
   std::string type_name() const override { return "CompareLTE"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareLTE>(*this); }
   bool evaluate(double x) const override { return x <= value_; }
+  void evaluate_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
 
   bool equals(const CompareLTE& other) const {
@@ -133,7 +139,9 @@ class CompareEQ : public CompareScalar {
   CompareEQ(std::string id, double value, double tolerance = 0.0)
       : CompareScalar(std::move(id)), value_(value), tolerance_(tolerance) {}
   std::string type_name() const override { return "CompareEQ"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareEQ>(*this); }
   bool evaluate(double x) const override { return std::abs(x - value_) <= tolerance_; }
+  void evaluate_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
   double get_tolerance() const { return tolerance_; }
 
@@ -155,7 +163,9 @@ class CompareNEQ : public CompareScalar {
   CompareNEQ(std::string id, double value, double tolerance = 0.0)
       : CompareScalar(std::move(id)), value_(value), tolerance_(tolerance) {}
   std::string type_name() const override { return "CompareNEQ"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareNEQ>(*this); }
   bool evaluate(double x) const override { return std::abs(x - value_) > tolerance_; }
+  void evaluate_batch(const double* in, double* out, size_t n) const override { map_values(*this, in, out, n); }
   double get_value() const { return value_; }
   double get_tolerance() const { return tolerance_; }
 
@@ -70,6 +70,7 @@ class CompareSyncGT : public CompareSync {
   explicit CompareSyncGT(std::string id)
       : CompareSync(std::move(id)) {}
   std::string type_name() const override { return "CompareSyncGT"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareSyncGT>(*this); }
   bool evaluate(double lhs, double rhs) const override { return lhs > rhs; }
 
   bool equals(const CompareSyncGT& other) const { return CompareSync::equals(other); }
@@ -82,6 +83,7 @@ class CompareSyncLT : public CompareSync {
   explicit CompareSyncLT(std::string id)
       : CompareSync(std::move(id)) {}
   std::string type_name() const override { return "CompareSyncLT"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareSyncLT>(*this); }
   bool evaluate(double lhs, double rhs) const override { return lhs < rhs; }
 
   bool equals(const CompareSyncLT& other) const { return CompareSync::equals(other); }
@@ -94,6 +96,7 @@ class CompareSyncGTE : public CompareSync {
   explicit CompareSyncGTE(std::string id)
       : CompareSync(std::move(id)) {}
   std::string type_name() const override { return "CompareSyncGTE"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareSyncGTE>(*this); }
   bool evaluate(double lhs, double rhs) const override { return lhs >= rhs; }
 
   bool equals(const CompareSyncGTE& other) const { return CompareSync::equals(other); }
@@ -106,6 +109,7 @@ class CompareSyncLTE : public CompareSync {
   explicit CompareSyncLTE(std::string id)
       : CompareSync(std::move(id)) {}
   std::string type_name() const override { return "CompareSyncLTE"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareSyncLTE>(*this); }
   bool evaluate(double lhs, double rhs) const override { return lhs <= rhs; }
 
   bool equals(const CompareSyncLTE& other) const { return CompareSync::equals(other); }
@@ -118,6 +122,7 @@ class CompareSyncEQ : public CompareSync {
   explicit CompareSyncEQ(std::string id, double tolerance = 0.0)
       : CompareSync(std::move(id)), tolerance_(tolerance) {}
   std::string type_name() const override { return "CompareSyncEQ"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareSyncEQ>(*this); }
   bool evaluate(double lhs, double rhs) const override {
     return std::abs(lhs - rhs) <= tolerance_;
   }
@@ -140,6 +145,7 @@ class CompareSyncNEQ : public CompareSync {
   explicit CompareSyncNEQ(std::string id, double tolerance = 0.0)
       : CompareSync(std::move(id)), tolerance_(tolerance) {}
   std::string type_name() const override { return "CompareSyncNEQ"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CompareSyncNEQ>(*this); }
   bool evaluate(double lhs, double rhs) const override {
     return std::abs(lhs - rhs) > tolerance_;
   }
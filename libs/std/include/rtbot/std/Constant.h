@@ -17,6 +17,7 @@ class Constant : public Operator {
   }
 
   std::string type_name() const override { return "Constant"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Constant>(*this); }
 
   // Accessor for the constant value
   const OutputT& get_value() const { return value_; }
@@ -23,6 +23,7 @@ class Count : public Operator {
   }
 
   std::string type_name() const override { return "Count"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Count>(*this); }
 
   bool equals(const Count& other) const {
     return (count_ == other.count_ && Operator::equals(other));
@@ -86,12 +87,14 @@ class CountNumber : public Count<NumberData> {
  public:
   explicit CountNumber(std::string id) : Count<NumberData>(std::move(id)) {}
   std::string type_name() const override { return "CountNumber"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CountNumber>(*this); }
 };
 
 class CountBoolean : public Count<BooleanData> {
  public:
   explicit CountBoolean(std::string id) : Count<BooleanData>(std::move(id)) {}
   std::string type_name() const override { return "CountBoolean"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CountBoolean>(*this); }
 };
 
 // Factory function for Count
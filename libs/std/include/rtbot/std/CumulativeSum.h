@@ -14,6 +14,7 @@ class CumulativeSum : public Operator {
     // Add single input and output port for NumberData
     add_data_port<NumberData>();
     add_output_port<NumberData>();
+    enable_value_queue(0);
   }
 
   void reset() override {
@@ -23,6 +24,7 @@ class CumulativeSum : public Operator {
   }
 
   std::string type_name() const override { return "CumulativeSum"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<CumulativeSum>(*this); }
 
   // Access current sum
   double get_sum() const { return sum_; }
@@ -61,51 +63,27 @@ class CumulativeSum : public Operator {
 
  protected:
   void process_data(bool debug=false) override {
-    auto& input_queue = get_data_queue(0);
-    if (input_queue.empty()) return;
-    if (input_queue.size() >= kEmitBatchThreshold) {
-      std::vector<std::unique_ptr<BaseMessage>> batch;
-      batch.reserve(input_queue.size());
-      while (!input_queue.empty()) {
-        const auto* msg = static_cast<const Message<NumberData>*>(input_queue.front().get());
-        if (!msg) {
-          throw std::runtime_error("Invalid message type in CumulativeSum");
-        }
-
-        // Kahan-compensated addition: keeps drift at O(1·ε) instead of O(N·ε)
-        // for this unbounded cumulative sum.
-        double y = msg->data.value - sum_comp_;
-        double t = sum_ + y;
-        sum_comp_ = (t - sum_) - y;
-        sum_ = t;
-        batch.push_back(create_message<NumberData>(msg->time, NumberData{sum_}));
-
-        input_queue.pop_front();
-      }
-      emit_output(0, std::move(batch), debug);
-    } else {
-      while (!input_queue.empty()) {
-        const auto* msg = static_cast<const Message<NumberData>*>(input_queue.front().get());
-        if (!msg) {
-          throw std::runtime_error("Invalid message type in CumulativeSum");
-        }
-
-        // Kahan-compensated addition: keeps drift at O(1·ε) instead of O(N·ε)
-        // for this unbounded cumulative sum.
-        double y = msg->data.value - sum_comp_;
-        double t = sum_ + y;
-        sum_comp_ = (t - sum_) - y;
-        sum_ = t;
-        emit_output(0, create_message<NumberData>(msg->time, NumberData{sum_}), debug);
-
-        input_queue.pop_front();
-      }
+    if (get_value_queue(0).empty()) return;
+    batch_.clear();
+    drain_value_queue(0, batch_);
+    // Prefix sum in place over the value column. Kahan-compensated addition
+    // keeps drift at O(1·ε) instead of O(N·ε) for this unbounded sum.
+    double* values = batch_.values.data();
+    const size_t n = batch_.size();
+    for (size_t i = 0; i < n; ++i) {
+      double y = values[i] - sum_comp_;
+      double t = sum_ + y;
+      sum_comp_ = (t - sum_) - y;
+      sum_ = t;
+      values[i] = sum_;
     }
+    emit_output(0, batch_, debug);
   }
 
  private:
   double sum_;       // Running sum
   double sum_comp_;  // Kahan compensation term
+  MessageBatch<NumberData> batch_;  // scratch, reused across calls
 };
 
 // Factory function for CumulativeSum
@@ -19,6 +19,7 @@ class Difference : public Buffer<NumberData, DifferenceFeatures> {
       : Buffer<NumberData, DifferenceFeatures>(std::move(id), 2), use_oldest_time_(use_oldest_time) {}
 
   std::string type_name() const override { return "Difference"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Difference>(*this); }
 
   bool get_use_oldest_time() const { return use_oldest_time_; }
 
@@ -51,6 +52,12 @@ class Difference : public Buffer<NumberData, DifferenceFeatures> {
     return output;
   }
 
+  void process_record(timestamp_t /*time*/, MessageBatch<NumberData>& out) override {
+    if (!buffer_full()) return;
+    const auto& points = buffer();
+    out.push_back(use_oldest_time_ ? points[1]->time : points[0]->time, points[1]->data.value - points[0]->data.value);
+  }
+
  private:
   bool use_oldest_time_;
 };
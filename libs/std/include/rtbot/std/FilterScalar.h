@@ -4,6 +4,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rtbot/Message.h"
 #include "rtbot/Operator.h"
@@ -16,6 +17,7 @@ class FilterScalar : public Operator {
     // Add single input and output port for numeric data
     add_data_port<NumberData>();
     add_output_port<NumberData>();
+    enable_value_queue(0);
   }
 
   virtual ~FilterScalar() = default;
@@ -23,35 +25,44 @@ class FilterScalar : public Operator {
   // Pure virtual method that derived classes must implement
   virtual bool evaluate(double value) const = 0;
 
+  // Columnar kernel: keep[i] = evaluate(in[i]) as 0.0 / 1.0. Concrete
+  // filters override it with map_values to inline evaluate().
+  virtual void evaluate_batch(const double* in, double* keep, size_t n) const {
+    for (size_t i = 0; i < n; ++i) keep[i] = evaluate(in[i]) ? 1.0 : 0.0;
+  }
+
   bool equals(const FilterScalar& other) const {
     return Operator::equals(other);
   }
 
  protected:
   void process_data(bool debug=false) override {
-    auto& input_queue = get_data_queue(0);
-    if (input_queue.empty()) return;
-    if (input_queue.size() >= kEmitBatchThreshold) {
-      std::vector<std::unique_ptr<BaseMessage>> batch;
-      batch.reserve(input_queue.size());
-      while (!input_queue.empty()) {
-        const auto* msg = static_cast<const Message<NumberData>*>(input_queue.front().get());
-        if (evaluate(msg->data.value)) {
-          batch.push_back(std::move(input_queue.front()));
-        }
-        input_queue.pop_front();
-      }
-      emit_output(0, std::move(batch), debug);
-    } else {
-      while (!input_queue.empty()) {
-        const auto* msg = static_cast<const Message<NumberData>*>(input_queue.front().get());
-        if (evaluate(msg->data.value)) {
-          emit_output(0, std::move(input_queue.front()), debug);
-        }
-        input_queue.pop_front();
-      }
+    if (get_value_queue(0).empty()) return;
+    batch_.clear();
+    drain_value_queue(0, batch_);
+    const size_t n = batch_.size();
+    keep_.resize(n);
+    evaluate_batch(batch_.values.data(), keep_.data(), n);
+    // Compact the kept rows in place.
+    size_t kept = 0;
+    for (size_t i = 0; i < n; ++i) {
+      batch_.times[kept] = batch_.times[i];
+      batch_.values[kept] = batch_.values[i];
+      kept += keep_[i] != 0.0;
     }
+    batch_.resize(kept);
+    emit_output(0, batch_, debug);
+  }
+
+  template <typename Self>
+  static void map_values(const Self& self, const double* in, double* keep, size_t n) {
+    for (size_t i = 0; i < n; ++i) keep[i] = self.Self::evaluate(in[i]) ? 1.0 : 0.0;
   }
+
+ private:
+  // Scratch, reused across calls.
+  MessageBatch<NumberData> batch_;
+  std::vector<double> keep_;
 };
 
 // Concrete implementations for various filter operations
@@ -59,7 +70,9 @@ class LessThan : public FilterScalar {
  public:
   LessThan(std::string id, double threshold) : FilterScalar(std::move(id)), threshold_(threshold) {}
   std::string type_name() const override { return "LessThan"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LessThan>(*this); }
   bool evaluate(double x) const override { return x < threshold_; }
+  void evaluate_batch(const double* in, double* keep, size_t n) const override { map_values(*this, in, keep, n); }
   double get_threshold() const { return threshold_; }
 
   bool equals(const LessThan& other) const {
@@ -82,7 +95,9 @@ class GreaterThan : public FilterScalar {
  public:
   GreaterThan(std::string id, double threshold) : FilterScalar(std::move(id)), threshold_(threshold) {}
   std::string type_name() const override { return "GreaterThan"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<GreaterThan>(*this); }
   bool evaluate(double x) const override { return x > threshold_; }
+  void evaluate_batch(const double* in, double* keep, size_t n) const override { map_values(*this, in, keep, n); }
   double get_threshold() const { return threshold_; }
 
   bool equals(const GreaterThan& other) const {
@@ -107,7 +122,9 @@ class EqualTo : public FilterScalar {
       : FilterScalar(std::move(id)), value_(value), epsilon_(epsilon) {}
 
   std::string type_name() const override { return "EqualTo"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<EqualTo>(*this); }
   bool evaluate(double x) const override { return std::abs(x - value_) <= epsilon_; }
+  void evaluate_batch(const double* in, double* keep, size_t n) const override { map_values(*this, in, keep, n); }
   double get_value() const { return value_; }
   double get_epsilon() const { return epsilon_; }
 
@@ -136,7 +153,9 @@ class NotEqualTo : public FilterScalar {
       : FilterScalar(std::move(id)), value_(value), epsilon_(epsilon) {}
 
   std::string type_name() const override { return "NotEqualTo"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<NotEqualTo>(*this); }
   bool evaluate(double x) const override { return std::abs(x - value_) > epsilon_; }
+  void evaluate_batch(const double* in, double* keep, size_t n) const override { map_values(*this, in, keep, n); }
   double get_value() const { return value_; }
   double get_epsilon() const { return epsilon_; }
 
@@ -25,6 +25,7 @@ class SyncGreaterThan : public FilterSync<NumberData> {
       : FilterSync<NumberData>(std::move(id), num_ports) {}
 
   std::string type_name() const override { return "SyncGreaterThan"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<SyncGreaterThan>(*this); }
 
   bool filter_condition(const NumberData& first, const NumberData& acc) const override {
     return first.value > acc.value;
@@ -37,6 +38,7 @@ class SyncLessThan : public FilterSync<NumberData> {
       : FilterSync<NumberData>(std::move(id), num_ports) {}
 
   std::string type_name() const override { return "SyncLessThan"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<SyncLessThan>(*this); }
 
   bool filter_condition(const NumberData& first, const NumberData& acc) const override {
     return first.value < acc.value;
@@ -53,6 +55,7 @@ class SyncEqual : public FilterSync<NumberData> {
   }
 
   std::string type_name() const override { return "SyncEqual"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<SyncEqual>(*this); }
 
   bool filter_condition(const NumberData& first, const NumberData& acc) const override {
     return std::abs(first.value - acc.value) < epsilon_;
@@ -74,6 +77,7 @@ class SyncNotEqual : public FilterSync<NumberData> {
   }
 
   std::string type_name() const override { return "SyncNotEqual"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<SyncNotEqual>(*this); }
 
   bool filter_condition(const NumberData& first, const NumberData& acc) const override {
     return std::abs(first.value - acc.value) >= epsilon_;
@@ -25,6 +25,7 @@ class FiniteImpulseResponse : public Buffer<NumberData, FIRFeatures> {
   }
 
   std::string type_name() const override { return "FiniteImpulseResponse"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<FiniteImpulseResponse>(*this); }
 
   const std::vector<double>& get_coefficients() const { return coeffs_; }
 
@@ -31,6 +31,7 @@ class Function : public Operator {
   }
 
   std::string type_name() const override { return "Function"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Function>(*this); }
 
   const std::vector<std::pair<double, double>>& get_points() const { return points_; }
   InterpolationType get_interpolation_type() const { return type_; }
@@ -16,6 +16,7 @@ class Identity : public Operator {
   }
 
   std::string type_name() const override { return "Identity"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Identity>(*this); }
 
   bool equals(const Identity& other) const {
     return Operator::equals(other);
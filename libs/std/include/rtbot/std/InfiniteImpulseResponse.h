@@ -29,6 +29,7 @@ class InfiniteImpulseResponse : public Operator {
   }
 
   std::string type_name() const override { return "InfiniteImpulseResponse"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<InfiniteImpulseResponse>(*this); }
 
   std::vector<double> get_a_coeffs() const { return a_; }
   std::vector<double> get_b_coeffs() const { return b_; }
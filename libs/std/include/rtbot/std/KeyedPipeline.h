@@ -1,16 +1,21 @@
 #ifndef KEYED_PIPELINE_H
 #define KEYED_PIPELINE_H
 
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <typeinfo>
 #include <vector>
 
 #include "rtbot/Collector.h"
+#include "rtbot/KeyTable.h"
 #include "rtbot/Message.h"
 #include "rtbot/Operator.h"
+#include "rtbot/SpillStore.h"
+#include "rtbot/WorkStealingPool.h"
 
 namespace rtbot {
 
@@ -19,12 +24,94 @@ struct SubGraph {
   std::shared_ptr<Operator> entry;
   std::shared_ptr<Operator> output;
   std::shared_ptr<Collector> collector;
+  // Checkpoint tracking: touched since the last checkpoint, and the last
+  // checkpoint epoch at which it had been touched. Touched keys are always
+  // the most recent end of KeyedPipeline's recency list.
+  bool dirty{false};
+  uint64_t modified_epoch{0};
+  // Parallel mode: indices of this key's rows in the batch being processed.
+  std::vector<size_t> batch_rows;
+  // Cold tier: the spilled record holding the operator states while the
+  // key is out of the hot set (operators, entry, output and collector are
+  // then empty).
+  SpillStore::Handle cold{SpillStore::npos};
+};
+
+// A sub-graph definition compiled once and stamped out for every new key.
+// Operators are kept as unconnected templates and copied with clone();
+// connections are stored as resolved indices and ports. An operator that
+// cannot be cloned is built by its fallback instead (OperatorJson passes
+// one that re-reads the operator's JSON).
+class SubGraphPrototype {
+ public:
+  using OperatorBuilder = std::function<std::shared_ptr<Operator>()>;
+
+  void add_operator(std::shared_ptr<Operator> op, OperatorBuilder fallback) {
+    if (index_.count(op->id()) != 0) {
+      throw std::runtime_error("KeyedPipeline prototype has duplicate operator " + op->id());
+    }
+    auto probe = op->clone();
+    const bool cloneable = probe && typeid(*probe) == typeid(*op);
+    if (!cloneable && !fallback) {
+      throw std::runtime_error("KeyedPipeline prototype operator " + op->id() + " cannot be cloned");
+    }
+    index_[op->id()] = templates_.size();
+    templates_.push_back({std::move(op), cloneable ? OperatorBuilder{} : std::move(fallback)});
+  }
+
+  void add_connection(const std::string& from, const std::string& to, size_t from_port, size_t to_port,
+                      PortKind to_kind) {
+    connections_.push_back({find(from), find(to), from_port, to_port, to_kind});
+  }
+
+  void set_entry(const std::string& op_id) { entry_ = find(op_id); }
+  void set_output(const std::string& op_id) { output_ = find(op_id); }
+
+  SubGraph instantiate() const {
+    std::vector<std::shared_ptr<Operator>> ops;
+    ops.reserve(templates_.size());
+    for (const auto& t : templates_) ops.push_back(t.fallback ? t.fallback() : t.op->clone());
+    for (const auto& c : connections_) ops[c.from]->connect(ops[c.to], c.from_port, c.to_port, c.to_kind);
+    SubGraph sg;
+    for (const auto& op : ops) sg.operators.emplace_hint(sg.operators.end(), op->id(), op);
+    sg.entry = ops[entry_];
+    sg.output = ops[output_];
+    return sg;
+  }
+
+ private:
+  struct Template {
+    std::shared_ptr<Operator> op;
+    OperatorBuilder fallback;  // empty when op->clone() is used
+  };
+  struct Edge {
+    size_t from;
+    size_t to;
+    size_t from_port;
+    size_t to_port;
+    PortKind to_kind;
+  };
+
+  size_t find(const std::string& op_id) const {
+    auto it = index_.find(op_id);
+    if (it == index_.end()) {
+      throw std::runtime_error("KeyedPipeline prototype has no operator " + op_id);
+    }
+    return it->second;
+  }
+
+  std::vector<Template> templates_;
+  std::map<std::string, size_t> index_;
+  std::vector<Edge> connections_;
+  size_t entry_{0};
+  size_t output_{0};
 };
 
 class KeyedPipeline : public Operator {
  public:
   using SubGraphFactory = std::function<SubGraph()>;
   using NewKeyCallback = std::function<void(double)>;
+  using EvictKeyCallback = std::function<void(double)>;
 
   // Old constructor: key is read from input vector at key_index.
   // Output = [key, prototype_output...] (key prepended).
@@ -75,12 +162,71 @@ class KeyedPipeline : public Operator {
   const std::vector<int>& get_key_column_indices() const { return key_column_indices_; }
   bool has_computed_key() const { return !key_column_indices_.empty(); }
   size_t num_keys() const { return sub_graphs_.size(); }
+  bool has_key(double key) const { return sub_graphs_.find(key) != KeyTable<SubGraph>::npos; }
 
   void set_new_key_callback(NewKeyCallback cb) { new_key_callback_ = std::move(cb); }
+  void set_evict_key_callback(EvictKeyCallback cb) { evict_key_callback_ = std::move(cb); }
+
+  // Bounded key state. `max_keys` caps the number of live sub-graphs: a new
+  // key beyond the cap evicts the least recently used one. `idle_ttl`, in
+  // event time, evicts a key once a message arrives more than idle_ttl after
+  // the key last saw one. 0 disables either; both can be combined.
+  void set_eviction(size_t max_keys, timestamp_t idle_ttl) {
+    if (idle_ttl < 0) {
+      throw std::runtime_error("KeyedPipeline idle_ttl must be non-negative");
+    }
+    max_keys_ = max_keys;
+    idle_ttl_ = idle_ttl;
+    evict_();
+  }
+  size_t get_max_keys() const { return max_keys_; }
+  timestamp_t get_idle_ttl() const { return idle_ttl_; }
+  uint64_t num_evicted() const { return num_evicted_; }
+
+  // Opt-in parallel execution. With threads > 1, a burst of queued rows is
+  // partitioned by key and the per-key sub-graphs run on a work-stealing
+  // pool of that many threads (the caller included); rows of one key stay
+  // in order on one thread. Outputs are emitted in input order, identical
+  // to serial mode. Key lookup, creation, eviction and the callbacks stay on
+  // the calling thread. 0 or 1 is serial.
+  void set_threads(size_t threads) {
+    pool_ = threads > 1 ? std::make_unique<WorkStealingPool>(threads) : nullptr;
+  }
+  size_t get_threads() const { return pool_ ? pool_->size() : 1; }
+
+  // Cold-key tier. Only the `hot_keys` most recently used keys keep live
+  // sub-graphs; older ones are serialized with write_state into a
+  // SpillStore (a memory-mapped scratch file in `dir`, or process memory
+  // when `dir` is empty) and read back transparently on their next row.
+  // Spilled keys still count for eviction and are part of every snapshot.
+  // 0 keeps every key hot.
+  void set_spill(size_t hot_keys, std::string dir = "") {
+    auto store = hot_keys > 0 ? std::make_unique<SpillStore>(std::move(dir)) : nullptr;
+    sub_graphs_.for_each([this](Slot s) {
+      if (sub_graphs_.value(s).cold != SpillStore::npos) rehydrate_(s);
+    });
+    spill_ = std::move(store);
+    hot_keys_ = hot_keys;
+    hot_count_ = sub_graphs_.size();
+    coldest_hot_ = sub_graphs_.oldest();
+    enforce_hot_set_();
+  }
+  size_t get_hot_keys() const { return hot_keys_; }
+  std::string get_spill_dir() const { return spill_ ? spill_->dir() : std::string(); }
+  size_t num_hot_keys() const { return hot_count_; }
+  size_t num_cold_keys() const { return sub_graphs_.size() - hot_count_; }
+  const SpillStore* spill_store() const { return spill_.get(); }
+
+  struct SpillStats {
+    uint64_t hits{0};    // rows whose key was in the hot set
+    uint64_t misses{0};  // rows whose key was read back from the spill store
+    uint64_t spills{0};  // sub-graphs written out to the spill store
+  };
+  const SpillStats& spill_stats() const { return spill_stats_; }
 
   void reset() override {
     Operator::reset();
-    sub_graphs_.clear();
+    clear_keys_();
   }
 
 
@@ -92,14 +238,19 @@ class KeyedPipeline : public Operator {
 
     // Nested content: each key maps to its sub-graph operators
     nlohmann::json content;
-    for (const auto& [key, sg] : sub_graphs_) {
+    nlohmann::json last_seen;
+    sub_graphs_.for_each([&](Slot s) {
       nlohmann::json key_ops;
-      for (const auto& [op_id, op] : sg.operators) {
-        key_ops[op_id] = op->collect();
-      }
-      content[std::to_string(key)] = key_ops;
-    }
+      with_subgraph_(s, [&](const SubGraph& sg) {
+        for (const auto& [op_id, op] : sg.operators) key_ops[op_id] = op->collect();
+      });
+      const std::string key_str = std::to_string(sub_graphs_.key(s));
+      content[key_str] = key_ops;
+      last_seen[key_str] = sub_graphs_.last_seen(s);
+    });
     result["content"] = content;
+    // Only eviction depends on when keys were last seen.
+    if (evicting_()) result["lastSeen"] = last_seen;
 
     return result;
   }
@@ -110,15 +261,108 @@ class KeyedPipeline : public Operator {
     auto it = bytes.cbegin();
     Operator::restore(it);
 
-    // Restore sub-graphs from "content"
+    // Restore sub-graphs from "content", oldest "lastSeen" first so the
+    // recency order survives.
     const auto& content = j.at("content");
-    sub_graphs_.clear();
+    std::vector<std::pair<timestamp_t, std::string>> order;
     for (auto& [key_str, key_ops] : content.items()) {
-      double key = std::stod(key_str);
-      auto& sg = get_or_create_subgraph_(key);
-      for (auto& [op_id, op] : sg.operators) {
-        op->restore_data_from_json(key_ops.at(op_id));
+      const timestamp_t seen =
+          j.contains("lastSeen") ? j["lastSeen"].value(key_str, timestamp_t{0}) : timestamp_t{0};
+      order.emplace_back(seen, key_str);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    clear_keys_();
+    for (const auto& [seen, key_str] : order) {
+      const Slot s = create_subgraph_(std::stod(key_str));
+      for (auto& [op_id, op] : sub_graphs_.value(s).operators) {
+        op->restore_data_from_json(content.at(key_str).at(op_id));
       }
+      touch_(s, seen);
+    }
+  }
+
+  // Every sub-graph is built from the same prototype, so the operator ids are
+  // written once and each key contributes only its double key, the event
+  // time it was last seen and its states. Keys go out least recently used
+  // first, so reading them back rebuilds the recency order. A spilled key's
+  // record already is its states and is copied as is.
+  void write_state(ByteWriter& w) override {
+    write_ports(w);
+    std::vector<Slot> slots;
+    slots.reserve(sub_graphs_.size());
+    sub_graphs_.for_each([&](Slot s) { slots.push_back(s); });
+    write_keys_(w, slots, [&w](Operator& op) { op.write_state(w); }, true);
+  }
+
+  void read_state(ByteReader& r) override {
+    read_ports(r);
+    clear_keys_();
+    read_keys_(r, [&r](Operator& op) { op.read_state(r); });
+  }
+
+  // Only the keys touched since `since_epoch`, each with the deltas of its
+  // operators, after the keys evicted since the last checkpoint. reset(),
+  // and evictions in an epoch after `since_epoch` but before the current
+  // one, make the delta carry the full state instead.
+  void write_delta(ByteWriter& w, uint64_t since_epoch) override {
+    const bool full = keys_reset_ || reset_epoch_ > since_epoch || evict_epoch_ > since_epoch;
+    w.write<uint8_t>(full ? 0 : 1);
+    if (full) {
+      write_state(w);
+      return;
+    }
+    write_ports(w);
+    w.write_size(removed_keys_.size());
+    for (double key : removed_keys_) w.write(key);
+
+    std::vector<Slot> changed;
+    if (since_epoch == checkpoint_epoch()) {
+      // Touched keys are the newest dirty_count_ entries of the recency list.
+      Slot s = sub_graphs_.newest();
+      for (size_t n = 0; n < dirty_count_; ++n, s = sub_graphs_.older(s)) changed.push_back(s);
+      std::reverse(changed.begin(), changed.end());
+    } else {
+      sub_graphs_.for_each([&](Slot s) {
+        const auto& sg = sub_graphs_.value(s);
+        if (sg.dirty || sg.modified_epoch > since_epoch) changed.push_back(s);
+      });
+    }
+    write_keys_(w, changed, [&w, since_epoch](Operator& op) { op.write_delta(w, since_epoch); }, false);
+  }
+
+  void read_delta(ByteReader& r) override {
+    if (r.read<uint8_t>() == 0) {
+      read_state(r);
+      return;
+    }
+    read_ports(r);
+    const size_t removed = r.read_size();
+    for (size_t k = 0; k < removed; ++k) {
+      const Slot s = sub_graphs_.find(r.read<double>());
+      if (s != KeyTable<SubGraph>::npos) erase_key_(s);
+    }
+    read_keys_(r, [&r](Operator& op) { op.read_delta(r); });
+  }
+
+  void mark_checkpoint(uint64_t epoch) override {
+    Operator::mark_checkpoint(epoch);
+    if (keys_reset_) {
+      reset_epoch_ = epoch;
+      keys_reset_ = false;
+    }
+    if (!removed_keys_.empty()) {
+      evict_epoch_ = epoch;
+      removed_keys_.clear();
+    }
+    Slot s = sub_graphs_.newest();
+    for (; dirty_count_ > 0; --dirty_count_, s = sub_graphs_.older(s)) {
+      auto& sg = sub_graphs_.value(s);
+      sg.dirty = false;
+      sg.modified_epoch = epoch;
+      // A spilled key comes back through read_state, so its next delta is a
+      // full one regardless.
+      for (auto& entry : sg.operators) entry.second->mark_checkpoint(epoch);
     }
   }
 
@@ -126,21 +370,35 @@ class KeyedPipeline : public Operator {
     if (key_index_ != other.key_index_) return false;
     if (key_column_indices_ != other.key_column_indices_) return false;
     // key_coefficients_ are derived from key_column_indices_ — no need to compare
+    if (max_keys_ != other.max_keys_ || idle_ttl_ != other.idle_ttl_) return false;
     if (sub_graphs_.size() != other.sub_graphs_.size()) return false;
 
-    for (const auto& [key, sg] : sub_graphs_) {
-      auto it = other.sub_graphs_.find(key);
-      if (it == other.sub_graphs_.end()) return false;
-      const auto& other_sg = it->second;
-      if (sg.operators.size() != other_sg.operators.size()) return false;
-      for (const auto& [op_id, op] : sg.operators) {
-        auto other_op_it = other_sg.operators.find(op_id);
-        if (other_op_it == other_sg.operators.end()) return false;
-        if (*op != *other_op_it->second) return false;
+    bool same = true;
+    sub_graphs_.for_each([&](Slot s) {
+      if (!same) return;
+      const Slot o = other.sub_graphs_.find(sub_graphs_.key(s));
+      if (o == KeyTable<SubGraph>::npos) {
+        same = false;
+        return;
       }
-    }
+      with_subgraph_(s, [&](const SubGraph& sg) {
+        other.with_subgraph_(o, [&](const SubGraph& other_sg) {
+          if (sg.operators.size() != other_sg.operators.size()) {
+            same = false;
+            return;
+          }
+          for (const auto& [op_id, op] : sg.operators) {
+            auto other_op_it = other_sg.operators.find(op_id);
+            if (other_op_it == other_sg.operators.end() || *op != *other_op_it->second) {
+              same = false;
+              return;
+            }
+          }
+        });
+      });
+    });
 
-    return Operator::equals(other);
+    return same && Operator::equals(other);
   }
 
   bool operator==(const KeyedPipeline& other) const { return equals(other); }
@@ -149,6 +407,10 @@ class KeyedPipeline : public Operator {
  protected:
   void process_data(bool debug = false) override {
     auto& input_queue = get_data_queue(0);
+    if (pool_ && input_queue.size() > 1) {
+      process_batch_(input_queue, debug);
+      return;
+    }
     while (!input_queue.empty()) {
       const auto* msg = static_cast<const Message<VectorNumberData>*>(input_queue.front().get());
       if (!msg) {
@@ -156,26 +418,8 @@ class KeyedPipeline : public Operator {
       }
 
       auto time = msg->time;
-      double key;
-
-      if (has_computed_key()) {
-        // Computed key mode: key = polynomial hash over selected columns
-        key = 0.0;
-        for (size_t i = 0; i < key_column_indices_.size(); ++i) {
-          if (static_cast<size_t>(key_column_indices_[i]) >= msg->data.values->size()) {
-            throw std::runtime_error("KeyedPipeline key_column_indices entry out of bounds");
-          }
-          key += key_coefficients_[i] * (*msg->data.values)[key_column_indices_[i]];
-        }
-      } else {
-        // Classic mode: key is read directly from input vector
-        if (static_cast<size_t>(key_index_) >= msg->data.values->size()) {
-          throw std::runtime_error("KeyedPipeline key_index out of bounds");
-        }
-        key = (*msg->data.values)[key_index_];
-      }
-
-      auto& sg = get_or_create_subgraph_(key);
+      const double key = key_of_(*msg);
+      auto& sg = sub_graphs_.value(route_(key, time));
 
       // Clear collector before processing
       sg.collector->reset();
@@ -184,30 +428,8 @@ class KeyedPipeline : public Operator {
       sg.entry->receive_data(std::move(input_queue.front()), 0);
       sg.entry->execute(debug);
 
-      // Collect from collector's data queue, prepend key
-      auto& sg_output = sg.collector->get_data_queue(0);
-      for (auto& out_msg : sg_output) {
-        if (has_computed_key()) {
-          // Computed key mode: pass through prototype output as-is (no key prepend)
-          auto* vec_out = dynamic_cast<Message<VectorNumberData>*>(out_msg.get());
-          if (vec_out) vec_out->time = time;
-          emit_output(0, std::move(out_msg), debug);
-        } else {
-          // Classic mode: prepend key to output
-          VectorNumberData result;
-          result.values->push_back(key);
-
-          if (out_msg->type() == std::type_index(typeid(VectorNumberData))) {
-            const auto* vec_msg = static_cast<const Message<VectorNumberData>*>(out_msg.get());
-            result.values->insert(result.values->end(), vec_msg->data.values->begin(),
-                                 vec_msg->data.values->end());
-          } else if (out_msg->type() == std::type_index(typeid(NumberData))) {
-            const auto* num_msg = static_cast<const Message<NumberData>*>(out_msg.get());
-            result.values->push_back(num_msg->data.value);
-          }
-
-          emit_output(0, create_message<VectorNumberData>(time, std::move(result)), debug);
-        }
+      for (auto& out_msg : sg.collector->get_data_queue(0)) {
+        emit_keyed_(key, time, std::move(out_msg), debug);
       }
 
       input_queue.pop_front();
@@ -215,12 +437,337 @@ class KeyedPipeline : public Operator {
   }
 
  private:
-  SubGraph& get_or_create_subgraph_(double key) {
-    auto it = sub_graphs_.find(key);
-    if (it != sub_graphs_.end()) return it->second;
+  using Slot = KeyTable<SubGraph>::Slot;
+
+  struct BatchRow {
+    std::unique_ptr<BaseMessage> msg;
+    double key;
+    timestamp_t time;
+    Slot slot;
+    size_t outputs;  // messages the row left in its key's collector
+  };
+
+  double key_of_(const Message<VectorNumberData>& msg) const {
+    if (has_computed_key()) {
+      // Computed key mode: key = polynomial hash over selected columns
+      double key = 0.0;
+      for (size_t i = 0; i < key_column_indices_.size(); ++i) {
+        if (static_cast<size_t>(key_column_indices_[i]) >= msg.data.size()) {
+          throw std::runtime_error("KeyedPipeline key_column_indices entry out of bounds");
+        }
+        key += key_coefficients_[i] * msg.data[key_column_indices_[i]];
+      }
+      return key;
+    }
+    // Classic mode: key is read directly from input vector
+    if (static_cast<size_t>(key_index_) >= msg.data.size()) {
+      throw std::runtime_error("KeyedPipeline key_index out of bounds");
+    }
+    return msg.data[key_index_];
+  }
+
+  // The key's sub-graph for a row at `time`, after idle and cap eviction.
+  Slot route_(double key, timestamp_t time) {
+    if (idle_ttl_ > 0) evict_idle_(time);
+    Slot slot = sub_graphs_.find(key);
+    if (slot == KeyTable<SubGraph>::npos) {
+      slot = create_subgraph_(key);
+    } else if (spill_) {
+      if (sub_graphs_.value(slot).cold != SpillStore::npos) {
+        ++spill_stats_.misses;
+      } else {
+        ++spill_stats_.hits;
+      }
+    }
+    touch_(slot, time);
+    if (max_keys_ > 0 && sub_graphs_.size() > max_keys_) evict_();
+    return slot;
+  }
 
-    sub_graphs_[key] = factory_();
-    auto& sg = sub_graphs_[key];
+  void emit_keyed_(double key, timestamp_t time, std::unique_ptr<BaseMessage> out_msg, bool debug) {
+    if (has_computed_key()) {
+      // Computed key mode: pass through prototype output as-is (no key prepend)
+      auto* vec_out = dynamic_cast<Message<VectorNumberData>*>(out_msg.get());
+      if (vec_out) vec_out->time = time;
+      emit_output(0, std::move(out_msg), debug);
+      return;
+    }
+    // Classic mode: prepend key to output, sized once from the (possibly
+    // view) prototype output.
+    std::shared_ptr<std::vector<double>> result;
+    if (out_msg->type() == std::type_index(typeid(VectorNumberData))) {
+      const auto& vec = static_cast<const Message<VectorNumberData>*>(out_msg.get())->data;
+      const size_t n = vec.size();
+      result = make_pooled_vector_double(n + 1);
+      double* dst = result->data() + 1;
+      if (const double* src = vec.contiguous_data()) {
+        std::copy(src, src + n, dst);
+      } else {
+        for (size_t i = 0; i < n; ++i) dst[i] = vec[i];
+      }
+    } else if (out_msg->type() == std::type_index(typeid(NumberData))) {
+      result = make_pooled_vector_double(2);
+      (*result)[1] = static_cast<const Message<NumberData>*>(out_msg.get())->data.value;
+    } else {
+      result = make_pooled_vector_double(1);
+    }
+    (*result)[0] = key;
+
+    emit_output(0, create_message<VectorNumberData>(time, VectorNumberData(std::move(result))), debug);
+  }
+
+  // Parallel mode. Every queued row is routed on this thread, in order, so
+  // key creation, eviction and the callbacks happen exactly as in serial
+  // mode; then run_batch_() executes the keys on the pool and emits.
+  void process_batch_(MessageQueue& input_queue, bool debug) {
+    batch_debug_ = debug;
+    try {
+      while (!input_queue.empty()) {
+        const auto* msg = static_cast<const Message<VectorNumberData>*>(input_queue.front().get());
+        if (!msg) {
+          throw std::runtime_error("Invalid message type in KeyedPipeline");
+        }
+        const auto time = msg->time;
+        const double key = key_of_(*msg);
+        const Slot slot = route_(key, time);
+        auto& rows = sub_graphs_.value(slot).batch_rows;
+        if (rows.empty()) batch_slots_.push_back(slot);
+        rows.push_back(batch_.size());
+        batch_.push_back({std::move(input_queue.front()), key, time, slot, 0});
+        input_queue.pop_front();
+      }
+    } catch (...) {
+      // Rows routed before the failure still run, as they would serially.
+      run_batch_();
+      throw;
+    }
+    run_batch_();
+  }
+
+  // One pool task per key: its rows in order, outputs left in the key's
+  // collector. Emission then walks the rows in input order.
+  void run_batch_() {
+    if (batch_.empty()) return;
+    try {
+      pool_->run(batch_slots_.size(), [this](size_t k) {
+        auto& sg = sub_graphs_.value(batch_slots_[k]);
+        sg.collector->reset();
+        auto& out = sg.collector->get_data_queue(0);
+        for (size_t r : sg.batch_rows) {
+          auto& row = batch_[r];
+          const size_t before = out.size();
+          sg.entry->receive_data(std::move(row.msg), 0);
+          sg.entry->execute(batch_debug_);
+          row.outputs = out.size() - before;
+        }
+      });
+      for (auto& row : batch_) {
+        auto& out = sub_graphs_.value(row.slot).collector->get_data_queue(0);
+        for (size_t n = 0; n < row.outputs; ++n) {
+          emit_keyed_(row.key, row.time, std::move(out.front()), batch_debug_);
+          out.pop_front();
+        }
+      }
+    } catch (...) {
+      clear_batch_();
+      throw;
+    }
+    clear_batch_();
+  }
+
+  void clear_batch_() {
+    for (Slot s : batch_slots_) sub_graphs_.value(s).batch_rows.clear();
+    batch_slots_.clear();
+    batch_.clear();
+  }
+
+  bool evicting_() const { return max_keys_ > 0 || idle_ttl_ > 0; }
+
+  // Moves the key to the recent end of the recency list and marks it
+  // touched for the next delta checkpoint. A spilled key is read back first;
+  // keys pushed out of the hot set are spilled.
+  void touch_(Slot s, timestamp_t time) {
+    ensure_hot_(s);
+    if (s == coldest_hot_ && hot_count_ > 1) coldest_hot_ = sub_graphs_.newer(s);
+    sub_graphs_.touch(s, time);
+    auto& sg = sub_graphs_.value(s);
+    if (!sg.dirty) {
+      sg.dirty = true;
+      ++dirty_count_;
+    }
+    enforce_hot_set_();
+  }
+
+  void erase_key_(Slot s) {
+    auto& sg = sub_graphs_.value(s);
+    if (sg.dirty) --dirty_count_;
+    if (sg.cold != SpillStore::npos) {
+      spill_->erase(sg.cold);
+    } else {
+      if (s == coldest_hot_) coldest_hot_ = hot_count_ > 1 ? sub_graphs_.newer(s) : KeyTable<SubGraph>::npos;
+      --hot_count_;
+    }
+    sub_graphs_.erase(s);
+  }
+
+  void clear_keys_() {
+    sub_graphs_.clear();
+    if (spill_) spill_->clear();
+    spare_subgraphs_.clear();
+    hot_count_ = 0;
+    coldest_hot_ = KeyTable<SubGraph>::npos;
+    dirty_count_ = 0;
+    removed_keys_.clear();
+    keys_reset_ = true;
+  }
+
+  // Cold tier. Hot keys are always the most recent end of the recency list,
+  // from coldest_hot_ to newest(), so the next key to spill is coldest_hot_.
+  void enforce_hot_set_() {
+    while (hot_keys_ > 0 && hot_count_ > hot_keys_) spill_key_(coldest_hot_);
+  }
+
+  void spill_key_(Slot s) {
+    auto& sg = sub_graphs_.value(s);
+    // Parallel mode: a key with rows still pending runs them before it goes.
+    if (!sg.batch_rows.empty()) run_batch_();
+    spill_buffer_.clear();
+    ByteWriter w(spill_buffer_);
+    for (const auto& entry : sg.operators) entry.second->write_state(w);
+    sg.cold = spill_->put(spill_buffer_.data(), spill_buffer_.size());
+    // Keep the operators for the next key read back: read_state overwrites
+    // every state they hold, and that skips rebuilding from the prototype.
+    if (spare_subgraphs_.size() < kMaxSpareSubGraphs) {
+      spare_subgraphs_.push_back({std::move(sg.operators), std::move(sg.entry), std::move(sg.output),
+                                  std::move(sg.collector)});
+    }
+    sg.operators.clear();
+    sg.entry.reset();
+    sg.output.reset();
+    sg.collector.reset();
+    coldest_hot_ = sub_graphs_.newer(s);
+    --hot_count_;
+    ++spill_stats_.spills;
+  }
+
+  void ensure_hot_(Slot s) {
+    if (sub_graphs_.value(s).cold == SpillStore::npos) return;
+    rehydrate_(s);
+    if (hot_count_++ == 0) coldest_hot_ = s;
+  }
+
+  void rehydrate_(Slot s) {
+    auto& sg = sub_graphs_.value(s);
+    SubGraph fresh;
+    if (!spare_subgraphs_.empty()) {
+      fresh = std::move(spare_subgraphs_.back());
+      spare_subgraphs_.pop_back();
+    } else {
+      fresh = build_subgraph_();
+    }
+    read_cold_(sg.cold, fresh);
+    spill_->erase(sg.cold);
+    sg.operators = std::move(fresh.operators);
+    sg.entry = std::move(fresh.entry);
+    sg.output = std::move(fresh.output);
+    sg.collector = std::move(fresh.collector);
+    sg.cold = SpillStore::npos;
+  }
+
+  void read_cold_(SpillStore::Handle h, SubGraph& sg) const {
+    const auto record = spill_->get(h);
+    ByteReader r(record.first, record.second);
+    for (const auto& entry : sg.operators) entry.second->read_state(r);
+  }
+
+  // Calls f with the key's sub-graph, or with a temporary copy read back
+  // from the spill store when the key is cold.
+  template <typename F>
+  void with_subgraph_(Slot s, F&& f) const {
+    const SubGraph& sg = sub_graphs_.value(s);
+    if (sg.cold == SpillStore::npos) {
+      f(sg);
+      return;
+    }
+    SubGraph copy = build_subgraph_();
+    read_cold_(sg.cold, copy);
+    f(static_cast<const SubGraph&>(copy));
+  }
+
+  void evict_key_(Slot s) {
+    // Parallel mode: a key with rows still pending runs them before it goes.
+    if (!sub_graphs_.value(s).batch_rows.empty()) run_batch_();
+    const double key = sub_graphs_.key(s);
+    erase_key_(s);
+    removed_keys_.push_back(key);
+    ++num_evicted_;
+    if (evict_key_callback_) evict_key_callback_(key);
+  }
+
+  // Keys idle for more than idle_ttl_ at event time `now`. The recency list
+  // is in arrival order, so the walk stops at the first key still live.
+  void evict_idle_(timestamp_t now) {
+    for (Slot s = sub_graphs_.oldest();
+         s != KeyTable<SubGraph>::npos && now - sub_graphs_.last_seen(s) > idle_ttl_; s = sub_graphs_.oldest()) {
+      evict_key_(s);
+    }
+  }
+
+  void evict_() {
+    while (max_keys_ > 0 && sub_graphs_.size() > max_keys_) evict_key_(sub_graphs_.oldest());
+  }
+
+  // `cold_is_state`: write_op writes write_state output, so spilled records
+  // can be copied verbatim instead of being read back.
+  template <typename WriteOp>
+  void write_keys_(ByteWriter& w, const std::vector<Slot>& slots, WriteOp&& write_op, bool cold_is_state) {
+    w.write_size(slots.size());
+    if (slots.empty()) return;
+    with_subgraph_(sub_graphs_.newest(), [&w](const SubGraph& sg) {
+      w.write_size(sg.operators.size());
+      for (const auto& entry : sg.operators) w.write_string(entry.first);
+    });
+    for (Slot s : slots) {
+      w.write(sub_graphs_.key(s));
+      w.write(sub_graphs_.last_seen(s));
+      const SpillStore::Handle cold = sub_graphs_.value(s).cold;
+      if (cold != SpillStore::npos && cold_is_state) {
+        const auto record = spill_->get(cold);
+        w.write_bytes(record.first, record.second);
+        continue;
+      }
+      with_subgraph_(s, [&write_op](const SubGraph& sg) {
+        for (const auto& entry : sg.operators) write_op(*entry.second);
+      });
+    }
+  }
+
+  template <typename ReadOp>
+  void read_keys_(ByteReader& r, ReadOp&& read_op) {
+    const size_t key_count = r.read_size();
+    if (key_count == 0) return;
+    std::vector<std::string> op_ids(r.read_size());
+    for (auto& op_id : op_ids) op_id = r.read_string();
+    for (size_t k = 0; k < key_count; ++k) {
+      const double key = r.read<double>();
+      const auto seen = r.read<timestamp_t>();
+      Slot s = sub_graphs_.find(key);
+      if (s == KeyTable<SubGraph>::npos) s = create_subgraph_(key);
+      ensure_hot_(s);
+      auto& sg = sub_graphs_.value(s);
+      for (const auto& op_id : op_ids) {
+        auto it = sg.operators.find(op_id);
+        if (it == sg.operators.end()) {
+          throw std::runtime_error("KeyedPipeline " + id() + ": snapshot has unknown operator " + op_id);
+        }
+        read_op(*it->second);
+      }
+      touch_(s, seen);
+    }
+  }
+
+  SubGraph build_subgraph_() const {
+    SubGraph sg = factory_();
 
     // Attach a collector to capture the output operator's results
     std::vector<std::string> col_types;
@@ -230,19 +777,55 @@ class KeyedPipeline : public Operator {
     sg.collector = std::make_shared<Collector>(
         sg.output->id() + "_collector", col_types);
     sg.output->connect(sg.collector, 0, 0);
+    return sg;
+  }
+
+  // A new key joins as the most recent, hot one.
+  Slot create_subgraph_(double key) {
+    SubGraph sg = build_subgraph_();
+    const Slot s = sub_graphs_.insert(key).first;
+    sub_graphs_.value(s) = std::move(sg);
+    if (hot_count_++ == 0) coldest_hot_ = s;
 
     if (new_key_callback_) {
       new_key_callback_(key);
     }
-    return sg;
+    return s;
   }
 
   int key_index_;
   SubGraphFactory factory_;
   NewKeyCallback new_key_callback_;
-  std::map<double, SubGraph> sub_graphs_;
+  EvictKeyCallback evict_key_callback_;
+  KeyTable<SubGraph> sub_graphs_;
+  size_t max_keys_{0};
+  timestamp_t idle_ttl_{0};
+  uint64_t num_evicted_{0};
+  // Delta checkpoint bookkeeping: keys touched and keys evicted since the
+  // last checkpoint, whether / when reset() last dropped every key, and the
+  // last checkpoint that closed an epoch with evictions.
+  size_t dirty_count_{0};
+  std::vector<double> removed_keys_;
+  bool keys_reset_{false};
+  uint64_t reset_epoch_{0};
+  uint64_t evict_epoch_{0};
   std::vector<int> key_column_indices_;
   std::vector<double> key_coefficients_;
+  // Cold tier (set_spill): hot keys are the hot_count_ most recent ones,
+  // coldest_hot_ the oldest of them. Counted even while spilling is off.
+  std::unique_ptr<SpillStore> spill_;
+  size_t hot_keys_{0};
+  size_t hot_count_{0};
+  Slot coldest_hot_{KeyTable<SubGraph>::npos};
+  SpillStats spill_stats_;
+  Bytes spill_buffer_;
+  static constexpr size_t kMaxSpareSubGraphs = 16;
+  std::vector<SubGraph> spare_subgraphs_;
+  // Parallel mode (set_threads): the pool and the batch being processed.
+  std::unique_ptr<WorkStealingPool> pool_;
+  std::vector<BatchRow> batch_;
+  std::vector<Slot> batch_slots_;
+  bool batch_debug_{false};
 };
 
 inline std::shared_ptr<KeyedPipeline> make_keyed_pipeline(std::string id, int key_index,
@@ -53,6 +53,7 @@ class KeyedVariable : public Operator {
   }
 
   std::string type_name() const override { return "KeyedVariable"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<KeyedVariable>(*this); }
 
   const std::string& get_mode() const { return mode_; }
   double get_default_value() const { return default_value_; }
@@ -163,12 +164,12 @@ class KeyedVariable : public Operator {
       if (!msg) {
         throw std::runtime_error("Invalid data message type in KeyedVariable");
       }
-      if (msg->data.values->size() < 2) {
+      if (msg->data.size() < 2) {
         throw std::runtime_error("KeyedVariable i1 message must have 2 values: [key, value]");
       }
 
-      double key = (*msg->data.values)[0];
-      double val = (*msg->data.values)[1];
+      double key = msg->data[0];
+      double val = msg->data[1];
 
       if (std::isnan(val)) {
         hashmap_.erase(key);
@@ -17,9 +17,11 @@ class Linear : public Join {
     if (coeffs.size() < 2) {
       throw std::runtime_error("Linear operator requires at least 2 coefficients");
     }
+    for (size_t i = 0; i < num_data_ports(); ++i) enable_value_queue(i);
   }
 
   std::string type_name() const override { return "Linear"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Linear>(*this); }
   const std::vector<double>& get_coefficients() const { return coeffs_; }
 
   bool equals(const Linear& other) const {
@@ -36,51 +38,24 @@ class Linear : public Join {
 
  protected:
   void process_data(bool debug=false) override {
-    
-    while(true) {
-
-      bool is_any_empty;
-      bool is_sync;
-      do {
-        is_any_empty = false;
-        is_sync = sync_data_inputs();
-        for (int i=0; i < num_data_ports(); i++) {
-          if (get_data_queue(i).empty()) {
-            is_any_empty = true;
-            break;
-          }
-        } 
-      } while (!is_sync && !is_any_empty );
-
-      if (!is_sync) return;
-
-      std::vector<const Message<NumberData>*> typed_messages;
-      timestamp_t time = 0;
-      // Process each synchronized set of messages
-      for (int i=0; i < num_data_ports(); i++) {
-        typed_messages.reserve(num_data_ports());
-        const auto* typed_msg = static_cast<const Message<NumberData>*>(get_data_queue(i).front().get());
-        if (!typed_msg) {
-          throw std::runtime_error("Invalid message type in Linear");
-        }
-        typed_messages.push_back(typed_msg);
-        time = typed_msg->time;        
-      }
-
+    // Every synchronized row (all ports share the front timestamp) becomes
+    // one output; rows are collected into a column and emitted once.
+    batch_.clear();
+    const size_t n = num_data_ports();
+    while (sync_data_inputs()) {
       double result = 0.0;
-      for (size_t i = 0; i < coeffs_.size(); i++) {
-        result += coeffs_[i] * typed_messages[i]->data.value;
+      for (size_t i = 0; i < n; i++) {
+        result += coeffs_[i] * get_value_queue(i).front().value;
       }
-
-      for (int i = 0; i < num_data_ports(); i++)
-        get_data_queue(i).pop_front();
-
-      emit_output(0, create_message<NumberData>(time, NumberData{result}), debug);
+      batch_.push_back(get_value_queue(0).front().time, result);
+      for (size_t i = 0; i < n; i++) get_value_queue(i).pop_front();
     }
+    emit_output(0, batch_, debug);
   }
 
  private:
   std::vector<double> coeffs_;
+  MessageBatch<NumberData> batch_;  // scratch, reused across calls
 };
 
 // Factory function
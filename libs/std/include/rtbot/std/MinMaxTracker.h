@@ -22,6 +22,7 @@ class MinTracker : public Operator {
   }
 
   std::string type_name() const override { return "MinTracker"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<MinTracker>(*this); }
   double get_current_min() const { return min_; }
 
   void reset() override {
@@ -98,6 +99,7 @@ class MaxTracker : public Operator {
   }
 
   std::string type_name() const override { return "MaxTracker"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<MaxTracker>(*this); }
   double get_current_max() const { return max_; }
 
   void reset() override {
@@ -22,6 +22,7 @@ class MovingAverage : public Buffer<NumberData, MovingAverageFeatures> {
       : Buffer<NumberData, MovingAverageFeatures>(std::move(id), window_size) {}
 
   std::string type_name() const override { return "MovingAverage"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<MovingAverage>(*this); }
 
   bool equals(const MovingAverage& other) const {
     return (StateSerializer::hash_double(mean()) == StateSerializer::hash_double(other.mean()) && Buffer<NumberData, MovingAverageFeatures>::equals(other));
@@ -48,6 +49,10 @@ class MovingAverage : public Buffer<NumberData, MovingAverageFeatures> {
     v.push_back(create_message<NumberData>(msg->time, NumberData{this->mean()}));
     return v;
   }
+
+  void process_record(timestamp_t time, MessageBatch<NumberData>& out) override {
+    if (this->buffer_full()) out.push_back(time, this->mean());
+  }
 };
 
 inline std::shared_ptr<MovingAverage> make_moving_average(std::string id, size_t window_size) {
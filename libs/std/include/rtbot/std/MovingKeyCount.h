@@ -3,8 +3,10 @@
 
 #include <cstring>
 #include <deque>
+#include <optional>
 #include <unordered_map>
 
+#include "rtbot/CountMinSketch.h"
 #include "rtbot/Message.h"
 #include "rtbot/Operator.h"
 
@@ -17,6 +19,11 @@ namespace rtbot {
 // Complexity: O(1) per message.
 // Use case: pre-filter for HAVING MOVING_COUNT(N) > threshold before
 //           KeyedPipeline, so only active keys pass through.
+//
+// Count-Min mode (the epsilon/delta/panes constructor) replaces the ring and
+// the map with a SlidingCountMin: memory no longer grows with the window or
+// the number of distinct keys, and the emitted count may overestimate (never
+// underestimate) the exact one, see CountMinSketch.h for the bounds.
 class MovingKeyCount : public Operator {
  public:
   explicit MovingKeyCount(std::string id, size_t window_size)
@@ -29,15 +36,31 @@ class MovingKeyCount : public Operator {
     add_output_port<NumberData>();  // o1 — count of this key in window
   }
 
+  MovingKeyCount(std::string id, size_t window_size, double epsilon, double delta, size_t panes)
+      : MovingKeyCount(std::move(id), window_size) {
+    sketch_.emplace(window_size, epsilon, delta, panes);
+  }
+
   std::string type_name() const override { return "MovingKeyCount"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<MovingKeyCount>(*this); }
   size_t get_window_size() const { return window_size_; }
+  bool is_count_min() const { return sketch_.has_value(); }
+  // Null in exact mode.
+  const SlidingCountMin* get_sketch() const { return sketch_ ? &*sketch_ : nullptr; }
 
   bool equals(const MovingKeyCount& other) const {
-    return window_size_ == other.window_size_ && Operator::equals(other);
+    return window_size_ == other.window_size_ && sketch_ == other.sketch_ && Operator::equals(other);
   }
   bool operator==(const MovingKeyCount& other) const { return equals(other); }
   bool operator!=(const MovingKeyCount& other) const { return !(*this == other); }
 
+  void reset() override {
+    Operator::reset();
+    ring_.clear();
+    counts_.clear();
+    if (sketch_) sketch_->clear();
+  }
+
   Bytes collect_bytes() override {
     Bytes bytes = Operator::collect_bytes();
 
@@ -61,6 +84,9 @@ class MovingKeyCount : public Operator {
                    reinterpret_cast<const uint8_t*>(&v) + sizeof(v));
     }
 
+    // Sketch panes (Count-Min mode only; the ring and map are then empty)
+    if (sketch_) sketch_->serialize(bytes);
+
     return bytes;
   }
 
@@ -91,6 +117,8 @@ class MovingKeyCount : public Operator {
       it += sizeof(v);
       counts_[k] = v;
     }
+
+    if (sketch_) sketch_->restore(it);
   }
 
  protected:
@@ -107,29 +135,9 @@ class MovingKeyCount : public Operator {
           throw std::runtime_error("Invalid message type in MovingKeyCount");
         }
 
-        double key = msg->data.value;
-
-        // Evict oldest key from window if at capacity
-        if (ring_.size() >= window_size_) {
-          double old_key = ring_.front();
-          ring_.pop_front();
-          auto it = counts_.find(old_key);
-          if (it != counts_.end()) {
-            if (it->second <= 1) {
-              counts_.erase(it);
-            } else {
-              it->second--;
-            }
-          }
-        }
-
-        // Insert new key
-        ring_.push_back(key);
-        counts_[key]++;
-
         // Emit count of this key in the current window
         batch.push_back(create_message<NumberData>(
-            msg->time, NumberData{static_cast<double>(counts_[key])}));
+            msg->time, NumberData{count(msg->data.value)}));
         input_queue.pop_front();
       }
       emit_output(0, std::move(batch), debug);
@@ -141,38 +149,42 @@ class MovingKeyCount : public Operator {
           throw std::runtime_error("Invalid message type in MovingKeyCount");
         }
 
-        double key = msg->data.value;
-
-        // Evict oldest key from window if at capacity
-        if (ring_.size() >= window_size_) {
-          double old_key = ring_.front();
-          ring_.pop_front();
-          auto it = counts_.find(old_key);
-          if (it != counts_.end()) {
-            if (it->second <= 1) {
-              counts_.erase(it);
-            } else {
-              it->second--;
-            }
-          }
-        }
-
-        // Insert new key
-        ring_.push_back(key);
-        counts_[key]++;
-
         // Emit count of this key in the current window
         emit_output(0, create_message<NumberData>(
-            msg->time, NumberData{static_cast<double>(counts_[key])}), debug);
+            msg->time, NumberData{count(msg->data.value)}), debug);
         input_queue.pop_front();
       }
     }
   }
 
  private:
+  // Adds `key` to the window and returns its count there.
+  double count(double key) {
+    if (sketch_) return static_cast<double>(sketch_->add(key));
+
+    // Evict oldest key from window if at capacity
+    if (ring_.size() >= window_size_) {
+      double old_key = ring_.front();
+      ring_.pop_front();
+      auto it = counts_.find(old_key);
+      if (it != counts_.end()) {
+        if (it->second <= 1) {
+          counts_.erase(it);
+        } else {
+          it->second--;
+        }
+      }
+    }
+
+    // Insert new key
+    ring_.push_back(key);
+    return static_cast<double>(++counts_[key]);
+  }
+
   size_t window_size_;
   std::deque<double> ring_;
   std::unordered_map<double, size_t> counts_;
+  std::optional<SlidingCountMin> sketch_;
 };
 
 inline std::shared_ptr<MovingKeyCount> make_moving_key_count(std::string id,
@@ -180,6 +192,12 @@ inline std::shared_ptr<MovingKeyCount> make_moving_key_count(std::string id,
   return std::make_shared<MovingKeyCount>(std::move(id), window_size);
 }
 
+inline std::shared_ptr<MovingKeyCount> make_moving_key_count(std::string id, size_t window_size,
+                                                              double epsilon, double delta,
+                                                              size_t panes) {
+  return std::make_shared<MovingKeyCount>(std::move(id), window_size, epsilon, delta, panes);
+}
+
 }  // namespace rtbot
 
 #endif  // MOVING_KEY_COUNT_H
@@ -21,6 +21,7 @@ class MovingSum : public Buffer<NumberData, MovingSumFeatures> {
   MovingSum(std::string id, size_t window_size) : Buffer<NumberData, MovingSumFeatures>(std::move(id), window_size) {}
 
   std::string type_name() const override { return "MovingSum"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<MovingSum>(*this); }
 
   bool equals(const MovingSum& other) const {
     return (StateSerializer::hash_double(sum()) == StateSerializer::hash_double(other.sum()) && Buffer<NumberData, MovingSumFeatures>::equals(other));
@@ -47,6 +48,10 @@ class MovingSum : public Buffer<NumberData, MovingSumFeatures> {
     v.push_back(create_message<NumberData>(msg->time, NumberData{this->sum()}));
     return v;
   }
+
+  void process_record(timestamp_t time, MessageBatch<NumberData>& out) override {
+    if (this->buffer_full()) out.push_back(time, this->sum());
+  }
 };
 
 inline std::shared_ptr<MovingSum> make_moving_sum(std::string id, size_t window_size) {
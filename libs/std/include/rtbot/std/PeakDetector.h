@@ -29,6 +29,7 @@ class PeakDetector : public Buffer<NumberData, PeakDetectorFeatures> {
   }
 
   std::string type_name() const override { return "PeakDetector"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<PeakDetector>(*this); }
 
   bool equals(const PeakDetector& other) const {
     return Buffer<NumberData, PeakDetectorFeatures>::equals(other);
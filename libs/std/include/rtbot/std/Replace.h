@@ -53,6 +53,7 @@ class LessThanOrEqualToReplace : public Replace {
   LessThanOrEqualToReplace(std::string id, double threshold, double replaceBy)
       : Replace(std::move(id)), threshold_(threshold), replaceBy_(replaceBy) {}
   std::string type_name() const override { return "LessThanOrEqualToReplace"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<LessThanOrEqualToReplace>(*this); }
 
   double get_threshold() const { return threshold_; }
   double get_replace_by() const { return replaceBy_; }
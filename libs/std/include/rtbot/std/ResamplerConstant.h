@@ -34,6 +34,7 @@ class ResamplerConstant : public Operator {
   }
 
   std::string type_name() const override { return "ResamplerConstant"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<ResamplerConstant>(*this); }
 
   bool equals(const ResamplerConstant& other) const {
 
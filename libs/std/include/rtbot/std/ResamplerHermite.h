@@ -35,6 +35,7 @@ class ResamplerHermite : public Buffer<NumberData, ResamplerFeatures> {
   }
 
   std::string type_name() const override { return "ResamplerHermite"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<ResamplerHermite>(*this); }
 
   bool equals(const ResamplerHermite& other) const {
       
@@ -89,6 +90,16 @@ class ResamplerHermite : public Buffer<NumberData, ResamplerFeatures> {
   std::optional<timestamp_t> get_t0() const { return t0_; }
 
  protected:
+  void write_extra_state(ByteWriter& w) override {
+    w.write(next_emit_);
+    w.write(initialized_);
+  }
+
+  void read_extra_state(ByteReader& r) override {
+    next_emit_ = r.read<timestamp_t>();
+    initialized_ = r.read<bool>();
+  }
+
   std::vector<std::unique_ptr<Message<NumberData>>> process_message(const Message<NumberData>* msg) override {
     if (!initialized_ && buffer_full()) {
       // Initialize next_emit_ based on t0_ or first complete buffer
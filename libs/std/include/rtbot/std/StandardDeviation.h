@@ -19,6 +19,7 @@ class StandardDeviation : public Buffer<NumberData, StandardDeviationFeatures> {
       : Buffer<NumberData, StandardDeviationFeatures>(std::move(id), window_size) {}
 
   std::string type_name() const override { return "StandardDeviation"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<StandardDeviation>(*this); }
 
   bool equals(const StandardDeviation& other) const {
     return (StateSerializer::hash_double(standard_deviation()) == StateSerializer::hash_double(other.standard_deviation()) && Buffer<NumberData, StandardDeviationFeatures>::equals(other));
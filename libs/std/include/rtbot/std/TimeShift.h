@@ -14,6 +14,7 @@ class TimeShift : public Operator {
   }
 
   std::string type_name() const override { return "TimeShift"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<TimeShift>(*this); }
   timestamp_t get_shift() const { return shift_; }
 
   bool equals(const TimeShift& other) const {
@@ -20,6 +20,7 @@ class TimestampExtract : public Operator {
   }
 
   std::string type_name() const override { return "TimestampExtract"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<TimestampExtract>(*this); }
 
   bool equals(const TimestampExtract& other) const {
     return Operator::equals(other);
@@ -13,15 +13,60 @@
 
 namespace rtbot {
 
-// TopK: maintains the top-K entries by a score field, emitting a full snapshot
-// of all K entries on each input. Uses a sorted vector (best first, worst last).
+// What TopK and WindowTopK emit for each input row:
+//   Full     — every current top entry as its own message, best first.
+//   Delta    — only the changes to the top set, in the order they apply:
+//              [+1, row...] for an entry that enters it and [-1, row...] for
+//              one that leaves it. An input that changes nothing emits
+//              nothing.
+//   Snapshot — one message with the current top entries concatenated, best
+//              first (rows are expected to share the input width).
+enum class TopKEmit { Full, Delta, Snapshot };
+
+inline TopKEmit topk_emit_from_string(const std::string& emit) {
+  if (emit == "full") return TopKEmit::Full;
+  if (emit == "delta") return TopKEmit::Delta;
+  if (emit == "snapshot") return TopKEmit::Snapshot;
+  throw std::runtime_error("TopK: emit must be full, delta or snapshot, got " + emit);
+}
+
+inline std::string topk_emit_to_string(TopKEmit emit) {
+  switch (emit) {
+    case TopKEmit::Delta:
+      return "delta";
+    case TopKEmit::Snapshot:
+      return "snapshot";
+    default:
+      return "full";
+  }
+}
+
+namespace detail {
+
+// Pooled copy of an entry, with a delta's change marker (+1/-1) in front;
+// 0 copies the entry alone.
+inline std::shared_ptr<std::vector<double>> topk_row(const double* row, size_t n, double change) {
+  const size_t head = change != 0.0 ? 1 : 0;
+  auto out = make_pooled_vector_double(n + head);
+  if (head) (*out)[0] = change;
+  std::copy(row, row + n, out->data() + head);
+  return out;
+}
+
+}  // namespace detail
+
+// TopK: maintains the top-K entries by a score field and emits them on each
+// input according to `emit` (see TopKEmit). Uses a sorted vector (best
+// first, worst last); an input that cannot enter the top set is never
+// copied.
 class TopK : public Operator {
  public:
-  TopK(std::string id, int k, int score_index, bool descending)
+  TopK(std::string id, int k, int score_index, bool descending, TopKEmit emit = TopKEmit::Full)
       : Operator(std::move(id)),
         k_(k),
         score_index_(score_index),
-        descending_(descending) {
+        descending_(descending),
+        emit_(emit) {
     if (k_ <= 0) throw std::runtime_error("TopK: k must be positive");
     if (score_index_ < 0)
       throw std::runtime_error("TopK: score_index must be non-negative");
@@ -30,9 +75,11 @@ class TopK : public Operator {
   }
 
   std::string type_name() const override { return "TopK"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<TopK>(*this); }
   int k() const { return k_; }
   int score_index() const { return score_index_; }
   bool descending() const { return descending_; }
+  TopKEmit emit() const { return emit_; }
 
   Bytes collect_bytes() override {
     Bytes bytes = Operator::collect_bytes();
@@ -79,16 +126,27 @@ class TopK : public Operator {
           input_queue.front().get());
       if (!msg) throw std::runtime_error("TopK: invalid message type");
 
-      const auto& values = *msg->data.values;
-      if (score_index_ >= static_cast<int>(values.size())) {
+      if (score_index_ >= static_cast<int>(msg->data.size())) {
         throw std::runtime_error("TopK: score_index out of bounds");
       }
 
-      insert_into_top_k(values);
-
-      for (const auto& row : top_k_) {
-        emit_output(0, create_message<VectorNumberData>(
-            msg->time, VectorNumberData{row}), debug);
+      const auto row = msg->data.materialize();
+      const size_t rank = insert_into_top_k(*row);
+
+      if (emit_ == TopKEmit::Delta) {
+        if (rank < top_k_.size()) {
+          emit_row(msg->time, top_k_[rank], 1.0, debug);
+          if (!evicted_.empty()) emit_row(msg->time, evicted_, -1.0, debug);
+        }
+      } else if (emit_ == TopKEmit::Snapshot) {
+        size_t n = 0;
+        for (const auto& entry : top_k_) n += entry.size();
+        auto flat = make_pooled_vector_double(n);
+        double* dst = flat->data();
+        for (const auto& entry : top_k_) dst = std::copy(entry.begin(), entry.end(), dst);
+        emit_output(0, create_message<VectorNumberData>(msg->time, VectorNumberData(std::move(flat))), debug);
+      } else {
+        for (const auto& entry : top_k_) emit_row(msg->time, entry, 0.0, debug);
       }
 
       input_queue.pop_front();
@@ -99,30 +157,44 @@ class TopK : public Operator {
   int k_;
   int score_index_;
   bool descending_;
+  TopKEmit emit_;
   std::vector<std::vector<double>> top_k_;  // sorted: best first, worst last
+  std::vector<double> evicted_;             // entry pushed out by the last insert, if any
+
+  void emit_row(timestamp_t time, const std::vector<double>& row, double change, bool debug) {
+    emit_output(0, create_message<VectorNumberData>(
+        time, VectorNumberData(detail::topk_row(row.data(), row.size(), change))), debug);
+  }
 
-  void insert_into_top_k(const std::vector<double>& entry) {
+  // Rank the entry took, or k when it did not make the top set (and was not
+  // copied). A full set's worst entry moves to evicted_.
+  size_t insert_into_top_k(const std::vector<double>& entry) {
+    evicted_.clear();
     // lower_bound finds first element where comp(elem, entry) is false.
     // descending: comp = existing_score > new_score → first where existing <= new
     // ascending:  comp = existing_score < new_score → first where existing >= new
+    const double vs = entry[score_index_];
     auto it = std::lower_bound(
-        top_k_.begin(), top_k_.end(), entry,
-        [this](const std::vector<double>& existing,
-               const std::vector<double>& val) {
+        top_k_.begin(), top_k_.end(), vs,
+        [this](const std::vector<double>& existing, double val) {
           double es = existing[score_index_];
-          double vs = val[score_index_];
-          return descending_ ? (es > vs) : (es < vs);
+          return descending_ ? (es > val) : (es < val);
         });
-    top_k_.insert(it, entry);
-    if (static_cast<int>(top_k_.size()) > k_) {
-      top_k_.pop_back();  // evict worst (always at back)
+    const size_t rank = static_cast<size_t>(it - top_k_.begin());
+    if (rank >= static_cast<size_t>(k_)) return static_cast<size_t>(k_);
+    if (static_cast<int>(top_k_.size()) == k_) {
+      evicted_ = std::move(top_k_.back());  // evict worst (always at back)
+      top_k_.pop_back();
     }
+    top_k_.insert(top_k_.begin() + rank, entry);
+    return rank;
   }
 };
 
 inline std::shared_ptr<TopK> make_topk(std::string id, int k, int score_index,
-                                        bool descending = true) {
-  return std::make_shared<TopK>(std::move(id), k, score_index, descending);
+                                        bool descending = true,
+                                        TopKEmit emit = TopKEmit::Full) {
+  return std::make_shared<TopK>(std::move(id), k, score_index, descending, emit);
 }
 
 }  // namespace rtbot
@@ -23,6 +23,7 @@ class Variable : public Operator {
   } 
 
   std::string type_name() const override { return "Variable"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<Variable>(*this); }
 
   double get_default_value() const { return default_value_; }
 
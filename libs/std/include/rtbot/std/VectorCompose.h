@@ -25,6 +25,7 @@ class VectorCompose : public Join {
   }
 
   std::string type_name() const override { return "VectorCompose"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<VectorCompose>(*this); }
   size_t get_num_ports() const { return num_ports_; }
 
   bool equals(const VectorCompose& other) const {
@@ -21,6 +21,7 @@ class VectorExtract : public Operator {
   }
 
   std::string type_name() const override { return "VectorExtract"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<VectorExtract>(*this); }
   int get_index() const { return index_; }
 
   bool equals(const VectorExtract& other) const {
@@ -42,11 +43,11 @@ class VectorExtract : public Operator {
         if (!msg) {
           throw std::runtime_error("Invalid message type in VectorExtract");
         }
-        if (static_cast<size_t>(index_) >= msg->data.values->size()) {
+        if (static_cast<size_t>(index_) >= msg->data.size()) {
           throw std::runtime_error("VectorExtract index " + std::to_string(index_) +
-                                   " out of bounds for vector of size " + std::to_string(msg->data.values->size()));
+                                   " out of bounds for vector of size " + std::to_string(msg->data.size()));
         }
-        batch.push_back(create_message<NumberData>(msg->time, NumberData{(*msg->data.values)[index_]}));
+        batch.push_back(create_message<NumberData>(msg->time, NumberData{msg->data[index_]}));
         input_queue.pop_front();
       }
       emit_output(0, std::move(batch), debug);
@@ -56,11 +57,11 @@ class VectorExtract : public Operator {
         if (!msg) {
           throw std::runtime_error("Invalid message type in VectorExtract");
         }
-        if (static_cast<size_t>(index_) >= msg->data.values->size()) {
+        if (static_cast<size_t>(index_) >= msg->data.size()) {
           throw std::runtime_error("VectorExtract index " + std::to_string(index_) +
-                                   " out of bounds for vector of size " + std::to_string(msg->data.values->size()));
+                                   " out of bounds for vector of size " + std::to_string(msg->data.size()));
         }
-        emit_output(0, create_message<NumberData>(msg->time, NumberData{(*msg->data.values)[index_]}), debug);
+        emit_output(0, create_message<NumberData>(msg->time, NumberData{msg->data[index_]}), debug);
         input_queue.pop_front();
       }
     }
@@ -1,6 +1,7 @@
 #ifndef VECTOR_PROJECT_H
 #define VECTOR_PROJECT_H
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -22,11 +23,20 @@ class VectorProject : public Operator {
         throw std::runtime_error("VectorProject indices must be non-negative");
       }
     }
+    // Indices in arithmetic progression (a column range, every k-th column,
+    // a single column) are emitted as a view sharing the input buffer.
+    max_index_ = static_cast<size_t>(*std::max_element(indices_.begin(), indices_.end()));
+    strided_ = true;
+    stride_ = indices_.size() > 1 ? indices_[1] - indices_[0] : 1;
+    for (size_t i = 1; i < indices_.size() && strided_; ++i) {
+      strided_ = stride_ >= 0 && indices_[i] - indices_[i - 1] == stride_;
+    }
     add_data_port<VectorNumberData>();
     add_output_port<VectorNumberData>();
   }
 
   std::string type_name() const override { return "VectorProject"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<VectorProject>(*this); }
   const std::vector<int>& get_indices() const { return indices_; }
 
   bool equals(const VectorProject& other) const {
@@ -48,18 +58,7 @@ class VectorProject : public Operator {
         if (!msg) {
           throw std::runtime_error("Invalid message type in VectorProject");
         }
-
-        VectorNumberData result;
-        result.values->reserve(indices_.size());
-        for (auto idx : indices_) {
-          if (static_cast<size_t>(idx) >= msg->data.values->size()) {
-            throw std::runtime_error("VectorProject index " + std::to_string(idx) +
-                                     " out of bounds for vector of size " + std::to_string(msg->data.values->size()));
-          }
-          result.values->push_back((*msg->data.values)[idx]);
-        }
-
-        batch.push_back(create_message<VectorNumberData>(msg->time, result));
+        batch.push_back(create_message<VectorNumberData>(msg->time, project(msg->data)));
         input_queue.pop_front();
       }
       emit_output(0, std::move(batch), debug);
@@ -69,25 +68,35 @@ class VectorProject : public Operator {
         if (!msg) {
           throw std::runtime_error("Invalid message type in VectorProject");
         }
-
-        VectorNumberData result;
-        result.values->reserve(indices_.size());
-        for (auto idx : indices_) {
-          if (static_cast<size_t>(idx) >= msg->data.values->size()) {
-            throw std::runtime_error("VectorProject index " + std::to_string(idx) +
-                                     " out of bounds for vector of size " + std::to_string(msg->data.values->size()));
-          }
-          result.values->push_back((*msg->data.values)[idx]);
-        }
-
-        emit_output(0, create_message<VectorNumberData>(msg->time, result), debug);
+        emit_output(0, create_message<VectorNumberData>(msg->time, project(msg->data)), debug);
         input_queue.pop_front();
       }
     }
   }
 
  private:
+  VectorNumberData project(const VectorNumberData& in) const {
+    const size_t size = in.size();
+    if (max_index_ >= size) {
+      for (auto idx : indices_) {
+        if (static_cast<size_t>(idx) >= size) {
+          throw std::runtime_error("VectorProject index " + std::to_string(idx) +
+                                   " out of bounds for vector of size " + std::to_string(size));
+        }
+      }
+    }
+    if (strided_) {
+      return in.slice(static_cast<size_t>(indices_[0]), indices_.size(), static_cast<size_t>(stride_));
+    }
+    auto out = make_pooled_vector_double(indices_.size());
+    for (size_t i = 0; i < indices_.size(); ++i) (*out)[i] = in[static_cast<size_t>(indices_[i])];
+    return VectorNumberData(std::move(out));
+  }
+
   std::vector<int> indices_;
+  size_t max_index_{0};
+  bool strided_{false};
+  int stride_{1};
 };
 
 inline std::shared_ptr<VectorProject> make_vector_project(std::string id, std::vector<int> indices) {
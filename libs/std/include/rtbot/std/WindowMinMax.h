@@ -29,6 +29,7 @@ class WindowMinMax : public Operator {
   }
 
   std::string type_name() const override { return "WindowMinMax"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<WindowMinMax>(*this); }
   size_t window_size() const { return window_size_; }
   bool is_min() const { return is_min_; }
 
@@ -0,0 +1,233 @@
+#ifndef WINDOW_TOPK_H
+#define WINDOW_TOPK_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rtbot/Message.h"
+#include "rtbot/Operator.h"
+#include "rtbot/std/TopK.h"
+
+namespace rtbot {
+
+// WindowTopK: the top-K entries by a score field among the last
+// window_size inputs, emitted on each input like TopK (see TopKEmit).
+//
+// The window's entries are split between two ordered sets: `top_`, the
+// current top K, and `rest_`, everything else still in the window. An
+// arriving entry either joins `top_` (demoting its worst entry to `rest_`)
+// or goes straight to `rest_`; an expiring entry is erased from its set and,
+// if it was in `top_`, the best of `rest_` is promoted. Both are O(log W)
+// with no rescans of the window. Equal scores rank the newer entry first,
+// as in TopK.
+class WindowTopK : public Operator {
+ public:
+  WindowTopK(std::string id, int k, int score_index, size_t window_size, bool descending,
+             TopKEmit emit = TopKEmit::Full)
+      : Operator(std::move(id)),
+        k_(k),
+        score_index_(score_index),
+        window_size_(window_size),
+        descending_(descending),
+        emit_(emit),
+        top_(Better{descending}),
+        rest_(Better{descending}) {
+    if (k_ <= 0) throw std::runtime_error("WindowTopK: k must be positive");
+    if (score_index_ < 0)
+      throw std::runtime_error("WindowTopK: score_index must be non-negative");
+    if (window_size_ == 0)
+      throw std::runtime_error("WindowTopK: window_size must be positive");
+    add_data_port<VectorNumberData>();
+    add_output_port<VectorNumberData>();
+  }
+
+  std::string type_name() const override { return "WindowTopK"; }
+  std::shared_ptr<Operator> clone() const override { return std::make_shared<WindowTopK>(*this); }
+  int k() const { return k_; }
+  int score_index() const { return score_index_; }
+  size_t window_size() const { return window_size_; }
+  bool descending() const { return descending_; }
+  TopKEmit emit() const { return emit_; }
+
+  void reset() override {
+    Operator::reset();
+    window_.clear();
+    top_.clear();
+    rest_.clear();
+    next_seq_ = 0;
+  }
+
+  Bytes collect_bytes() override {
+    Bytes bytes = Operator::collect_bytes();
+    bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&next_seq_),
+                 reinterpret_cast<const uint8_t*>(&next_seq_) + sizeof(next_seq_));
+    size_t n = window_.size();
+    bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&n),
+                 reinterpret_cast<const uint8_t*>(&n) + sizeof(n));
+    for (const auto& row : window_) {
+      size_t m = row.size();
+      bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&m),
+                   reinterpret_cast<const uint8_t*>(&m) + sizeof(m));
+      bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(row.data()),
+                   reinterpret_cast<const uint8_t*>(row.data() + m));
+    }
+    return bytes;
+  }
+
+  // The sets are not stored: they are the window's entries split by rank.
+  void restore(Bytes::const_iterator& it) override {
+    Operator::restore(it);
+    std::memcpy(&next_seq_, &(*it), sizeof(next_seq_));
+    it += sizeof(next_seq_);
+    size_t n;
+    std::memcpy(&n, &(*it), sizeof(n));
+    it += sizeof(n);
+    window_.clear();
+    for (size_t i = 0; i < n; ++i) {
+      size_t m;
+      std::memcpy(&m, &(*it), sizeof(m));
+      it += sizeof(m);
+      std::vector<double> row(m);
+      if (m > 0) std::memcpy(row.data(), &(*it), m * sizeof(double));
+      it += m * sizeof(double);
+      window_.push_back(std::move(row));
+    }
+
+    std::vector<Rank> ranks;
+    ranks.reserve(window_.size());
+    for (size_t i = 0; i < window_.size(); ++i) {
+      ranks.push_back({window_[i][score_index_], front_seq() + i});
+    }
+    std::sort(ranks.begin(), ranks.end(), Better{descending_});
+    const size_t top = std::min(ranks.size(), static_cast<size_t>(k_));
+    top_.clear();
+    rest_.clear();
+    top_.insert(ranks.begin(), ranks.begin() + top);
+    rest_.insert(ranks.begin() + top, ranks.end());
+  }
+
+ protected:
+  void process_data(bool debug = false) override {
+    auto& input_queue = get_data_queue(0);
+    while (!input_queue.empty()) {
+      const auto* msg = static_cast<const Message<VectorNumberData>*>(
+          input_queue.front().get());
+      if (!msg) throw std::runtime_error("WindowTopK: invalid message type");
+
+      if (score_index_ >= static_cast<int>(msg->data.size())) {
+        throw std::runtime_error("WindowTopK: score_index out of bounds");
+      }
+      const double score = msg->data[score_index_];
+      if (std::isnan(score)) throw std::runtime_error("WindowTopK: score is NaN");
+
+      if (window_.size() == window_size_) expire_front(msg->time, debug);
+      const auto row = msg->data.materialize();
+      window_.emplace_back(row->begin(), row->end());
+      insert({score, next_seq_++}, msg->time, debug);
+
+      if (emit_ == TopKEmit::Snapshot) {
+        size_t n = 0;
+        for (const Rank& r : top_) n += entry(r).size();
+        auto flat = make_pooled_vector_double(n);
+        double* dst = flat->data();
+        for (const Rank& r : top_) dst = std::copy(entry(r).begin(), entry(r).end(), dst);
+        emit_output(0, create_message<VectorNumberData>(msg->time, VectorNumberData(std::move(flat))), debug);
+      } else if (emit_ == TopKEmit::Full) {
+        for (const Rank& r : top_) emit_row(msg->time, entry(r), 0.0, debug);
+      }
+
+      input_queue.pop_front();
+    }
+  }
+
+ private:
+  struct Rank {
+    double score;
+    uint64_t seq;
+  };
+
+  // Best first; among equal scores the newer entry first.
+  struct Better {
+    bool descending;
+    bool operator()(const Rank& a, const Rank& b) const {
+      if (a.score != b.score) return descending ? a.score > b.score : a.score < b.score;
+      return a.seq > b.seq;
+    }
+  };
+
+  int k_;
+  int score_index_;
+  size_t window_size_;
+  bool descending_;
+  TopKEmit emit_;
+  std::deque<std::vector<double>> window_;  // last window_size_ entries, oldest first
+  uint64_t next_seq_{0};                    // sequence number of the next entry
+  std::set<Rank, Better> top_;              // at most k_ best entries in the window
+  std::set<Rank, Better> rest_;             // the other entries in the window
+
+  uint64_t front_seq() const { return next_seq_ - window_.size(); }
+  const std::vector<double>& entry(const Rank& r) const { return window_[r.seq - front_seq()]; }
+
+  void emit_row(timestamp_t time, const std::vector<double>& row, double change, bool debug) {
+    emit_output(0, create_message<VectorNumberData>(
+        time, VectorNumberData(detail::topk_row(row.data(), row.size(), change))), debug);
+  }
+
+  // Delta mode reports each move across the top-K boundary as it happens.
+  void moved(const Rank& r, double change, timestamp_t time, bool debug) {
+    if (emit_ == TopKEmit::Delta) emit_row(time, entry(r), change, debug);
+  }
+
+  void insert(const Rank& r, timestamp_t time, bool debug) {
+    if (top_.size() < static_cast<size_t>(k_)) {
+      top_.insert(r);
+      moved(r, 1.0, time, debug);
+      return;
+    }
+    auto worst = std::prev(top_.end());
+    if (!top_.key_comp()(r, *worst)) {
+      rest_.insert(r);
+      return;
+    }
+    top_.insert(r);
+    moved(r, 1.0, time, debug);
+    const Rank demoted = *worst;
+    top_.erase(worst);
+    rest_.insert(demoted);
+    moved(demoted, -1.0, time, debug);
+  }
+
+  void expire_front(timestamp_t time, bool debug) {
+    const Rank r{window_.front()[score_index_], front_seq()};
+    if (top_.erase(r) > 0) {
+      moved(r, -1.0, time, debug);
+      if (!rest_.empty()) {
+        const Rank promoted = *rest_.begin();
+        rest_.erase(rest_.begin());
+        top_.insert(promoted);
+        moved(promoted, 1.0, time, debug);
+      }
+    } else {
+      rest_.erase(r);
+    }
+    window_.pop_front();
+  }
+};
+
+inline std::shared_ptr<WindowTopK> make_window_topk(std::string id, int k, int score_index,
+                                                    size_t window_size, bool descending = true,
+                                                    TopKEmit emit = TopKEmit::Full) {
+  return std::make_shared<WindowTopK>(std::move(id), k, score_index, window_size, descending, emit);
+}
+
+}  // namespace rtbot
+
+#endif  // WINDOW_TOPK_H
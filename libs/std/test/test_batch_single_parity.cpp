@@ -1,10 +1,17 @@
 #include <catch2/catch.hpp>
+#include <functional>
 #include <memory>
 #include <vector>
 
 #include "rtbot/Collector.h"
 #include "rtbot/std/ArithmeticScalar.h"
+#include "rtbot/std/CompareScalar.h"
 #include "rtbot/std/CumulativeSum.h"
+#include "rtbot/std/Difference.h"
+#include "rtbot/std/FilterScalar.h"
+#include "rtbot/std/Linear.h"
+#include "rtbot/std/MovingAverage.h"
+#include "rtbot/std/MovingSum.h"
 
 using namespace rtbot;
 
@@ -15,8 +22,9 @@ namespace {
 // path) and collect the (time, value) outputs from port 0.
 std::vector<std::pair<timestamp_t, double>> drive_single(
     const std::shared_ptr<Operator>& op,
-    const std::vector<std::pair<timestamp_t, double>>& inputs) {
-  auto col = std::make_shared<Collector>("c_single", std::vector<std::string>{"number"});
+    const std::vector<std::pair<timestamp_t, double>>& inputs,
+    const std::string& out_type = "number") {
+  auto col = std::make_shared<Collector>("c_single", std::vector<std::string>{out_type});
   op->connect(col, 0, 0);
   for (const auto& [t, v] : inputs) {
     op->receive_data(create_message<NumberData>(t, NumberData{v}), 0);
@@ -24,10 +32,7 @@ std::vector<std::pair<timestamp_t, double>> drive_single(
   }
   std::vector<std::pair<timestamp_t, double>> out;
   auto& q = col->get_data_queue(0);
-  for (auto& msg : q) {
-    auto* m = dynamic_cast<const Message<NumberData>*>(msg.get());
-    out.emplace_back(m->time, m->data.value);
-  }
+  for (auto& msg : q) out.emplace_back(msg->time, scalar_value(*msg));
   return out;
 }
 
@@ -35,8 +40,9 @@ std::vector<std::pair<timestamp_t, double>> drive_single(
 // path when inputs.size() >= kEmitBatchThreshold.
 std::vector<std::pair<timestamp_t, double>> drive_batch(
     const std::shared_ptr<Operator>& op,
-    const std::vector<std::pair<timestamp_t, double>>& inputs) {
-  auto col = std::make_shared<Collector>("c_batch", std::vector<std::string>{"number"});
+    const std::vector<std::pair<timestamp_t, double>>& inputs,
+    const std::string& out_type = "number") {
+  auto col = std::make_shared<Collector>("c_batch", std::vector<std::string>{out_type});
   op->connect(col, 0, 0);
   for (const auto& [t, v] : inputs) {
     op->receive_data(create_message<NumberData>(t, NumberData{v}), 0);
@@ -44,10 +50,23 @@ std::vector<std::pair<timestamp_t, double>> drive_batch(
   op->execute();
   std::vector<std::pair<timestamp_t, double>> out;
   auto& q = col->get_data_queue(0);
-  for (auto& msg : q) {
-    auto* m = dynamic_cast<const Message<NumberData>*>(msg.get());
-    out.emplace_back(m->time, m->data.value);
-  }
+  for (auto& msg : q) out.emplace_back(msg->time, scalar_value(*msg));
+  return out;
+}
+
+// Same inputs handed over as one MessageBatch through receive_data_columns.
+std::vector<std::pair<timestamp_t, double>> drive_columns(
+    const std::shared_ptr<Operator>& op,
+    const std::vector<std::pair<timestamp_t, double>>& inputs,
+    const std::string& out_type = "number") {
+  auto col = std::make_shared<Collector>("c_columns", std::vector<std::string>{out_type});
+  op->connect(col, 0, 0);
+  MessageBatch<NumberData> batch;
+  for (const auto& [t, v] : inputs) batch.push_back(t, v);
+  op->receive_data_columns(batch, 0);
+  op->execute();
+  std::vector<std::pair<timestamp_t, double>> out;
+  for (auto& msg : col->get_data_queue(0)) out.emplace_back(msg->time, scalar_value(*msg));
   return out;
 }
 
@@ -95,6 +114,55 @@ SCENARIO("Batch-emit path produces identical outputs to single-emit path",
     }
   }
 
+  SECTION("Columnar kernels (MessageBatch) match the single-message path") {
+    using Factory = std::function<std::shared_ptr<Operator>(const std::string&)>;
+    const std::vector<std::pair<Factory, std::string>> ops = {
+        {[](const std::string& id) { return std::make_shared<Power>(id, 2.0); }, "number"},
+        {[](const std::string& id) { return std::make_shared<Sin>(id); }, "number"},
+        {[](const std::string& id) { return std::make_shared<CompareGT>(id, 1.0); }, "boolean"},
+        {[](const std::string& id) { return std::make_shared<CompareEQ>(id, 0.5); }, "boolean"},
+        {[](const std::string& id) { return std::make_shared<LessThan>(id, 4.0); }, "number"},
+        {[](const std::string& id) { return std::make_shared<NotEqualTo>(id, 2.0); }, "number"},
+        {[](const std::string& id) { return std::make_shared<MovingAverage>(id, 7); }, "number"},
+        {[](const std::string& id) { return std::make_shared<MovingSum>(id, 4); }, "number"},
+        {[](const std::string& id) { return make_difference(id); }, "number"},
+        {[](const std::string& id) { return make_difference(id, false); }, "number"},
+        {[](const std::string& id) { return make_cumulative_sum(id); }, "number"},
+    };
+    for (size_t n : sizes) {
+      auto in = ramp(n);
+      for (const auto& [make, out_type] : ops) {
+        auto expected = drive_single(make("single"), in, out_type);
+        REQUIRE(drive_batch(make("batch"), in, out_type) == expected);
+        REQUIRE(drive_columns(make("columns"), in, out_type) == expected);
+      }
+    }
+  }
+
+  SECTION("Linear (synchronized value ports)") {
+    for (size_t n : sizes) {
+      auto run = [n](bool batched) {
+        auto lin = make_linear("lin", {0.5, -2.0});
+        auto col = std::make_shared<Collector>("c", std::vector<std::string>{"number"});
+        lin->connect(col, 0, 0);
+        // Port 1 skips every third timestamp, so rows must be re-synchronized.
+        for (size_t i = 1; i <= n; ++i) {
+          const auto t = static_cast<timestamp_t>(i);
+          lin->receive_data(create_message<NumberData>(t, NumberData{0.25 * i}), 0);
+          if (i % 3 != 0) lin->receive_data(create_message<NumberData>(t, NumberData{1.0 - i}), 1);
+          if (!batched) lin->execute();
+        }
+        if (batched) lin->execute();
+        std::vector<std::pair<timestamp_t, double>> out;
+        for (auto& msg : col->get_data_queue(0)) out.emplace_back(msg->time, scalar_value(*msg));
+        return out;
+      };
+      auto single = run(false);
+      REQUIRE(single.size() == n - n / 3);
+      REQUIRE(run(true) == single);
+    }
+  }
+
   SECTION("Exactly at threshold boundary N=kEmitBatchThreshold") {
     auto in = ramp(kEmitBatchThreshold);
     auto a = std::make_shared<CumulativeSum>("b_s");
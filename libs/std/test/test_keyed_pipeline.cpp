@@ -1,9 +1,12 @@
 #include <catch2/catch.hpp>
+#include <filesystem>
 #include <memory>
+#include <random>
 #include <vector>
 
 #include "rtbot/Collector.h"
 #include "rtbot/std/CumulativeSum.h"
+#include "rtbot/std/Identity.h"
 #include "rtbot/std/KeyedPipeline.h"
 #include "rtbot/std/VectorExtract.h"
 #include "rtbot/std/VectorProject.h"
@@ -201,6 +204,98 @@ SCENARIO("KeyedPipeline serialization roundtrip", "[keyed_pipeline][State]") {
       REQUIRE((*msg->data.values)[1] == 500.0);  // 200 + 250 + 50
     }
   }
+
+  SECTION("Binary snapshot preserves per-key state and exact keys") {
+    auto factory = make_extract_cumsum_factory(1);
+    auto kp = make_keyed_pipeline("kp1", 0, factory);
+    const double fine_key = 0.1234567891;
+
+    kp->receive_data(create_message<VectorNumberData>(1, VectorNumberData{{fine_key, 100.0}}), 0);
+    kp->execute();
+    kp->receive_data(create_message<VectorNumberData>(2, VectorNumberData{{2.0, 200.0}}), 0);
+    kp->execute();
+
+    Bytes snapshot;
+    ByteWriter writer(snapshot);
+    kp->write_state(writer);
+
+    auto kp2 = make_keyed_pipeline("kp1", 0, factory);
+    auto col2 = std::make_shared<Collector>("c2", std::vector<std::string>{"vector_number"});
+    kp2->connect(col2, 0, 0);
+    ByteReader reader(snapshot);
+    kp2->read_state(reader);
+
+    REQUIRE(reader.at_end());
+    REQUIRE(kp2->num_keys() == 2);
+
+    kp2->receive_data(create_message<VectorNumberData>(3, VectorNumberData{{fine_key, 50.0}}), 0);
+    kp2->execute();
+
+    auto& out = col2->get_data_queue(0);
+    REQUIRE(out.size() == 1);
+    auto* msg = dynamic_cast<const Message<VectorNumberData>*>(out[0].get());
+    REQUIRE((*msg->data.values)[0] == fine_key);
+    REQUIRE((*msg->data.values)[1] == 150.0);
+    REQUIRE(kp2->num_keys() == 2);
+  }
+
+  SECTION("Delta checkpoints carry only the keys touched since the checkpoint") {
+    auto factory = make_extract_cumsum_factory(1);
+    auto kp = make_keyed_pipeline("kp1", 0, factory);
+    timestamp_t t = 1;
+    for (int key = 0; key < 50; key++) {
+      kp->receive_data(create_message<VectorNumberData>(t++, VectorNumberData{{double(key), 10.0}}), 0);
+      kp->execute();
+    }
+
+    Bytes base;
+    ByteWriter base_writer(base);
+    kp->write_state(base_writer);
+    kp->mark_checkpoint(1);
+
+    // Touch two existing keys and add a new one.
+    for (double key : {3.0, 7.0, 99.0}) {
+      kp->receive_data(create_message<VectorNumberData>(t++, VectorNumberData{{key, 5.0}}), 0);
+      kp->execute();
+    }
+    Bytes delta;
+    ByteWriter delta_writer(delta);
+    kp->write_delta(delta_writer, 1);
+    REQUIRE(delta.size() * 5 < base.size());
+
+    auto kp2 = make_keyed_pipeline("kp1", 0, factory);
+    auto col2 = std::make_shared<Collector>("c2", std::vector<std::string>{"vector_number"});
+    kp2->connect(col2, 0, 0);
+    ByteReader base_reader(base);
+    kp2->read_state(base_reader);
+    kp2->mark_checkpoint(1);
+    ByteReader delta_reader(delta);
+    kp2->read_delta(delta_reader);
+    REQUIRE(delta_reader.at_end());
+    REQUIRE(kp2->num_keys() == 51);
+
+    for (double key : {3.0, 4.0, 99.0}) {
+      kp2->receive_data(create_message<VectorNumberData>(t++, VectorNumberData{{key, 1.0}}), 0);
+      kp2->execute();
+    }
+    auto& out = col2->get_data_queue(0);
+    REQUIRE(out.size() == 3);
+    const double expected[] = {16.0, 11.0, 6.0};
+    for (size_t i = 0; i < 3; i++) {
+      auto* msg = dynamic_cast<const Message<VectorNumberData>*>(out[i].get());
+      REQUIRE((*msg->data.values)[1] == expected[i]);
+    }
+
+    // After reset() the next delta falls back to the full state.
+    kp->mark_checkpoint(2);
+    kp->reset();
+    Bytes after_reset;
+    ByteWriter reset_writer(after_reset);
+    kp->write_delta(reset_writer, 2);
+    ByteReader reset_reader(after_reset);
+    kp2->read_delta(reset_reader);
+    REQUIRE(kp2->num_keys() == 0);
+  }
 }
 
 SCENARIO("KeyedPipeline handles many keys", "[keyed_pipeline]") {
@@ -288,6 +383,411 @@ SCENARIO("KeyedPipeline validation", "[keyed_pipeline]") {
   }
 }
 
+static void send_row(const std::shared_ptr<KeyedPipeline>& kp, timestamp_t t, double key, double value) {
+  kp->receive_data(create_message<VectorNumberData>(t, VectorNumberData{{key, value}}), 0);
+  kp->execute();
+}
+
+SCENARIO("KeyedPipeline evicts keys", "[keyed_pipeline][eviction]") {
+  auto kp = make_keyed_pipeline("kp1", 0, make_extract_cumsum_factory(1));
+  auto col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+  kp->connect(col, 0, 0);
+  std::vector<double> evicted;
+  kp->set_evict_key_callback([&evicted](double key) { evicted.push_back(key); });
+
+  SECTION("A max-keys cap evicts the least recently used key") {
+    kp->set_eviction(2, 0);
+    send_row(kp, 1, 1.0, 10.0);
+    send_row(kp, 2, 2.0, 20.0);
+    send_row(kp, 3, 1.0, 10.0);  // key 2 is now least recently used
+    send_row(kp, 4, 3.0, 30.0);
+
+    REQUIRE(kp->num_keys() == 2);
+    REQUIRE(evicted == std::vector<double>{2.0});
+    REQUIRE(kp->has_key(1.0));
+    REQUIRE_FALSE(kp->has_key(2.0));
+    REQUIRE(kp->num_evicted() == 1);
+
+    // An evicted key that comes back starts from a fresh sub-graph.
+    col->reset();
+    send_row(kp, 5, 2.0, 5.0);
+    auto* msg = dynamic_cast<const Message<VectorNumberData>*>(col->get_data_queue(0)[0].get());
+    REQUIRE((*msg->data.values)[1] == 5.0);
+    REQUIRE(evicted == std::vector<double>{2.0, 1.0});
+  }
+
+  SECTION("An idle TTL evicts keys that have not seen a message for longer than it, in event time") {
+    kp->set_eviction(0, 10);
+    send_row(kp, 1, 1.0, 10.0);
+    send_row(kp, 5, 2.0, 20.0);
+    send_row(kp, 11, 3.0, 30.0);  // key 1 idle for exactly 10: kept
+    REQUIRE(kp->num_keys() == 3);
+    send_row(kp, 12, 3.0, 30.0);  // key 1 idle for 11: evicted
+    REQUIRE(evicted == std::vector<double>{1.0});
+    send_row(kp, 30, 2.0, 1.0);  // keys 2 and 3 expire; key 2 restarts from a fresh sub-graph
+    REQUIRE(evicted == std::vector<double>{1.0, 2.0, 3.0});
+    REQUIRE(kp->num_keys() == 1);
+    auto& out = col->get_data_queue(0);
+    auto* msg = dynamic_cast<const Message<VectorNumberData>*>(out[out.size() - 1].get());
+    REQUIRE((*msg->data.values)[1] == 1.0);
+  }
+
+  SECTION("Snapshots keep the recency order and deltas carry evictions") {
+    kp->set_eviction(3, 0);
+    for (timestamp_t t = 1; t <= 3; ++t) send_row(kp, t, static_cast<double>(t), 1.0);
+    send_row(kp, 4, 1.0, 1.0);  // recency: 2, 3, 1
+
+    Bytes base;
+    ByteWriter base_writer(base);
+    kp->write_state(base_writer);
+    kp->mark_checkpoint(1);
+
+    auto kp2 = make_keyed_pipeline("kp1", 0, make_extract_cumsum_factory(1));
+    kp2->set_eviction(3, 0);
+    ByteReader base_reader(base);
+    kp2->read_state(base_reader);
+    kp2->mark_checkpoint(1);
+
+    send_row(kp, 5, 4.0, 1.0);  // evicts key 2 from the original
+    Bytes delta;
+    ByteWriter delta_writer(delta);
+    kp->write_delta(delta_writer, 1);
+    ByteReader delta_reader(delta);
+    kp2->read_delta(delta_reader);
+    REQUIRE(delta_reader.at_end());
+    REQUIRE_FALSE(kp2->has_key(2.0));
+    REQUIRE(kp2->has_key(4.0));
+    REQUIRE(kp2->num_keys() == 3);
+
+    // Both now evict key 3 next.
+    send_row(kp, 6, 5.0, 1.0);
+    send_row(kp2, 6, 5.0, 1.0);
+    REQUIRE_FALSE(kp->has_key(3.0));
+    REQUIRE_FALSE(kp2->has_key(3.0));
+    REQUIRE(kp2->has_key(1.0));
+  }
+
+  SECTION("The eviction settings survive a JSON round trip") {
+    std::string json_str = R"({
+      "type": "KeyedPipeline", "id": "kp1", "key_index": 0, "maxKeys": 100, "idleTtl": 50,
+      "prototype": {
+        "entry": {"operator": "proj"}, "output": {"operator": "proj"},
+        "operators": [{"type": "VectorProject", "id": "proj", "indices": [1]}],
+        "connections": []
+      }
+    })";
+    auto restored = std::dynamic_pointer_cast<KeyedPipeline>(OperatorJson::read_op(json_str));
+    REQUIRE(restored->get_max_keys() == 100);
+    REQUIRE(restored->get_idle_ttl() == 50);
+    auto j = nlohmann::json::parse(OperatorJson::write_op(restored));
+    REQUIRE(j["maxKeys"] == 100);
+    REQUIRE(j["idleTtl"] == 50);
+  }
+}
+
+struct KeyedRow {
+  timestamp_t time;
+  double key;
+  double value;
+};
+
+// Queues every row, then runs a single execute() over the burst.
+static void send_burst(const std::shared_ptr<KeyedPipeline>& kp, const std::vector<KeyedRow>& rows) {
+  for (const auto& row : rows) {
+    kp->receive_data(create_message<VectorNumberData>(row.time, VectorNumberData{{row.key, row.value}}), 0);
+  }
+  kp->execute();
+}
+
+static std::vector<std::pair<timestamp_t, std::vector<double>>> drain(const std::shared_ptr<Collector>& col) {
+  std::vector<std::pair<timestamp_t, std::vector<double>>> out;
+  auto& queue = col->get_data_queue(0);
+  for (const auto& msg : queue) {
+    const auto* vec = static_cast<const Message<VectorNumberData>*>(msg.get());
+    out.emplace_back(vec->time, *vec->data.materialize());
+  }
+  queue.clear();
+  return out;
+}
+
+SCENARIO("KeyedPipeline parallel mode matches serial mode", "[keyed_pipeline][parallel]") {
+  auto serial = make_keyed_pipeline("kp1", 0, make_extract_cumsum_factory(1));
+  auto parallel = make_keyed_pipeline("kp1", 0, make_extract_cumsum_factory(1));
+  parallel->set_threads(4);
+  REQUIRE(parallel->get_threads() == 4);
+  REQUIRE(serial->get_threads() == 1);
+
+  auto serial_col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+  auto parallel_col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+  serial->connect(serial_col, 0, 0);
+  parallel->connect(parallel_col, 0, 0);
+
+  std::vector<double> serial_keys;
+  std::vector<double> parallel_keys;
+
+  std::mt19937 rng(11);
+  timestamp_t t = 0;
+  auto burst = [&](size_t rows, int keys) {
+    std::uniform_int_distribution<int> key(0, keys - 1);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::vector<KeyedRow> out;
+    for (size_t i = 0; i < rows; ++i) out.push_back({++t, static_cast<double>(key(rng)), value(rng)});
+    return out;
+  };
+
+  SECTION("Bursts over many keys produce the same outputs in the same order") {
+    serial->set_new_key_callback([&](double key) { serial_keys.push_back(key); });
+    parallel->set_new_key_callback([&](double key) { parallel_keys.push_back(key); });
+    for (int b = 0; b < 20; ++b) {
+      const auto rows = burst(500, 64);
+      send_burst(serial, rows);
+      send_burst(parallel, rows);
+      const auto expected = drain(serial_col);
+      REQUIRE(expected.size() == rows.size());
+      REQUIRE(drain(parallel_col) == expected);
+    }
+    REQUIRE(parallel_keys == serial_keys);
+    REQUIRE(*parallel == *serial);
+  }
+
+  SECTION("Evictions in the middle of a burst happen at the same rows") {
+    serial->set_eviction(16, 40);
+    parallel->set_eviction(16, 40);
+    serial->set_evict_key_callback([&](double key) { serial_keys.push_back(key); });
+    parallel->set_evict_key_callback([&](double key) { parallel_keys.push_back(key); });
+    for (int b = 0; b < 20; ++b) {
+      const auto rows = burst(300, 40);
+      send_burst(serial, rows);
+      send_burst(parallel, rows);
+      REQUIRE(drain(parallel_col) == drain(serial_col));
+    }
+    REQUIRE_FALSE(serial_keys.empty());
+    REQUIRE(parallel_keys == serial_keys);
+    REQUIRE(parallel->num_keys() == serial->num_keys());
+  }
+
+  SECTION("Spilling in the middle of a burst keeps the outputs") {
+    parallel->set_spill(8);
+    for (int b = 0; b < 10; ++b) {
+      const auto rows = burst(300, 40);
+      send_burst(serial, rows);
+      send_burst(parallel, rows);
+      REQUIRE(drain(parallel_col) == drain(serial_col));
+    }
+    REQUIRE(parallel->spill_stats().spills > 0);
+    REQUIRE(*parallel == *serial);
+  }
+
+  SECTION("A row without a key fails the burst after the rows before it have run") {
+    auto rows = burst(50, 8);
+    std::vector<KeyedRow> good(rows.begin(), rows.begin() + 20);
+    for (auto* kp : {&serial, &parallel}) {
+      for (const auto& row : good) {
+        (*kp)->receive_data(create_message<VectorNumberData>(row.time, VectorNumberData{{row.key, row.value}}), 0);
+      }
+      (*kp)->receive_data(create_message<VectorNumberData>(t + 1, VectorNumberData(std::vector<double>{})), 0);
+      REQUIRE_THROWS_AS((*kp)->execute(), std::runtime_error);
+    }
+    REQUIRE(drain(parallel_col) == drain(serial_col));
+  }
+
+  SECTION("The thread count survives a JSON round trip") {
+    std::string json_str = R"({
+      "type": "KeyedPipeline", "id": "kp1", "key_index": 0, "threads": 3,
+      "prototype": {
+        "entry": {"operator": "proj"}, "output": {"operator": "proj"},
+        "operators": [{"type": "VectorProject", "id": "proj", "indices": [1]}],
+        "connections": []
+      }
+    })";
+    auto restored = std::dynamic_pointer_cast<KeyedPipeline>(OperatorJson::read_op(json_str));
+    REQUIRE(restored->get_threads() == 3);
+    auto j = nlohmann::json::parse(OperatorJson::write_op(restored));
+    REQUIRE(j["threads"] == 3);
+  }
+}
+
+SCENARIO("KeyedPipeline spills cold keys", "[keyed_pipeline][spill]") {
+  auto reference = make_keyed_pipeline("kp1", 0, make_extract_cumsum_factory(1));
+  auto spilled = make_keyed_pipeline("kp1", 0, make_extract_cumsum_factory(1));
+  const std::string dir = std::filesystem::temp_directory_path().string();
+  spilled->set_spill(4, dir);
+  REQUIRE(spilled->spill_store()->file_backed());
+
+  auto reference_col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+  auto spilled_col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+  reference->connect(reference_col, 0, 0);
+  spilled->connect(spilled_col, 0, 0);
+
+  std::mt19937 rng(17);
+  std::uniform_int_distribution<int> key(0, 29);
+  timestamp_t t = 0;
+  auto feed = [&](const std::vector<std::shared_ptr<KeyedPipeline>>& targets, int rows) {
+    for (int i = 0; i < rows; ++i) {
+      const double k = key(rng);
+      ++t;
+      for (const auto& kp : targets) send_row(kp, t, k, k + 0.5);
+    }
+  };
+
+  feed({reference, spilled}, 600);
+
+  THEN("Outputs match a pipeline that keeps every key in memory") {
+    REQUIRE(drain(spilled_col) == drain(reference_col));
+    REQUIRE(spilled->num_keys() == 30);
+    REQUIRE(spilled->num_hot_keys() == 4);
+    REQUIRE(spilled->num_cold_keys() == 26);
+    const auto& stats = spilled->spill_stats();
+    REQUIRE(stats.hits + stats.misses + spilled->num_keys() == 600);
+    REQUIRE(stats.misses > 0);
+    REQUIRE(stats.spills == stats.misses + 26);
+    REQUIRE(*spilled == *reference);
+  }
+
+  THEN("Snapshots hold the spilled keys and restore into either mode") {
+    Bytes spilled_state;
+    ByteWriter spilled_writer(spilled_state);
+    spilled->write_state(spilled_writer);
+    Bytes reference_state;
+    ByteWriter reference_writer(reference_state);
+    reference->write_state(reference_writer);
+    REQUIRE(spilled_state == reference_state);
+
+    auto restored = make_keyed_pipeline("kp1", 0, make_extract_cumsum_factory(1));
+    restored->set_spill(3);
+    ByteReader reader(spilled_state);
+    restored->read_state(reader);
+    REQUIRE(restored->num_hot_keys() == 3);
+    REQUIRE(*restored == *reference);
+
+    auto restored_col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+    restored->connect(restored_col, 0, 0);
+    drain(reference_col);
+    feed({reference, restored}, 200);
+    REQUIRE(drain(restored_col) == drain(reference_col));
+  }
+
+  THEN("Delta checkpoints cover keys spilled since the last checkpoint") {
+    Bytes base;
+    ByteWriter base_writer(base);
+    spilled->write_state(base_writer);
+    spilled->mark_checkpoint(1);
+    auto replica = make_keyed_pipeline("kp1", 0, make_extract_cumsum_factory(1));
+    ByteReader base_reader(base);
+    replica->read_state(base_reader);
+
+    feed({reference, spilled}, 100);
+    Bytes delta;
+    ByteWriter delta_writer(delta);
+    spilled->write_delta(delta_writer, 1);
+    ByteReader delta_reader(delta);
+    replica->read_delta(delta_reader);
+    REQUIRE(delta_reader.at_end());
+    REQUIRE(*replica == *reference);
+  }
+
+  THEN("Turning spilling off reads every key back") {
+    spilled->set_spill(0);
+    REQUIRE(spilled->spill_store() == nullptr);
+    REQUIRE(spilled->num_cold_keys() == 0);
+    REQUIRE(*spilled == *reference);
+  }
+
+  THEN("Evictions reach spilled keys") {
+    spilled->set_eviction(10, 0);
+    REQUIRE(spilled->num_keys() == 10);
+    REQUIRE(spilled->num_hot_keys() == 4);
+    REQUIRE(spilled->spill_store()->size() == 6);
+  }
+
+  THEN("The spill settings survive a JSON round trip") {
+    nlohmann::json j = nlohmann::json::parse(R"({
+      "type": "KeyedPipeline", "id": "kp1", "key_index": 0, "hotKeys": 1000,
+      "prototype": {
+        "entry": {"operator": "proj"}, "output": {"operator": "proj"},
+        "operators": [{"type": "VectorProject", "id": "proj", "indices": [1]}],
+        "connections": []
+      }
+    })");
+    j["spillDir"] = dir;
+    auto restored = std::dynamic_pointer_cast<KeyedPipeline>(OperatorJson::read_op(j.dump()));
+    REQUIRE(restored->get_hot_keys() == 1000);
+    REQUIRE(restored->get_spill_dir() == dir);
+    auto written = nlohmann::json::parse(OperatorJson::write_op(restored));
+    REQUIRE(written["hotKeys"] == 1000);
+    REQUIRE(written["spillDir"] == dir);
+  }
+}
+
+// Clones as a plain Identity, so SubGraphPrototype must use its fallback.
+struct UncloneableIdentity : Identity {
+  using Identity::Identity;
+};
+
+SCENARIO("KeyedPipeline compiled prototype", "[keyed_pipeline]") {
+  SECTION("Each key gets its own clones of the template operators") {
+    auto ext = std::make_shared<VectorExtract>("ext", 1);
+    auto sum = std::make_shared<CumulativeSum>("sum");
+
+    SubGraphPrototype prototype;
+    prototype.add_operator(ext, nullptr);
+    prototype.add_operator(sum, nullptr);
+    prototype.add_connection("ext", "sum", 0, 0, PortKind::DATA);
+    prototype.set_entry("ext");
+    prototype.set_output("sum");
+
+    auto sg = prototype.instantiate();
+    REQUIRE(sg.operators.size() == 2);
+    REQUIRE(sg.entry != ext);
+    REQUIRE(sg.entry->type_name() == "VectorExtract");
+    REQUIRE(sg.entry->num_data_ports() == 1);
+    REQUIRE(sg.output->type_name() == "CumulativeSum");
+
+    auto kp = make_keyed_pipeline("kp1", 0, [&prototype]() { return prototype.instantiate(); });
+    auto col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+    kp->connect(col, 0, 0);
+    kp->receive_data(create_message<VectorNumberData>(2, VectorNumberData{{1.0, 5.0}}), 0);
+    kp->execute();
+    kp->receive_data(create_message<VectorNumberData>(3, VectorNumberData{{2.0, 7.0}}), 0);
+    kp->execute();
+    kp->receive_data(create_message<VectorNumberData>(4, VectorNumberData{{1.0, 5.0}}), 0);
+    kp->execute();
+
+    auto& out = col->get_data_queue(0);
+    REQUIRE(out.size() == 3);
+    const double expected[] = {5.0, 7.0, 10.0};
+    for (size_t i = 0; i < 3; i++) {
+      auto* msg = dynamic_cast<const Message<VectorNumberData>*>(out[i].get());
+      REQUIRE((*msg->data.values)[1] == expected[i]);
+    }
+  }
+
+  SECTION("Operators that cannot be cloned are built by their fallback") {
+    int built = 0;
+    SubGraphPrototype prototype;
+    prototype.add_operator(std::make_shared<UncloneableIdentity>("id"), [&built]() {
+      ++built;
+      return std::make_shared<UncloneableIdentity>("id");
+    });
+    prototype.set_entry("id");
+    prototype.set_output("id");
+
+    auto sg = prototype.instantiate();
+    REQUIRE(built == 1);
+    REQUIRE(dynamic_cast<UncloneableIdentity*>(sg.entry.get()) != nullptr);
+    REQUIRE_THROWS_AS(prototype.add_operator(std::make_shared<UncloneableIdentity>("other"), nullptr),
+                      std::runtime_error);
+  }
+
+  SECTION("Unknown operator ids are rejected") {
+    SubGraphPrototype prototype;
+    prototype.add_operator(std::make_shared<Identity>("id"), nullptr);
+    REQUIRE_THROWS_AS(prototype.add_connection("id", "missing", 0, 0, PortKind::DATA), std::runtime_error);
+    REQUIRE_THROWS_AS(prototype.set_output("missing"), std::runtime_error);
+    REQUIRE_THROWS_AS(prototype.add_operator(std::make_shared<Identity>("id"), nullptr), std::runtime_error);
+  }
+}
+
 // --- Computed key mode tests ---
 
 SCENARIO("KeyedPipeline computed key: basic routing with 2-column hash", "[keyed_pipeline][computed_key]") {
@@ -1,7 +1,10 @@
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include <memory>
+#include <random>
 
 #include "rtbot/Collector.h"
+#include "rtbot/OperatorJson.h"
 #include "rtbot/std/MovingKeyCount.h"
 
 using namespace rtbot;
@@ -128,3 +131,80 @@ SCENARIO("MovingKeyCount rejects window_size=0", "[moving_key_count]") {
     REQUIRE_THROWS_AS(std::make_shared<MovingKeyCount>("mkc1", 0), std::runtime_error);
   }
 }
+
+SCENARIO("MovingKeyCount count_min mode bounds the exact counts", "[moving_key_count]") {
+  auto exact = std::make_shared<MovingKeyCount>("mkc1", 500);
+  auto approx = make_moving_key_count("mkc1", 500, 0.01, 0.01, 5);
+  auto exact_col = std::make_shared<Collector>("c", std::vector<std::string>{"number"});
+  auto approx_col = std::make_shared<Collector>("c", std::vector<std::string>{"number"});
+  exact->connect(exact_col, 0, 0);
+  approx->connect(approx_col, 0, 0);
+  REQUIRE(approx->is_count_min());
+  REQUIRE_FALSE(exact->is_count_min());
+  REQUIRE(exact->get_sketch() == nullptr);
+
+  std::mt19937 rng(21);
+  std::uniform_int_distribution<int> key(0, 49);
+  std::vector<double> keys;
+  for (int i = 1; i <= 3000; i++) {
+    const double k = key(rng);
+    keys.push_back(k);
+    exact->receive_data(create_message<NumberData>(i, NumberData{k}), 0);
+    approx->receive_data(create_message<NumberData>(i, NumberData{k}), 0);
+  }
+  exact->execute();
+  approx->execute();
+
+  auto& exact_out = exact_col->get_data_queue(0);
+  auto& approx_out = approx_col->get_data_queue(0);
+  REQUIRE(approx_out.size() == exact_out.size());
+  size_t over_bound = 0;
+  for (size_t i = 0; i < exact_out.size(); i++) {
+    const double e = dynamic_cast<const Message<NumberData>*>(exact_out[i].get())->data.value;
+    const double a = dynamic_cast<const Message<NumberData>*>(approx_out[i].get())->data.value;
+    REQUIRE(a >= e);
+    // The sketch also counts the keys of its oldest pane (100 keys) that
+    // have not expired yet: five full panes plus the current one.
+    const size_t live = std::min(i + 1, 500 + i % 100 + 1);
+    double covered = 0;
+    for (size_t j = i + 1 - live; j <= i; j++) covered += keys[j] == keys[i];
+    if (a - covered > 0.01 * live) over_bound++;
+  }
+  REQUIRE(over_bound <= 0.01 * exact_out.size());
+
+  THEN("State round trips, sketch included") {
+    auto restored = make_moving_key_count("mkc1", 500, 0.01, 0.01, 5);
+    restored->restore_data_from_json(approx->collect());
+    REQUIRE(*restored == *approx);
+    REQUIRE_FALSE(*restored == *make_moving_key_count("mkc1", 500, 0.01, 0.01, 5));
+    REQUIRE_FALSE(*exact == *std::make_shared<MovingKeyCount>("mkc1", 500, 0.01, 0.01, 5));
+  }
+
+  THEN("reset() clears the sketch") {
+    approx->reset();
+    REQUIRE(*approx == *make_moving_key_count("mkc1", 500, 0.01, 0.01, 5));
+  }
+}
+
+SCENARIO("MovingKeyCount JSON mode", "[moving_key_count]") {
+  auto exact = OperatorJson::read_op(R"({"type": "MovingKeyCount", "id": "mkc1", "window_size": 20})");
+  REQUIRE_FALSE(std::dynamic_pointer_cast<MovingKeyCount>(exact)->is_count_min());
+  REQUIRE(OperatorJson::write_op(exact).find("mode") == std::string::npos);
+
+  auto defaults = std::dynamic_pointer_cast<MovingKeyCount>(OperatorJson::read_op(
+      R"({"type": "MovingKeyCount", "id": "mkc1", "window_size": 20, "mode": "count_min"})"));
+  REQUIRE(defaults->get_sketch()->epsilon() == 0.001);
+  REQUIRE(defaults->get_sketch()->delta() == 0.01);
+  REQUIRE(defaults->get_sketch()->panes() == 8);
+
+  auto original = make_moving_key_count("mkc1", 1000, 0.005, 0.02, 4);
+  auto restored = std::dynamic_pointer_cast<MovingKeyCount>(OperatorJson::read_op(OperatorJson::write_op(original)));
+  REQUIRE(restored->is_count_min());
+  REQUIRE(*restored == *original);
+
+  REQUIRE_THROWS_AS(OperatorJson::read_op(R"({"type": "MovingKeyCount", "id": "m", "window_size": 5, "mode": "cms"})"),
+                    std::runtime_error);
+  REQUIRE_THROWS_AS(OperatorJson::read_op(
+                        R"({"type": "MovingKeyCount", "id": "m", "window_size": 5, "mode": "count_min", "epsilon": 0})"),
+                    std::runtime_error);
+}
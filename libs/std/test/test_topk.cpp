@@ -131,3 +131,48 @@ SCENARIO("TopK serialization roundtrip", "[topk][State]") {
     REQUIRE((*m1->data.values)[0] == Approx(150.0));
   }
 }
+
+SCENARIO("TopK delta and snapshot emission", "[topk]") {
+  auto run = [](TopKEmit emit) {
+    auto topk = make_topk("t1", 3, 1, true, emit);
+    auto col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+    topk->connect(col, 0, 0);
+    const double rows[][2] = {{1, 100}, {2, 200}, {3, 150}, {4, 50}, {5, 180}};
+    for (size_t i = 0; i < 5; ++i) {
+      topk->receive_data(create_message<VectorNumberData>(
+          static_cast<timestamp_t>(i + 1), VectorNumberData{{rows[i][0], rows[i][1]}}), 0);
+    }
+    topk->execute();
+    std::vector<std::pair<timestamp_t, std::vector<double>>> out;
+    for (const auto& msg : col->get_data_queue(0)) {
+      const auto* m = static_cast<const Message<VectorNumberData>*>(msg.get());
+      out.push_back({m->time, *m->data.materialize()});
+    }
+    return out;
+  };
+
+  SECTION("Delta emits only entries entering and leaving the top set") {
+    const auto out = run(TopKEmit::Delta);
+    // t=4 (score 50) cannot enter a full set and emits nothing; t=5 enters
+    // and pushes out [1,100].
+    using Row = std::pair<timestamp_t, std::vector<double>>;
+    REQUIRE(out == std::vector<Row>{{1, {1, 1, 100}},
+                                    {2, {1, 2, 200}},
+                                    {3, {1, 3, 150}},
+                                    {5, {1, 5, 180}},
+                                    {5, {-1, 1, 100}}});
+  }
+
+  SECTION("Snapshot emits one flattened message per input") {
+    const auto out = run(TopKEmit::Snapshot);
+    REQUIRE(out.size() == 5);
+    REQUIRE(out[3].first == 4);
+    REQUIRE(out[3].second == std::vector<double>{2, 200, 3, 150, 1, 100});
+    REQUIRE(out[4].second == std::vector<double>{2, 200, 5, 180, 3, 150});
+  }
+
+  SECTION("Emission mode is rejected when unknown") {
+    REQUIRE(topk_emit_from_string("delta") == TopKEmit::Delta);
+    REQUIRE_THROWS_AS(topk_emit_from_string("changes"), std::runtime_error);
+  }
+}
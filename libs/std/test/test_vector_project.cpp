@@ -2,6 +2,7 @@
 #include <memory>
 
 #include "rtbot/Collector.h"
+#include "rtbot/std/VectorExtract.h"
 #include "rtbot/std/VectorProject.h"
 
 using namespace rtbot;
@@ -21,9 +22,9 @@ SCENARIO("VectorProject selects subset of fields", "[vector_project]") {
     REQUIRE(output.size() == 1);
     auto* msg = dynamic_cast<const Message<VectorNumberData>*>(output[0].get());
     REQUIRE(msg->time == 1);
-    REQUIRE(msg->data.values->size() == 2);
-    REQUIRE((*msg->data.values)[0] == 10.0);
-    REQUIRE((*msg->data.values)[1] == 30.0);
+    REQUIRE(msg->data.size() == 2);
+    REQUIRE(msg->data[0] == 10.0);
+    REQUIRE(msg->data[1] == 30.0);
   }
 
   SECTION("Reorder fields") {
@@ -37,10 +38,10 @@ SCENARIO("VectorProject selects subset of fields", "[vector_project]") {
     auto& output = col->get_data_queue(0);
     REQUIRE(output.size() == 1);
     auto* msg = dynamic_cast<const Message<VectorNumberData>*>(output[0].get());
-    REQUIRE(msg->data.values->size() == 3);
-    REQUIRE((*msg->data.values)[0] == 30.0);
-    REQUIRE((*msg->data.values)[1] == 10.0);
-    REQUIRE((*msg->data.values)[2] == 20.0);
+    REQUIRE(msg->data.size() == 3);
+    REQUIRE(msg->data[0] == 30.0);
+    REQUIRE(msg->data[1] == 10.0);
+    REQUIRE(msg->data[2] == 20.0);
   }
 
   SECTION("Single index") {
@@ -54,8 +55,78 @@ SCENARIO("VectorProject selects subset of fields", "[vector_project]") {
     auto& output = col->get_data_queue(0);
     REQUIRE(output.size() == 1);
     auto* msg = dynamic_cast<const Message<VectorNumberData>*>(output[0].get());
-    REQUIRE(msg->data.values->size() == 1);
-    REQUIRE((*msg->data.values)[0] == 20.0);
+    REQUIRE(msg->data.size() == 1);
+    REQUIRE(msg->data[0] == 20.0);
+  }
+}
+
+SCENARIO("VectorProject shares the input buffer for strided indices", "[vector_project]") {
+  auto input = create_message<VectorNumberData>(1, VectorNumberData{{0.0, 10.0, 20.0, 30.0, 40.0, 50.0, 60.0}});
+  const auto parent = input->data.values;
+
+  SECTION("Arithmetic progressions become views") {
+    auto proj = make_vector_project("proj1", {1, 3, 5});
+    auto col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+    proj->connect(col, 0, 0);
+    proj->receive_data(std::move(input), 0);
+    proj->execute();
+
+    auto* msg = dynamic_cast<const Message<VectorNumberData>*>(col->get_data_queue(0)[0].get());
+    REQUIRE(msg->data.values == parent);
+    REQUIRE(msg->data.size() == 3);
+    REQUIRE(msg->data[0] == 10.0);
+    REQUIRE(msg->data[1] == 30.0);
+    REQUIRE(msg->data[2] == 50.0);
+    REQUIRE(msg->data.contiguous_data() == nullptr);
+    REQUIRE(*msg->data.materialize() == std::vector<double>{10.0, 30.0, 50.0});
+  }
+
+  SECTION("Chained projections and extracts read through the view") {
+    auto range = make_vector_project("range", {2, 3, 4, 5, 6});
+    auto every_other = make_vector_project("every_other", {0, 2, 4});
+    auto extract = make_vector_extract("x", 1);
+    auto vec_col = std::make_shared<Collector>("vc", std::vector<std::string>{"vector_number"});
+    auto num_col = std::make_shared<Collector>("nc", std::vector<std::string>{"number"});
+    range->connect(every_other, 0, 0);
+    every_other->connect(vec_col, 0, 0);
+    every_other->connect(extract, 0, 0);
+    extract->connect(num_col, 0, 0);
+
+    range->receive_data(std::move(input), 0);
+    range->execute();
+
+    auto* msg = dynamic_cast<const Message<VectorNumberData>*>(vec_col->get_data_queue(0)[0].get());
+    REQUIRE(msg->data.values == parent);
+    REQUIRE(*msg->data.materialize() == std::vector<double>{20.0, 40.0, 60.0});
+    auto* num = dynamic_cast<const Message<NumberData>*>(num_col->get_data_queue(0)[0].get());
+    REQUIRE(num->data.value == 40.0);
+  }
+
+  SECTION("Views serialize as their elements only") {
+    auto proj = make_vector_project("proj1", {4, 5});
+    auto col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+    proj->connect(col, 0, 0);
+    proj->receive_data(std::move(input), 0);
+    proj->execute();
+
+    const auto& view = *col->get_data_queue(0)[0];
+    auto restored = BaseMessage::deserialize_as<VectorNumberData>(view.serialize());
+    REQUIRE_FALSE(restored->data.is_view());
+    REQUIRE(*restored->data.values == std::vector<double>{40.0, 50.0});
+    REQUIRE(restored->hash() == view.hash());
+  }
+
+  SECTION("Other index lists are gathered into a new buffer") {
+    auto proj = make_vector_project("proj1", {3, 1});
+    auto col = std::make_shared<Collector>("c", std::vector<std::string>{"vector_number"});
+    proj->connect(col, 0, 0);
+    proj->receive_data(std::move(input), 0);
+    proj->execute();
+
+    auto* msg = dynamic_cast<const Message<VectorNumberData>*>(col->get_data_queue(0)[0].get());
+    REQUIRE(msg->data.values != parent);
+    REQUIRE_FALSE(msg->data.is_view());
+    REQUIRE(*msg->data.values == std::vector<double>{30.0, 10.0});
   }
 }
 
@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "rtbot/Collector.h"
+#include "rtbot/OperatorJson.h"
+#include "rtbot/std/WindowTopK.h"
+
+using namespace rtbot;
+
+namespace {
+
+using Row = std::vector<double>;  // [id, score]
+
+std::vector<Row> make_rows(size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  // Few distinct scores, so ties are common.
+  std::uniform_int_distribution<int> score(0, 20);
+  std::vector<Row> rows;
+  for (size_t i = 0; i < n; ++i) rows.push_back({static_cast<double>(i), static_cast<double>(score(rng))});
+  return rows;
+}
+
+// Top k of the last `window` rows up to and including row i: best score
+// first, newer first among equal scores.
+std::vector<Row> reference(const std::vector<Row>& rows, size_t i, size_t window, size_t k, bool descending) {
+  const size_t begin = i + 1 > window ? i + 1 - window : 0;
+  std::vector<Row> in(rows.begin() + begin, rows.begin() + i + 1);
+  std::stable_sort(in.begin(), in.end(), [descending](const Row& a, const Row& b) {
+    if (a[1] != b[1]) return descending ? a[1] > b[1] : a[1] < b[1];
+    return a[0] > b[0];
+  });
+  in.resize(std::min(in.size(), k));
+  return in;
+}
+
+std::vector<std::vector<double>> drain(Collector& col) {
+  std::vector<std::vector<double>> out;
+  for (const auto& msg : col.get_data_queue(0)) {
+    out.push_back(*static_cast<const Message<VectorNumberData>*>(msg.get())->data.materialize());
+  }
+  col.get_data_queue(0).clear();
+  return out;
+}
+
+}  // namespace
+
+SCENARIO("WindowTopK tracks the top entries of a sliding window", "[window_topk]") {
+  const auto rows = make_rows(600, 3);
+
+  for (bool descending : {true, false}) {
+    for (size_t window : {size_t{1}, size_t{4}, size_t{37}}) {
+      const size_t k = 5;
+      auto full = make_window_topk("full", static_cast<int>(k), 1, window, descending);
+      auto delta = make_window_topk("delta", static_cast<int>(k), 1, window, descending, TopKEmit::Delta);
+      auto snapshot = make_window_topk("snap", static_cast<int>(k), 1, window, descending, TopKEmit::Snapshot);
+      auto full_col = make_vector_number_collector("c1");
+      auto delta_col = make_vector_number_collector("c2");
+      auto snapshot_col = make_vector_number_collector("c3");
+      full->connect(full_col, 0, 0);
+      delta->connect(delta_col, 0, 0);
+      snapshot->connect(snapshot_col, 0, 0);
+
+      std::set<Row> replayed;  // top set rebuilt from the deltas
+      for (size_t i = 0; i < rows.size(); ++i) {
+        for (auto* op : {full.get(), delta.get(), snapshot.get()}) {
+          op->receive_data(create_message<VectorNumberData>(static_cast<timestamp_t>(i + 1), VectorNumberData(rows[i])),
+                           0);
+          op->execute();
+        }
+        const auto expected = reference(rows, i, window, k, descending);
+        REQUIRE(drain(*full_col) == expected);
+
+        std::vector<double> flat;
+        for (const auto& r : expected) flat.insert(flat.end(), r.begin(), r.end());
+        const auto snap = drain(*snapshot_col);
+        REQUIRE(snap.size() == 1);
+        REQUIRE(snap[0] == flat);
+
+        for (const auto& change : drain(*delta_col)) {
+          const Row row(change.begin() + 1, change.end());
+          if (change[0] > 0) {
+            REQUIRE(replayed.insert(row).second);
+          } else {
+            REQUIRE(replayed.erase(row) == 1);
+          }
+        }
+        REQUIRE(replayed == std::set<Row>(expected.begin(), expected.end()));
+      }
+    }
+  }
+}
+
+SCENARIO("WindowTopK serialization roundtrip", "[window_topk][State]") {
+  const auto rows = make_rows(200, 9);
+  auto topk = make_window_topk("w", 3, 1, 10, true);
+  for (size_t i = 0; i < 100; ++i) {
+    topk->receive_data(create_message<VectorNumberData>(static_cast<timestamp_t>(i + 1), VectorNumberData(rows[i])), 0);
+  }
+  topk->execute();
+
+  auto restored = make_window_topk("w", 3, 1, 10, true);
+  restored->restore_data_from_json(topk->collect());
+
+  auto col = make_vector_number_collector("c");
+  auto restored_col = make_vector_number_collector("rc");
+  topk->connect(col, 0, 0);
+  restored->connect(restored_col, 0, 0);
+  for (size_t i = 100; i < rows.size(); ++i) {
+    for (auto* op : {topk.get(), restored.get()}) {
+      op->receive_data(create_message<VectorNumberData>(static_cast<timestamp_t>(i + 1), VectorNumberData(rows[i])), 0);
+      op->execute();
+    }
+    REQUIRE(drain(*restored_col) == drain(*col));
+  }
+}
+
+SCENARIO("WindowTopK validates its configuration", "[window_topk]") {
+  REQUIRE_THROWS_AS(make_window_topk("w", 0, 0, 5), std::runtime_error);
+  REQUIRE_THROWS_AS(make_window_topk("w", 2, -1, 5), std::runtime_error);
+  REQUIRE_THROWS_AS(make_window_topk("w", 2, 0, 0), std::runtime_error);
+
+  auto topk = make_window_topk("w", 2, 3, 5);
+  topk->receive_data(create_message<VectorNumberData>(1, VectorNumberData({1.0, 2.0})), 0);
+  REQUIRE_THROWS_AS(topk->execute(), std::runtime_error);
+}
+
+SCENARIO("WindowTopK and TopK emission modes in JSON", "[window_topk]") {
+  auto restored = OperatorJson::read_op(OperatorJson::write_op(make_window_topk("w", 4, 2, 50, false, TopKEmit::Delta)));
+  auto* wtk = dynamic_cast<WindowTopK*>(restored.get());
+  REQUIRE(wtk != nullptr);
+  REQUIRE(wtk->k() == 4);
+  REQUIRE(wtk->score_index() == 2);
+  REQUIRE(wtk->window_size() == 50);
+  REQUIRE_FALSE(wtk->descending());
+  REQUIRE(wtk->emit() == TopKEmit::Delta);
+
+  auto topk = OperatorJson::read_op(R"({"type": "TopK", "id": "t", "k": 3, "score_index": 1, "emit": "snapshot"})");
+  REQUIRE(std::dynamic_pointer_cast<TopK>(topk)->emit() == TopKEmit::Snapshot);
+  REQUIRE(OperatorJson::write_op(topk).find("snapshot") != std::string::npos);
+}
@@ -193,6 +193,82 @@ Java_dev_rtbot_RtBotEngine_restoreProgramDataFromJson(JNIEnv* env, jclass, jstri
     }
 }
 
+JNIEXPORT jbyteArray JNICALL
+Java_dev_rtbot_RtBotEngine_serializeProgramBinary(JNIEnv* env, jclass, jstring id) {
+    try {
+        const auto snapshot = rtbot::serialize_program_binary(jstring_to_std(env, id));
+        jbyteArray out = env->NewByteArray(static_cast<jsize>(snapshot.size()));
+        if (out == nullptr) return nullptr;
+        env->SetByteArrayRegion(out, 0, static_cast<jsize>(snapshot.size()),
+                                reinterpret_cast<const jbyte*>(snapshot.data()));
+        return out;
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("serializeProgramBinary: ") + e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_rtbot_RtBotEngine_restoreProgramBinary(JNIEnv* env, jclass, jstring id, jbyteArray snapshot) {
+    try {
+        const jsize len = env->GetArrayLength(snapshot);
+        std::vector<uint8_t> bytes(static_cast<size_t>(len));
+        env->GetByteArrayRegion(snapshot, 0, len, reinterpret_cast<jbyte*>(bytes.data()));
+        rtbot::restore_program_binary(jstring_to_std(env, id), bytes);
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("restoreProgramBinary: ") + e.what());
+    }
+}
+
+static jbyteArray to_jbyte_array(JNIEnv* env, const std::vector<uint8_t>& bytes) {
+    jbyteArray out = env->NewByteArray(static_cast<jsize>(bytes.size()));
+    if (out == nullptr) return nullptr;
+    env->SetByteArrayRegion(out, 0, static_cast<jsize>(bytes.size()), reinterpret_cast<const jbyte*>(bytes.data()));
+    return out;
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_rtbot_RtBotEngine_checkpointProgram(JNIEnv* env, jclass, jstring id) {
+    try {
+        return to_jbyte_array(env, rtbot::checkpoint_program(jstring_to_std(env, id)));
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("checkpointProgram: ") + e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_dev_rtbot_RtBotEngine_checkpointProgramDelta(JNIEnv* env, jclass, jstring id) {
+    try {
+        return to_jbyte_array(env, rtbot::checkpoint_program_delta(jstring_to_std(env, id)));
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("checkpointProgramDelta: ") + e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_rtbot_RtBotEngine_applyProgramCheckpoint(JNIEnv* env, jclass, jstring id, jbyteArray checkpoint) {
+    try {
+        const jsize len = env->GetArrayLength(checkpoint);
+        std::vector<uint8_t> bytes(static_cast<size_t>(len));
+        env->GetByteArrayRegion(checkpoint, 0, len, reinterpret_cast<jbyte*>(bytes.data()));
+        rtbot::apply_program_checkpoint(jstring_to_std(env, id), bytes);
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("applyProgramCheckpoint: ") + e.what());
+    }
+}
+
+JNIEXPORT jlong JNICALL
+Java_dev_rtbot_RtBotEngine_getProgramCheckpointEpoch(JNIEnv* env, jclass, jstring id) {
+    try {
+        return static_cast<jlong>(rtbot::get_program_checkpoint_epoch(jstring_to_std(env, id)));
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("getProgramCheckpointEpoch: ") + e.what());
+        return 0;
+    }
+}
+
 JNIEXPORT jstring JNICALL
 Java_dev_rtbot_RtBotEngine_getProgramEntryOperatorId(JNIEnv* env, jclass, jstring id) {
     try {
@@ -213,4 +289,56 @@ Java_dev_rtbot_RtBotEngine_diagnoseProgram(JNIEnv* env, jclass, jstring programJ
     }
 }
 
+// ---------------------------------------------------------------------------
+// Profiling
+// ---------------------------------------------------------------------------
+
+JNIEXPORT jstring JNICALL
+Java_dev_rtbot_RtBotEngine_getProgramProfile(JNIEnv* env, jclass, jstring id) {
+    try {
+        return std_to_jstring(env, rtbot::get_program_profile(jstring_to_std(env, id)));
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("getProgramProfile: ") + e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_rtbot_RtBotEngine_setProgramProfiling(JNIEnv* env, jclass, jstring id, jboolean enabled) {
+    try {
+        rtbot::set_program_profiling(jstring_to_std(env, id), enabled == JNI_TRUE);
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("setProgramProfiling: ") + e.what());
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_rtbot_RtBotEngine_resetProgramProfile(JNIEnv* env, jclass, jstring id) {
+    try {
+        rtbot::reset_program_profile(jstring_to_std(env, id));
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("resetProgramProfile: ") + e.what());
+    }
+}
+
+JNIEXPORT jstring JNICALL
+Java_dev_rtbot_RtBotEngine_getProgramLatency(JNIEnv* env, jclass, jstring id) {
+    try {
+        return std_to_jstring(env, rtbot::get_program_latency(jstring_to_std(env, id)));
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("getProgramLatency: ") + e.what());
+        return nullptr;
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_dev_rtbot_RtBotEngine_setProgramLatency(JNIEnv* env, jclass, jstring id, jboolean receive,
+                                             jboolean operators) {
+    try {
+        rtbot::set_program_latency(jstring_to_std(env, id), receive == JNI_TRUE, operators == JNI_TRUE);
+    } catch (const std::exception& e) {
+        throw_runtime_exception(env, std::string("setProgramLatency: ") + e.what());
+    }
+}
+
 } // extern "C"
@@ -154,6 +154,59 @@ public final class RtBotEngine {
     public static native void restoreProgramDataFromJson(
             String programId, String jsonState);
 
+    /**
+     * Serialize the full program state to a compact binary snapshot. Smaller
+     * and faster than {@link #serializeProgramData}, but only readable by
+     * {@link #restoreProgramBinary} on the same program definition.
+     *
+     * @param programId program identifier
+     * @return raw snapshot bytes
+     */
+    public static native byte[] serializeProgramBinary(String programId);
+
+    /**
+     * Restore a program from a snapshot taken with {@link #serializeProgramBinary}.
+     *
+     * @param programId program identifier
+     * @param snapshot  raw snapshot bytes
+     */
+    public static native void restoreProgramBinary(String programId, byte[] snapshot);
+
+    /**
+     * Take a full checkpoint, starting a chain that later
+     * {@link #checkpointProgramDelta} calls extend.
+     *
+     * @param programId program identifier
+     * @return raw checkpoint bytes
+     */
+    public static native byte[] checkpointProgram(String programId);
+
+    /**
+     * Checkpoint only the state changed since the previous checkpoint: the
+     * touched operators, and within them the touched keyed sub-graphs and
+     * the window messages appended or evicted.
+     *
+     * @param programId program identifier
+     * @return raw checkpoint bytes
+     */
+    public static native byte[] checkpointProgramDelta(String programId);
+
+    /**
+     * Apply a checkpoint from {@link #checkpointProgram} or
+     * {@link #checkpointProgramDelta}. Apply the full checkpoint first, then
+     * the deltas in order.
+     *
+     * @param programId  program identifier
+     * @param checkpoint raw checkpoint bytes
+     */
+    public static native void applyProgramCheckpoint(String programId, byte[] checkpoint);
+
+    /**
+     * @param programId program identifier
+     * @return epoch of the last checkpoint taken or applied, 0 if none
+     */
+    public static native long getProgramCheckpointEpoch(String programId);
+
     // -----------------------------------------------------------------
     // Introspection
     // -----------------------------------------------------------------
@@ -174,6 +227,52 @@ public final class RtBotEngine {
      */
     public static native String diagnoseProgram(String programJson);
 
+    // -----------------------------------------------------------------
+    // Profiling
+    // -----------------------------------------------------------------
+
+    /**
+     * Get the per-operator profiling counters of a program.
+     *
+     * @param programId program identifier
+     * @return JSON string: {"enabled": bool, "operators": {id: counters}}
+     */
+    public static native String getProgramProfile(String programId);
+
+    /**
+     * Enable or disable per-operator profiling. Enabling resets the counters.
+     *
+     * @param programId program identifier
+     * @param enabled   whether counters are collected
+     */
+    public static native void setProgramProfiling(String programId, boolean enabled);
+
+    /**
+     * Zero the per-operator profiling counters of a program.
+     *
+     * @param programId program identifier
+     */
+    public static native void resetProgramProfile(String programId);
+
+    /**
+     * Get latency percentiles (p50/p90/p99/p999, in nanoseconds) of receive
+     * calls and, when enabled, of each operator's execute.
+     *
+     * @param programId program identifier
+     * @return JSON string: {"receive": summary|null, "operators": {id: summary}}
+     */
+    public static native String getProgramLatency(String programId);
+
+    /**
+     * Enable or disable latency histograms. Switching the operator
+     * histograms restarts the profiling counters.
+     *
+     * @param programId program identifier
+     * @param receive   record per-call receive latency
+     * @param operators record per-operator execute latency
+     */
+    public static native void setProgramLatency(String programId, boolean receive, boolean operators);
+
     // -----------------------------------------------------------------
     // Library loading
     // -----------------------------------------------------------------
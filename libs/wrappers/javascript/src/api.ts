@@ -118,6 +118,50 @@ export class RtBot {
     (await this.rtbot).restoreProgramDataFromJson(programId, jsonState);
   }
 
+  async serializeProgramBinary(programId: string): Promise<Uint8Array> {
+    return (await this.rtbot).serializeProgramBinary(programId);
+  }
+
+  async restoreProgramBinary(programId: string, snapshot: Uint8Array): Promise<void> {
+    (await this.rtbot).restoreProgramBinary(programId, snapshot);
+  }
+
+  async checkpointProgram(programId: string): Promise<Uint8Array> {
+    return (await this.rtbot).checkpointProgram(programId);
+  }
+
+  async checkpointProgramDelta(programId: string): Promise<Uint8Array> {
+    return (await this.rtbot).checkpointProgramDelta(programId);
+  }
+
+  async applyProgramCheckpoint(programId: string, checkpoint: Uint8Array): Promise<void> {
+    (await this.rtbot).applyProgramCheckpoint(programId, checkpoint);
+  }
+
+  async getProgramCheckpointEpoch(programId: string): Promise<number> {
+    return (await this.rtbot).getProgramCheckpointEpoch(programId);
+  }
+
+  async getProgramProfile(programId: string): Promise<any> {
+    return JSON.parse((await this.rtbot).getProgramProfile(programId));
+  }
+
+  async setProgramProfiling(programId: string, enabled: boolean): Promise<void> {
+    (await this.rtbot).setProgramProfiling(programId, enabled);
+  }
+
+  async resetProgramProfile(programId: string): Promise<void> {
+    (await this.rtbot).resetProgramProfile(programId);
+  }
+
+  async getProgramLatency(programId: string): Promise<any> {
+    return JSON.parse((await this.rtbot).getProgramLatency(programId));
+  }
+
+  async setProgramLatency(programId: string, receive: boolean, operators: boolean): Promise<void> {
+    (await this.rtbot).setProgramLatency(programId, receive, operators);
+  }
+
   async processDebug(
     programId: string,
     messages: { [portId: string]: RtBotInputMessage[] }
@@ -37,6 +37,55 @@ PYBIND11_MODULE(rtbotapi, m) {
         py::arg("program_id"));
   m.def("restore_program_data_from_json", &rtbot::restore_program_data_from_json,
         "Restore program state from JSON", py::arg("program_id"), py::arg("json_state"));
+  m.def(
+      "serialize_program_binary",
+      [](const std::string& program_id) {
+        const auto snapshot = rtbot::serialize_program_binary(program_id);
+        return py::bytes(reinterpret_cast<const char*>(snapshot.data()), snapshot.size());
+      },
+      "Serialize program state to a compact binary snapshot", py::arg("program_id"));
+  m.def(
+      "restore_program_binary",
+      [](const std::string& program_id, const py::bytes& snapshot) {
+        const std::string raw = snapshot;
+        rtbot::restore_program_binary(program_id, std::vector<uint8_t>(raw.begin(), raw.end()));
+      },
+      "Restore program state from a binary snapshot", py::arg("program_id"), py::arg("snapshot"));
+  m.def(
+      "checkpoint_program",
+      [](const std::string& program_id) {
+        const auto checkpoint = rtbot::checkpoint_program(program_id);
+        return py::bytes(reinterpret_cast<const char*>(checkpoint.data()), checkpoint.size());
+      },
+      "Full checkpoint that starts a delta chain", py::arg("program_id"));
+  m.def(
+      "checkpoint_program_delta",
+      [](const std::string& program_id) {
+        const auto checkpoint = rtbot::checkpoint_program_delta(program_id);
+        return py::bytes(reinterpret_cast<const char*>(checkpoint.data()), checkpoint.size());
+      },
+      "Checkpoint of the state changed since the previous checkpoint", py::arg("program_id"));
+  m.def(
+      "apply_program_checkpoint",
+      [](const std::string& program_id, const py::bytes& checkpoint) {
+        const std::string raw = checkpoint;
+        rtbot::apply_program_checkpoint(program_id, std::vector<uint8_t>(raw.begin(), raw.end()));
+      },
+      "Apply a full or delta checkpoint", py::arg("program_id"), py::arg("checkpoint"));
+  m.def("get_program_checkpoint_epoch", &rtbot::get_program_checkpoint_epoch,
+        "Epoch of the last checkpoint taken or applied", py::arg("program_id"));
+
+  // Profiling
+  m.def("get_program_profile", &rtbot::get_program_profile, "Per-operator profiling counters as JSON",
+        py::arg("program_id"));
+  m.def("set_program_profiling", &rtbot::set_program_profiling, "Enable or disable per-operator profiling",
+        py::arg("program_id"), py::arg("enabled"));
+  m.def("reset_program_profile", &rtbot::reset_program_profile, "Zero the per-operator profiling counters",
+        py::arg("program_id"));
+  m.def("get_program_latency", &rtbot::get_program_latency, "Receive and operator latency percentiles as JSON",
+        py::arg("program_id"));
+  m.def("set_program_latency", &rtbot::set_program_latency, "Enable or disable latency histograms",
+        py::arg("program_id"), py::arg("receive"), py::arg("operators"));
 
   // Pretty printing
   m.def("pretty_print", py::overload_cast<const std::string&>(&rtbot::pretty_print), "Pretty print JSON output",
@@ -15,6 +15,8 @@ class Run:
         self.debug = debug
         self.current_index = 0
         self.program_initialized = False
+        self.last_profile = None
+        self.last_latency = None
         
         if 'time' not in data.columns:
             raise ValueError("DataFrame must contain a 'time' column")
@@ -111,11 +113,64 @@ class Run:
         self.current_index = end_index
 
         if not self.debug and self.current_index >= len(self.data):
+            if self.program.profile or self.program.operatorLatency:
+                self.last_profile = json.loads(api.get_program_profile(self.program.id))
+            if self.program.receiveLatency or self.program.operatorLatency:
+                self.last_latency = json.loads(api.get_program_latency(self.program.id))
             api.delete_program(self.program.id)
             self.program_initialized = False
 
         return pd.DataFrame(df_data)
 
+    def profile(self) -> Optional[Dict]:
+        """Per-operator counters of a program created with profile=True.
+
+        Read live while the program exists, otherwise the snapshot taken
+        before exec() deleted it; None if the program was never profiled."""
+        if self.program_initialized:
+            return json.loads(api.get_program_profile(self.program.id))
+        return self.last_profile
+
+    def latency(self) -> Optional[Dict]:
+        """Latency percentiles (ns) of receive calls and operator executes,
+        for programs created with receiveLatency / operatorLatency."""
+        if self.program_initialized:
+            return json.loads(api.get_program_latency(self.program.id))
+        return self.last_latency
+
+    def snapshot(self) -> bytes:
+        """Binary state snapshot of the running program (between exec(next=...)
+        calls); pass it to restore() on a Run of the same program."""
+        if not self.program_initialized:
+            raise RuntimeError("Program is not running")
+        return api.serialize_program_binary(self.program.id)
+
+    def restore(self, snapshot: bytes) -> None:
+        if not self.program_initialized:
+            result = api.create_program(self.program.id, self.program.to_json())
+            if result != "":
+                raise Exception(result)
+            self.program_initialized = True
+        api.restore_program_binary(self.program.id, snapshot)
+
+    def checkpoint(self, delta: bool = False) -> bytes:
+        """Full checkpoint, or with delta=True only the state changed since
+        the previous one. Replay the chain with restore_checkpoints()."""
+        if not self.program_initialized:
+            raise RuntimeError("Program is not running")
+        if delta:
+            return api.checkpoint_program_delta(self.program.id)
+        return api.checkpoint_program(self.program.id)
+
+    def restore_checkpoints(self, chain: List[bytes]) -> None:
+        if not self.program_initialized:
+            result = api.create_program(self.program.id, self.program.to_json())
+            if result != "":
+                raise Exception(result)
+            self.program_initialized = True
+        for checkpoint in chain:
+            api.apply_program_checkpoint(self.program.id, checkpoint)
+
 class Program:
     def __init__(
         self,
@@ -130,6 +185,11 @@ class Program:
         date: Optional[str] = None,
         author: Optional[str] = None,
         license: Optional[str] = None,
+        queueCapacity: Optional[int] = None,
+        messageArena: Optional[bool] = None,
+        profile: Optional[bool] = None,
+        receiveLatency: Optional[bool] = None,
+        operatorLatency: Optional[bool] = None,
     ):
         self.title = title
         self.description = description
@@ -137,6 +197,11 @@ class Program:
         self.date = date
         self.author = author
         self.license = license
+        self.queueCapacity = queueCapacity
+        self.messageArena = messageArena
+        self.profile = profile
+        self.receiveLatency = receiveLatency
+        self.operatorLatency = operatorLatency
         self.operators = operators or []
         self.connections = connections or []
         self.entryOperator = entryOperator
@@ -160,6 +225,16 @@ class Program:
             if getattr(self, field):
                 obj[field] = getattr(self, field)
 
+        if self.queueCapacity is not None:
+            obj["queueCapacity"] = self.queueCapacity
+
+        if self.messageArena is not None:
+            obj["messageArena"] = self.messageArena
+
+        for field in ["profile", "receiveLatency", "operatorLatency"]:
+            if getattr(self, field) is not None:
+                obj[field] = getattr(self, field)
+
         return json.dumps(obj)
 
     def validate(self) -> Dict: